@@ -0,0 +1,18 @@
+#if GL_ES 
+precision mediump float;
+#endif
+
+in vec4 Color;
+
+layout(location = 0) out vec4 o_Albedo;
+layout(location = 1) out vec4 o_Normal;
+layout(location = 2) out vec4 o_Position;
+layout(location = 3) out vec4 o_RoughnessMetallic;
+
+void main()
+{
+    o_Albedo = Color;
+    o_Normal = vec4( 0.0 ); // no normal leaves the line unlit
+    o_Position = vec4( 0.0 );
+    o_RoughnessMetallic = vec4( 1.0 );
+}
\ No newline at end of file
@@ -0,0 +1,21 @@
+layout(location = 0) in vec3 a_Pos;
+layout(location = 1) in vec4 a_Color;
+
+uniform UbDebugData
+{
+    mat4x4 u_Projection;
+    mat4x4 u_View;
+};
+
+out gl_PerVertex
+{
+    vec4 gl_Position;
+};
+
+out vec4 Color;
+
+void main()
+{
+    Color = a_Color;
+    gl_Position = u_Projection * u_View * vec4( a_Pos, 1.0 );
+}
\ No newline at end of file
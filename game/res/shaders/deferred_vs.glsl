@@ -5,6 +5,11 @@ layout(location = 2) in vec3 a_Tangent;
 layout(location = 3) in vec4 a_Color;
 layout(location = 4) in vec2 a_TexCoord0;
 
+uniform UbDeferredData
+{
+    vec4 u_UVScale; // xy used, the gbuffer may only be partially filled
+};
+
 out gl_PerVertex
 {
     vec4 gl_Position;
@@ -14,6 +19,6 @@ out vec2 TexCoord;
 
 void main()
 {
-    TexCoord = a_TexCoord0;
+    TexCoord = a_TexCoord0 * u_UVScale.xy;
     gl_Position = vec4( a_Pos, 1.0 );;
 }
\ No newline at end of file
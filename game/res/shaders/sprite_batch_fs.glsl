@@ -0,0 +1,20 @@
+#if GL_ES 
+precision mediump float;
+#endif
+
+/// TODO: reflect to CPU so binding=0 doesn't need to be used
+#if GL_ES 
+uniform sampler2D u_Albedo;
+#else
+layout(binding = 0) uniform sampler2D u_Albedo;
+#endif
+
+in vec2 TexCoord;
+in vec4 Color;
+
+out vec4 FragColor;
+
+void main()
+{
+    FragColor = texture( u_Albedo, TexCoord ) * Color;
+}
\ No newline at end of file
@@ -0,0 +1,25 @@
+layout(location = 0) in vec2 a_Pos;
+layout(location = 1) in vec2 a_TexCoord0;
+layout(location = 2) in vec4 a_Color;
+
+uniform UbSpriteData
+{
+    vec4 u_ViewportSize; // xy used, sprite positions are in pixels
+};
+
+out gl_PerVertex
+{
+    vec4 gl_Position;
+};
+
+out vec2 TexCoord;
+out vec4 Color;
+
+void main()
+{
+    TexCoord = a_TexCoord0;
+    Color = a_Color;
+
+    vec2 ndc = a_Pos / u_ViewportSize.xy * 2.0 - 1.0;
+    gl_Position = vec4( ndc.x, -ndc.y, 0.0, 1.0 );
+}
\ No newline at end of file
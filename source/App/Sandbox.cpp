@@ -35,6 +35,9 @@ bool cSandbox::create( void )
 	engineDesc.windowWidth  = 1280;
 	engineDesc.windowHeight = 960;
 	engineDesc.showDebugConsole = true;
+
+	engineDesc.dynamicResolution.enabled = true;
+	engineDesc.dynamicResolution.targetFrameTime = 1.0 / 60.0;
 #endif
 
 	// create device context
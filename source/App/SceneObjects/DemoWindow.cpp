@@ -7,6 +7,9 @@
 #include <wv/Engine/ApplicationState.h>
 #include <wv/Scene/SceneRoot.h>
 #include <wv/Scene/Rigidbody.h>
+#include <wv/Graphics/OcclusionCuller.h>
+#include <wv/Graphics/DynamicResolution.h>
+#include <wv/Physics/PhysicsEngine.h>
 
 #ifdef WV_SUPPORT_IMGUI
 #include <imgui.h>
@@ -33,44 +36,55 @@ void cDemoWindow::spawnBalls( int _count )
 {
 	wv::cSceneRoot* sceneRoot = wv::cEngine::get()->m_pApplicationState->getCurrentScene();
 
+	std::vector<wv::iSceneObject*> objects;
+	objects.reserve( m_numToSpawn );
+
 	for ( int i = 0; i < m_numToSpawn; i++ )
 	{
 		wv::sPhysicsSphereDesc* sphereDesc = new wv::sPhysicsSphereDesc();
 		sphereDesc->kind = wv::WV_PHYSICS_DYANIMIC;
 		sphereDesc->radius = 0.5f;
+		sphereDesc->layer = m_spawnAsDebris ? wv::WV_PHYSICS_LAYER_DEBRIS : wv::WV_PHYSICS_LAYER_DEFAULT;
 
 		wv::cRigidbody* rb = new wv::cRigidbody( wv::cEngine::getUniqueUUID(), "ball", "res/meshes/sphere.dae", sphereDesc );
-		sceneRoot->addChild( rb );
+		objects.push_back( rb );
 		m_numSpawned++;
 	}
-	sceneRoot->onCreate();
-	sceneRoot->onLoad();
+	
+	sceneRoot->addChildren( objects, true );
 }
 
 void cDemoWindow::spawnCubes( int _count )
 {
 	wv::cSceneRoot* sceneRoot = wv::cEngine::get()->m_pApplicationState->getCurrentScene();
 
+	std::vector<wv::iSceneObject*> objects;
+	objects.reserve( m_numToSpawn );
+
 	for ( int i = 0; i < m_numToSpawn; i++ )
 	{
 		wv::sPhysicsBoxDesc* boxDesc = new wv::sPhysicsBoxDesc();
 		boxDesc->kind = wv::WV_PHYSICS_DYANIMIC;
 		boxDesc->halfExtent = { 0.5f,0.5f,0.5f };
+		boxDesc->layer = m_spawnAsDebris ? wv::WV_PHYSICS_LAYER_DEBRIS : wv::WV_PHYSICS_LAYER_DEFAULT;
 		
 		wv::cRigidbody* rb = new wv::cRigidbody( wv::cEngine::getUniqueUUID(), "cube", "res/meshes/cube.dae", boxDesc );
 		rb->m_transform.position.y = 1.0f;
-		sceneRoot->addChild( rb );
+		objects.push_back( rb );
 		
 		m_numSpawned++;
 	}
-	sceneRoot->onCreate();
-	sceneRoot->onLoad();
+	
+	sceneRoot->addChildren( objects, true );
 }
 
 void cDemoWindow::spawnBlock( int _halfX, int _halfY, int _halfZ )
 {
 	wv::cSceneRoot* sceneRoot = wv::cEngine::get()->m_pApplicationState->getCurrentScene();
 
+	std::vector<wv::iSceneObject*> objects;
+	objects.reserve( 8 * _halfX * _halfY * _halfZ );
+
 	for( int x = -_halfX; x < _halfX; x++ )
 	{
 		for( int y = -_halfY; y < _halfY; y++ )
@@ -80,23 +94,36 @@ void cDemoWindow::spawnBlock( int _halfX, int _halfY, int _halfZ )
 				wv::sPhysicsBoxDesc* boxDesc = new wv::sPhysicsBoxDesc();
 				boxDesc->kind = wv::WV_PHYSICS_DYANIMIC;
 				boxDesc->halfExtent = { 0.5f,0.5f,0.5f };
+				boxDesc->layer = m_spawnAsDebris ? wv::WV_PHYSICS_LAYER_DEBRIS : wv::WV_PHYSICS_LAYER_DEFAULT;
 				
 				wv::cRigidbody* rb = new wv::cRigidbody( wv::cEngine::getUniqueUUID(), "cube", "res/meshes/cube.dae", boxDesc );
 				rb->m_transform.position = { (float)x, (float)y + _halfY - 6.0f, (float)z };
-				sceneRoot->addChild( rb );
+				objects.push_back( rb );
 
 				m_numSpawned++;
 			}
 		}
 	}
 
-	sceneRoot->onCreate();
-	sceneRoot->onLoad();
+	sceneRoot->addChildren( objects, true );
 }
 
 void cDemoWindow::updateImpl( double _deltaTime )
 {
+	// the stats belong to the engine's scheduler, a headless world has neither
+	wv::cEngine* engine = wv::cEngine::get();
+	if ( !engine || !engine->m_pTaskScheduler )
+		return;
+
+	wv::cTaskScheduler* scheduler = engine->m_pTaskScheduler;
 
+	// sampled over half a second, per frame numbers are too noisy to read
+	m_workerStatsTimer += _deltaTime;
+	if ( m_workerStatsTimer < 0.5 )
+		return;
+
+	m_workerStatsTimer = 0.0;
+	m_workerStats = scheduler->sampleWorkerStats();
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////
@@ -119,9 +146,102 @@ void cDemoWindow::drawImpl( wv::iDeviceContext* _context, wv::iGraphicsDevice* _
 	if ( ImGui::Button( "Spawn Block" ) )
 		spawnBlock( 5, 5, 5 );
 
+	ImGui::SameLine();
+	ImGui::Checkbox( "As Debris", &m_spawnAsDebris );
+
 	ImGui::Text( "RigidBodies Spawned: %i", m_numSpawned );
 	ImGui::SameLine();
 
+	wv::cOcclusionCuller* culler = wv::cEngine::get()->m_pOcclusionCuller;
+	if ( culler )
+	{
+		wv::sOcclusionCullingStats stats = culler->getStats();
+		
+		ImGui::Checkbox( "Occlusion Culling", &culler->enabled );
+		ImGui::Text( "Tested: %u  Frustum Culled: %u  Occluded: %u", stats.numTested, stats.numFrustumCulled, stats.numOcclusionCulled );
+	}
+
+	wv::cDynamicResolution* dynamicResolution = wv::cEngine::get()->m_pDynamicResolution;
+	if ( dynamicResolution )
+	{
+		bool enabled = dynamicResolution->isEnabled();
+		if ( ImGui::Checkbox( "Dynamic Resolution", &enabled ) )
+			dynamicResolution->setEnabled( enabled );
+		
+		ImGui::Text( "Scale: %.2f  CPU: %.2fms  GPU: %.2fms", dynamicResolution->getScale(), dynamicResolution->getCPUTime() * 1000.0, dynamicResolution->getGPUTime() * 1000.0 );
+	}
+
+	wv::cJoltPhysicsEngine* physics = wv::cEngine::get()->m_pPhysicsEngine;
+	if ( physics )
+	{
+		bool async = physics->isAsyncStepping();
+		if ( ImGui::Checkbox( "Async Physics", &async ) )
+			physics->setAsyncStepping( async );
+
+		ImGui::SameLine();
+		ImGui::Text( "Interpolation: %.2f", physics->getInterpolationAlpha() );
+
+		if ( ImGui::Button( "Save Snapshot" ) )
+			physics->saveSnapshot();
+
+		ImGui::SameLine();
+		if ( ImGui::Button( "Restore Snapshot" ) )
+			physics->restoreLatestSnapshot();
+
+		ImGui::SameLine();
+		ImGui::Text( "Snapshots: %u  Step: %u", physics->getNumSnapshots(), physics->getStep() );
+	}
+
+	if ( physics && ImGui::CollapsingHeader( "Physics" ) )
+	{
+		const wv::sPhysicsStats& stats = physics->getStats();
+		ImGui::Text( "Steps: %u  Step: %.2fms  Update: %.2fms", stats.numSteps, stats.stepTime, stats.updateTime );
+		ImGui::Text( "Bodies: %u / %u  Active: %u", stats.numBodies, stats.maxBodies, stats.numActiveBodies );
+		ImGui::Text( "Contacts: %u ( %u new )  Max pairs: %u  Max constraints: %u", stats.numContacts, stats.numNewContacts, stats.maxBodyPairs, stats.maxContactConstraints );
+		ImGui::Text( "Touching pairs: %u  Islands: %u", stats.numBodyPairs, stats.numIslands );
+		ImGui::Text( "Temp Allocator: %.2f / %.2f MB", stats.tempAllocatorHighWater / ( 1024.0 * 1024.0 ), stats.tempAllocatorSize / ( 1024.0 * 1024.0 ) );
+
+		if ( stats.bodyPairCacheFull || stats.manifoldCacheFull || stats.contactConstraintsFull )
+			ImGui::TextColored( ImVec4( 1.0f, 0.3f, 0.3f, 1.0f ), "Collisions dropped, physics limits reached" );
+	}
+
+	if ( !m_workerStats.empty() && ImGui::CollapsingHeader( "Workers" ) )
+	{
+		for ( size_t i = 0; i < m_workerStats.size(); i++ )
+		{
+			const wv::sWorkerStats& stats = m_workerStats[ i ];
+			ImGui::Text( "Worker %2i: %5.1f%%  tasks: %llu  stolen: %llu", (int)i, stats.utilization * 100.0, (unsigned long long)stats.numTasks, (unsigned long long)stats.numStolen );
+		}
+	}
+
+	if ( ImGui::Button( "Run Math Benchmark" ) )
+	{
+		m_mathBenchmark = wv::Debug::RunMathBenchmark();
+		m_hasMathBenchmark = true;
+	}
+
+	if ( m_hasMathBenchmark )
+	{
+		const wv::Debug::sMathBenchmarkResult& b = m_mathBenchmark;
+		ImGui::Text( "%s, ns per call ( generic -> simd )", b.sse ? "SSE" : "Scalar fallback" );
+		ImGui::Text( "multiply:  %.2f -> %.2f  inverse:        %.2f -> %.2f", b.multiply.scalar,  b.multiply.simd,  b.inverse.scalar,        b.inverse.simd );
+		ImGui::Text( "transpose: %.2f -> %.2f  transformPoint: %.2f -> %.2f", b.transpose.scalar, b.transpose.simd, b.transformPoint.scalar, b.transformPoint.simd );
+	}
+
+	if ( ImGui::Button( "Run Loader Benchmark" ) )
+	{
+		m_loaderBenchmark = wv::Debug::RunLoaderBenchmark( wv::cEngine::get()->m_pTaskScheduler );
+		m_hasLoaderBenchmark = true;
+	}
+
+	if ( m_hasLoaderBenchmark )
+	{
+		const wv::Debug::sLoaderBenchmarkResult& b = m_loaderBenchmark;
+		ImGui::Text( "request to start, us: mean %.1f  max %.1f", b.idleMean, b.idleMax );
+		ImGui::Text( "%u loads at once: %.1f us", b.numLoads, b.burstTotal );
+		ImGui::Text( "100 ms polling, request to start, us: mean %.1f  max %.1f", b.pollIdleMean, b.pollIdleMax );
+	}
+
 	ImGui::End();
 #endif
 }
\ No newline at end of file
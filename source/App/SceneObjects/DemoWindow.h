@@ -3,8 +3,12 @@
 #include <wv/Scene/SceneObject.h>
 #include <wv/Reflection/Reflection.h>
 #include <wv/Engine/Engine.h>
+#include <wv/Debug/MathBenchmark.h>
+#include <wv/Debug/LoaderBenchmark.h>
+#include <wv/Thread/TaskScheduler.h>
 
 #include <string>
+#include <vector>
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
@@ -46,4 +50,16 @@ protected:
 
 	int m_numToSpawn = 10;
 	int m_numSpawned = 0;
+	
+	// debris does not collide with other debris
+	bool m_spawnAsDebris = false;
+
+	bool m_hasMathBenchmark = false;
+	wv::Debug::sMathBenchmarkResult m_mathBenchmark{};
+
+	bool m_hasLoaderBenchmark = false;
+	wv::Debug::sLoaderBenchmarkResult m_loaderBenchmark{};
+
+	double m_workerStatsTimer = 0.0;
+	std::vector<wv::sWorkerStats> m_workerStats;
 };
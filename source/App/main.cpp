@@ -4,7 +4,13 @@
 #include <wv/Defines.h>
 #include <wv/Debug/Trace.h>
 
+#include <wv/Engine/HeadlessServer.h>
+#include <wv/Engine/SimulationWorld.h>
+#include <wv/Memory/FileSystem.h>
+
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 #ifdef WV_PLATFORM_PSVITA
 #include <wv/Platform/PSVita.h>
@@ -14,10 +20,85 @@ WV_PSVITA_HEAPSIZE( 1 * 1024 * 1024 );
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
-int main()
+static void runServer( int _numWorlds )
+{
+	wv::cFileSystem* fileSystem = new wv::cFileSystem();
+	fileSystem->addDirectory( "res/" );
+	fileSystem->addDirectory( "res/meshes/" );
+
+	wv::sHeadlessServerDesc desc;
+	desc.pFileSystem = fileSystem;
+
+	wv::cHeadlessServer server{ desc };
+	for( int i = 0; i < _numWorlds; i++ )
+		server.createWorld( "res/scenes/server.json" );
+
+	wv::Debug::Print( "Running %i worlds\n", (int)server.getNumWorlds() );
+	server.run();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+static int runServerSmokeTest()
+{
+	wv::cFileSystem* fileSystem = new wv::cFileSystem();
+	fileSystem->addDirectory( "res/" );
+	fileSystem->addDirectory( "res/meshes/" );
+
+	// a fixed worker count, so the worlds are stepped in parallel however many cores there are
+	wv::sHeadlessServerDesc desc;
+	desc.pFileSystem = fileSystem;
+	desc.numWorkers  = 3;
+
+	wv::cHeadlessServer server{ desc };
+	for( int i = 0; i < 3; i++ )
+	{
+		if( server.createWorld( "res/scenes/server.json" ) )
+			continue;
+
+		wv::Debug::Print( wv::Debug::WV_PRINT_ERROR, "Smoke test failed to create world %i\n", i );
+		return 1;
+	}
+
+	const int numSteps = 120;
+	for( int i = 0; i < numSteps; i++ )
+		server.step( 1.0 / 60.0 );
+
+	// tear one world down mid run, the others keep stepping
+	server.destroyWorld( server.getWorld( 1 ) );
+	for( int i = 0; i < numSteps; i++ )
+		server.step( 1.0 / 60.0 );
+
+	for( size_t i = 0; i < server.getNumWorlds(); i++ )
+	{
+		if( server.getWorld( i )->getNumSteps() == 2 * numSteps )
+			continue;
+
+		wv::Debug::Print( wv::Debug::WV_PRINT_ERROR, "Smoke test world %i stepped %i times\n", (int)i, (int)server.getWorld( i )->getNumSteps() );
+		return 1;
+	}
+
+	wv::Debug::Print( "Smoke test stepped %i worlds\n", (int)server.getNumWorlds() );
+	return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+int main( int _argc, char* _argv[] )
 {
 	wv::Trace::sTrace::printEnabled = false;
 
+	// --server [worlds], simulates without a window
+	if( _argc > 1 && strcmp( _argv[ 1 ], "--server" ) == 0 )
+	{
+		runServer( _argc > 2 ? atoi( _argv[ 2 ] ) : 1 );
+		return 0;
+	}
+
+	// --server-smoke, steps a few worlds and tears them down, non zero on failure
+	if( _argc > 1 && strcmp( _argv[ 1 ], "--server-smoke" ) == 0 )
+		return runServerSmokeTest();
+
 	wv::Debug::Print( wv::Debug::WV_PRINT_INFO, "Initializing Application Configuration\n" );
 
 	cSandbox sandbox{};
@@ -25,5 +25,8 @@ target( PROJECT_NAME )
     add_files( "**.cpp" )
     add_includedirs( "../Engine", "./" )
 
+    -- xmake test, steps a few headless worlds from game/res and tears them down
+    add_tests( "server_smoke", { runargs = "--server-smoke", rundir = "$(projectdir)/game" } )
+
     target_platform()
 target_end()
\ No newline at end of file
@@ -36,6 +36,7 @@ namespace wv
 		cMatrix4x4f getViewMatrix( void );
 
 		Transformf& getTransform( void ) { return m_transform; }
+		CameraType  getType     ( void ) { return m_type; }
 		cVector3f getViewDirection();
 
 ///////////////////////////////////////////////////////////////////////////////////////
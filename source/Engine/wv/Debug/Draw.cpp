@@ -1,12 +1,97 @@
 #include "Draw.h"
 
 #include <wv/Device/GraphicsDevice.h>
-#include <wv/Material/Material.h>
-#include <wv/Primitive/Mesh.h>
-#include <wv/Memory/ModelParser.h>
+#include <wv/Primitive/Primitive.h>
+#include <wv/Shader/ShaderProgram.h>
+#include <wv/Graphics/GPUBuffer.h>
+#include <wv/Camera/Camera.h>
+#include <wv/Engine/Engine.h>
 
 #include <wv/Resource/ResourceRegistry.h>
 
+#include <math.h>
+#include <mutex>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#define WV_DEBUG_DRAW_CIRCLE_SEGMENTS 16
+
+// initial capacity of the line buffer, it grows as needed
+#define WV_DEBUG_DRAW_INITIAL_VERTICES 4096
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+struct sDebugVertex
+{
+	wv::cVector3f position;
+	uint8_t color[ 4 ];
+};
+
+struct sDebugUniforms
+{
+	wv::cMatrix4x4f projection;
+	wv::cMatrix4x4f view;
+};
+
+static wv::Primitive*        s_pLinePrimitive = nullptr;
+static wv::cProgramPipeline* s_pLinePipeline  = nullptr;
+
+static std::mutex s_mutex;
+static std::vector<sDebugVertex> s_vertices;
+static std::vector<sDebugVertex> s_drawVertices;
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+static sDebugVertex makeVertex( const wv::cVector3f& _position, const wv::cColor& _color )
+{
+	return sDebugVertex{ _position, { _color.r, _color.g, _color.b, _color.a } };
+}
+
+static void submitVertices( const sDebugVertex* _vertices, size_t _count )
+{
+	std::scoped_lock lock{ s_mutex };
+	s_vertices.insert( s_vertices.end(), _vertices, _vertices + _count );
+}
+
+/// arc around _center in the plane spanned by _u and _v, from angle 0 to _arc
+static int addArc( sDebugVertex* _out, const wv::cVector3f& _center, const wv::cVector3f& _u, const wv::cVector3f& _v, float _radius, float _arc, int _segments, const wv::cColor& _color )
+{
+	int count = 0;
+	wv::cVector3f prev = _center + _u * _radius;
+	
+	for ( int i = 1; i <= _segments; i++ )
+	{
+		float angle = _arc * (float)i / (float)_segments;
+		wv::cVector3f next = _center + ( _u * cosf( angle ) + _v * sinf( angle ) ) * _radius;
+
+		_out[ count++ ] = makeVertex( prev, _color );
+		_out[ count++ ] = makeVertex( next, _color );
+		prev = next;
+	}
+
+	return count;
+}
+
+static void addBoxCorners( const wv::cVector3f* _corners, const wv::cColor& _color )
+{
+	// corner i has bit 0 set for +x, bit 1 for +y and bit 2 for +z
+	static const int edges[ 12 ][ 2 ] = {
+		{ 0, 1 }, { 2, 3 }, { 4, 5 }, { 6, 7 }, // x
+		{ 0, 2 }, { 1, 3 }, { 4, 6 }, { 5, 7 }, // y
+		{ 0, 4 }, { 1, 5 }, { 2, 6 }, { 3, 7 }  // z
+	};
+
+	sDebugVertex vertices[ 24 ];
+	for ( int i = 0; i < 12; i++ )
+	{
+		vertices[ i * 2 + 0 ] = makeVertex( _corners[ edges[ i ][ 0 ] ], _color );
+		vertices[ i * 2 + 1 ] = makeVertex( _corners[ edges[ i ][ 1 ] ], _color );
+	}
+
+	submitVertices( vertices, 24 );
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////
 
 void wv::Debug::Draw::Internal::initDebugDraw( iGraphicsDevice* _pGraphicsDevice, cResourceRegistry* _pResourceRegistry )
@@ -14,59 +99,182 @@ void wv::Debug::Draw::Internal::initDebugDraw( iGraphicsDevice* _pGraphicsDevice
 #ifdef WV_PLATFORM_PSVITA
 	return;
 #endif
-	wv::Parser parser;
+	s_pLinePipeline = new cProgramPipeline( "debug_line" );
+	s_pLinePipeline->load( cEngine::get()->m_pFileSystem, _pGraphicsDevice );
 
-	DEBUG_MATERIAL = _pResourceRegistry->load<cMaterial>( "DebugMaterial.wmat" );
+	wv::sVertexAttribute elements[] = {
+		{ "a_Pos",   3, wv::WV_FLOAT,         false, sizeof( float ) * 3 }, // vec3f pos
+		{ "a_Color", 4, wv::WV_UNSIGNED_BYTE, true,  sizeof( uint8_t ) * 4 } // rgba8 col
+	};
 
-	CUBE_MESH = parser.load( "res/meshes/cube.dae", _pResourceRegistry );
-	SPHERE_MESH = parser.load( "res/meshes/cube.dae", _pResourceRegistry );
+	wv::sVertexLayout layout;
+	layout.elements = elements;
+	layout.numElements = 2;
 
+	PrimitiveDesc desc;
+	desc.type = WV_PRIMITIVE_TYPE_DYNAMIC;
+	desc.topology = WV_PRIMITIVE_TOPOLOGY_LINES;
+	desc.layout = layout;
+	desc.sizeVertices = WV_DEBUG_DRAW_INITIAL_VERTICES * sizeof( sDebugVertex );
+
+	s_pLinePrimitive = _pGraphicsDevice->createPrimitive( &desc );
 }
 
+///////////////////////////////////////////////////////////////////////////////////////
+
 void wv::Debug::Draw::Internal::deinitDebugDraw( iGraphicsDevice* _pGraphicsDevice )
 {
-	if( CUBE_MESH )
-		_pGraphicsDevice->destroyMesh( &CUBE_MESH->children[ 0 ]->meshes[ 0 ] );
-	
-	if( SPHERE_MESH )
-		_pGraphicsDevice->destroyMesh( &SPHERE_MESH->children[ 0 ]->meshes[ 0 ] );
+	if ( s_pLinePrimitive )
+	{
+		_pGraphicsDevice->destroyPrimitive( s_pLinePrimitive );
+		s_pLinePrimitive = nullptr;
+	}
 
-	if( DEBUG_MATERIAL )
+	if ( s_pLinePipeline )
 	{
-		DEBUG_MATERIAL->unload( nullptr, _pGraphicsDevice ); /// TODO: fix
-		delete DEBUG_MATERIAL;
+		s_pLinePipeline->unload( nullptr, _pGraphicsDevice );
+		delete s_pLinePipeline;
+		s_pLinePipeline = nullptr;
 	}
+
+	std::scoped_lock lock{ s_mutex };
+	s_vertices.clear();
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
 void wv::Debug::Draw::Internal::drawDebug( iGraphicsDevice* _pGraphicsDevice )
 {
-	if( SPHERE_MESH )
 	{
-		for( int i = 0; i < spheres.size(); i++ )
-		{
-			SPHERE_MESH->transform.position = spheres[ i ].position;
-			SPHERE_MESH->transform.scale = wv::cVector3f{ spheres[ i ].radius };
-			SPHERE_MESH->transform.update( nullptr );
-			_pGraphicsDevice->drawNode( SPHERE_MESH );
-		}
+		std::scoped_lock lock{ s_mutex };
+		s_drawVertices.swap( s_vertices );
+		s_vertices.clear();
 	}
 
-	cubes.clear();
-	spheres.clear();
+	if ( s_drawVertices.empty() || !s_pLinePrimitive || !s_pLinePipeline || !s_pLinePipeline->m_pPipeline )
+		return;
+
+	iCamera* camera = cEngine::get()->currentCamera;
+
+	sDebugUniforms uniforms;
+	uniforms.projection = camera->getProjectionMatrix();
+	uniforms.view       = camera->getViewMatrix();
+
+	cGPUBuffer* uniformBlock = s_pLinePipeline->getShaderBuffer( "UbDebugData" );
+	if ( uniformBlock )
+		uniformBlock->buffer( &uniforms );
+
+	_pGraphicsDevice->updatePrimitive( s_pLinePrimitive, s_drawVertices.data(), (uint32_t)( s_drawVertices.size() * sizeof( sDebugVertex ) ) );
+
+	s_pLinePipeline->use( _pGraphicsDevice );
+	_pGraphicsDevice->drawPrimitive( s_pLinePrimitive, 0 );
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::Debug::Draw::AddLine( const cVector3f& _from, const cVector3f& _to, const cColor& _color )
+{
+	sDebugVertex vertices[ 2 ] = { makeVertex( _from, _color ), makeVertex( _to, _color ) };
+	submitVertices( vertices, 2 );
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::Debug::Draw::AddBox( const cVector3f& _center, const cVector3f& _halfExtents, const cColor& _color )
+{
+	cVector3f corners[ 8 ];
+	for ( int i = 0; i < 8; i++ )
+	{
+		corners[ i ] = {
+			_center.x + ( i & 1 ? _halfExtents.x : -_halfExtents.x ),
+			_center.y + ( i & 2 ? _halfExtents.y : -_halfExtents.y ),
+			_center.z + ( i & 4 ? _halfExtents.z : -_halfExtents.z )
+		};
+	}
+
+	addBoxCorners( corners, _color );
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::Debug::Draw::AddBox( const cMatrix4x4f& _transform, const cVector3f& _halfExtents, const cColor& _color )
+{
+	cVector3f corners[ 8 ];
+	for ( int i = 0; i < 8; i++ )
+	{
+		cVector3f local{
+			i & 1 ? _halfExtents.x : -_halfExtents.x,
+			i & 2 ? _halfExtents.y : -_halfExtents.y,
+			i & 4 ? _halfExtents.z : -_halfExtents.z
+		};
+		corners[ i ] = wv::Matrix::transformPoint( _transform, local );
+	}
+
+	addBoxCorners( corners, _color );
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
-void wv::Debug::Draw::AddSphere( cVector3f _position, float _radius )
+void wv::Debug::Draw::AddSphere( cVector3f _position, float _radius, const cColor& _color )
 {
-	Internal::spheres.push_back( { _position, _radius } );
+	const float tau = 6.28318530718f;
+	const cVector3f x{ 1.0f, 0.0f, 0.0f };
+	const cVector3f y{ 0.0f, 1.0f, 0.0f };
+	const cVector3f z{ 0.0f, 0.0f, 1.0f };
+
+	sDebugVertex vertices[ WV_DEBUG_DRAW_CIRCLE_SEGMENTS * 2 * 3 ];
+	int count = 0;
+	count += addArc( &vertices[ count ], _position, x, y, _radius, tau, WV_DEBUG_DRAW_CIRCLE_SEGMENTS, _color );
+	count += addArc( &vertices[ count ], _position, y, z, _radius, tau, WV_DEBUG_DRAW_CIRCLE_SEGMENTS, _color );
+	count += addArc( &vertices[ count ], _position, z, x, _radius, tau, WV_DEBUG_DRAW_CIRCLE_SEGMENTS, _color );
+
+	submitVertices( vertices, count );
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::Debug::Draw::AddCapsule( const cVector3f& _a, const cVector3f& _b, float _radius, const cColor& _color )
+{
+	const float pi = 3.14159265359f;
+	const int halfSegments = WV_DEBUG_DRAW_CIRCLE_SEGMENTS / 2;
+
+	cVector3f axis = _b - _a;
+	float length = axis.length();
+	axis = length > 0.0f ? axis / length : cVector3f{ 0.0f, 1.0f, 0.0f };
+
+	// any two vectors perpendicular to the axis
+	cVector3f helper = fabsf( axis.y ) < 0.99f ? cVector3f{ 0.0f, 1.0f, 0.0f } : cVector3f{ 1.0f, 0.0f, 0.0f };
+	cVector3f u = axis.cross( helper ).normalized();
+	cVector3f v = axis.cross( u );
+
+	sDebugVertex vertices[ WV_DEBUG_DRAW_CIRCLE_SEGMENTS * 2 * 2 + halfSegments * 2 * 4 + 8 ];
+	int count = 0;
+
+	// rings at both ends
+	count += addArc( &vertices[ count ], _a, u, v, _radius, pi * 2.0f, WV_DEBUG_DRAW_CIRCLE_SEGMENTS, _color );
+	count += addArc( &vertices[ count ], _b, u, v, _radius, pi * 2.0f, WV_DEBUG_DRAW_CIRCLE_SEGMENTS, _color );
+
+	// hemisphere arcs, bulging away from the other end
+	count += addArc( &vertices[ count ], _b, u, axis,  _radius, pi, halfSegments, _color );
+	count += addArc( &vertices[ count ], _b, v, axis,  _radius, pi, halfSegments, _color );
+	count += addArc( &vertices[ count ], _a, u, -axis, _radius, pi, halfSegments, _color );
+	count += addArc( &vertices[ count ], _a, v, -axis, _radius, pi, halfSegments, _color );
+
+	// sides
+	const cVector3f sides[ 4 ] = { u * _radius, u * -_radius, v * _radius, v * -_radius };
+	for ( int i = 0; i < 4; i++ )
+	{
+		vertices[ count++ ] = makeVertex( _a + sides[ i ], _color );
+		vertices[ count++ ] = makeVertex( _b + sides[ i ], _color );
+	}
+
+	submitVertices( vertices, count );
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
-void wv::Debug::Draw::AddCube( Transformf _transform )
+void wv::Debug::Draw::AddCube( Transformf _transform, const cColor& _color )
 {
-	Internal::cubes.push_back( _transform );
+	_transform.update( nullptr );
+	AddBox( _transform.getMatrix(), cVector3f{ 0.5f }, _color );
 }
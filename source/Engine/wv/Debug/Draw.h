@@ -2,8 +2,8 @@
 
 #include <wv/Math/Transform.h>
 #include <wv/Math/Vector3.h>
-
-#include <vector>
+#include <wv/Math/Matrix.h>
+#include <wv/Misc/Color.h>
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
@@ -12,8 +12,6 @@ namespace wv
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
-	struct sMeshNode;
-	class cMaterial;
 	class iGraphicsDevice;
 	class cResourceRegistry;
 
@@ -21,6 +19,10 @@ namespace wv
 
 	namespace Debug 
 	{
+		/*
+		 * shapes are accumulated as lines and drawn in a single call at the end of 
+		 * the scene pass. Add* may be called from any thread
+		 */
 		namespace Draw
 		{
 
@@ -28,15 +30,6 @@ namespace wv
 
 			namespace Internal
 			{
-				struct Sphere { cVector3f position; float radius; }; /// TODO: move to wv/Math or similar
-
-				static sMeshNode* SPHERE_MESH;
-				static sMeshNode* CUBE_MESH;
-				static cMaterial* DEBUG_MATERIAL;
-
-				static std::vector<Sphere> spheres;
-				static std::vector<Transformf> cubes;
-
 				void initDebugDraw( iGraphicsDevice* _pGraphicsDevice, cResourceRegistry* _pResourceRegistry );
 				void deinitDebugDraw( iGraphicsDevice* _pGraphicsDevice );
 				void drawDebug( iGraphicsDevice* _pGraphicsDevice );
@@ -44,8 +37,18 @@ namespace wv
 
 	///////////////////////////////////////////////////////////////////////////////////////
 
-			void AddSphere( cVector3f _position, float _radius = 1.0f );
-			void AddCube( Transformf _transform );
+			void AddLine( const cVector3f& _from, const cVector3f& _to, const cColor& _color = Color::Magenta );
+			
+			void AddBox( const cVector3f& _center, const cVector3f& _halfExtents, const cColor& _color = Color::Magenta );
+			void AddBox( const cMatrix4x4f& _transform, const cVector3f& _halfExtents, const cColor& _color = Color::Magenta );
+			
+			void AddSphere( cVector3f _position, float _radius = 1.0f, const cColor& _color = Color::Magenta );
+			void AddCapsule( const cVector3f& _a, const cVector3f& _b, float _radius, const cColor& _color = Color::Magenta );
+
+			/// <summary>
+			/// Unit cube, same as res/meshes/cube.dae
+			/// </summary>
+			void AddCube( Transformf _transform, const cColor& _color = Color::Magenta );
 
 		}
 	}
@@ -0,0 +1,184 @@
+#include "LoaderBenchmark.h"
+
+#include <wv/Resource/Resource.h>
+#include <wv/Resource/cResourceLoader.h>
+#include <wv/Thread/TaskScheduler.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+// long enough for every worker to run dry and go to sleep
+static const std::chrono::milliseconds IDLE_WAIT{ 2 };
+
+// what the loader workers used to sleep for when they found the queue empty
+static const std::chrono::milliseconds POLL_INTERVAL{ 100 };
+
+// each one waits up to POLL_INTERVAL, so keep it short
+static const uint32_t POLL_LOADS = 10;
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+class cBenchmarkResource : public wv::iResource
+{
+public:
+	cBenchmarkResource( const std::string& _name ) :
+		iResource( _name, "" )
+	{ }
+
+	void load( wv::cFileSystem* _pFileSystem, wv::iGraphicsDevice* _pGraphicsDevice ) override
+	{
+		startTime = std::chrono::steady_clock::now();
+		started = true;
+		setComplete( true );
+	}
+
+	void unload( wv::cFileSystem* _pFileSystem, wv::iGraphicsDevice* _pGraphicsDevice ) override { }
+
+	std::chrono::steady_clock::time_point startTime;
+	std::atomic<bool> started{ false };
+};
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+// the old loader worker loop, a locked queue polled by one thread
+struct sPollingLoader
+{
+	void run()
+	{
+		while ( alive.load() )
+		{
+			cBenchmarkResource* resource = nullptr;
+
+			mutex.lock();
+			if ( !queue.empty() )
+			{
+				resource = queue.front();
+				queue.pop();
+			}
+			mutex.unlock();
+
+			if ( !resource )
+			{
+				std::this_thread::sleep_for( POLL_INTERVAL );
+				continue;
+			}
+
+			resource->load( nullptr, nullptr );
+		}
+	}
+
+	void addLoad( cBenchmarkResource* _resource )
+	{
+		std::scoped_lock lock{ mutex };
+		queue.push( _resource );
+	}
+
+	std::mutex mutex;
+	std::queue<cBenchmarkResource*> queue;
+	std::atomic<bool> alive{ true };
+};
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+static void measurePollingBaseline( wv::Debug::sLoaderBenchmarkResult& _result )
+{
+	std::vector<cBenchmarkResource*> resources;
+	for ( uint32_t i = 0; i < POLL_LOADS; i++ )
+		resources.push_back( new cBenchmarkResource( "pollBenchmark" + std::to_string( i ) ) );
+
+	sPollingLoader loader;
+	std::thread worker{ &sPollingLoader::run, &loader };
+
+	double total = 0.0;
+	for ( uint32_t i = 0; i < POLL_LOADS; i++ )
+	{
+		cBenchmarkResource* resource = resources[ i ];
+
+		// spread the requests over the poll interval, the worker just went to sleep
+		std::this_thread::sleep_for( POLL_INTERVAL * i / POLL_LOADS );
+
+		const auto request = std::chrono::steady_clock::now();
+		loader.addLoad( resource );
+
+		while ( !resource->started.load() )
+			std::this_thread::yield();
+
+		const double latency = std::chrono::duration<double, std::micro>( resource->startTime - request ).count();
+		total += latency;
+		if ( latency > _result.pollIdleMax )
+			_result.pollIdleMax = latency;
+	}
+
+	_result.pollLoads    = POLL_LOADS;
+	_result.pollIdleMean = total / (double)POLL_LOADS;
+
+	loader.alive = false;
+	worker.join();
+
+	for ( cBenchmarkResource* resource : resources )
+		delete resource;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+wv::Debug::sLoaderBenchmarkResult wv::Debug::RunLoaderBenchmark( cTaskScheduler* _pTaskScheduler, uint32_t _numLoads )
+{
+	sLoaderBenchmarkResult result{};
+	result.numLoads = _numLoads;
+
+	if ( _numLoads == 0 )
+		return result;
+
+	std::vector<cBenchmarkResource*> resources;
+	for ( uint32_t i = 0; i < _numLoads * 2; i++ )
+		resources.push_back( new cBenchmarkResource( "benchmark" + std::to_string( i ) ) );
+
+	{
+		// the resources only record when they were started, nothing touches the file system
+		cResourceLoader loader{ nullptr, nullptr, _pTaskScheduler };
+
+		double total = 0.0;
+		for ( uint32_t i = 0; i < _numLoads; i++ )
+		{
+			cBenchmarkResource* resource = resources[ i ];
+			std::this_thread::sleep_for( IDLE_WAIT );
+
+			const auto request = std::chrono::steady_clock::now();
+			loader.addLoad( resource );
+
+			while ( !resource->started.load() )
+				std::this_thread::yield();
+
+			const double latency = std::chrono::duration<double, std::micro>( resource->startTime - request ).count();
+			total += latency;
+			if ( latency > result.idleMax )
+				result.idleMax = latency;
+		}
+		result.idleMean = total / (double)_numLoads;
+
+		std::this_thread::sleep_for( IDLE_WAIT );
+
+		const auto request = std::chrono::steady_clock::now();
+		for ( uint32_t i = _numLoads; i < _numLoads * 2; i++ )
+			loader.addLoad( resources[ i ] );
+
+		while ( loader.isWorking() )
+			std::this_thread::yield();
+
+		result.burstTotal = std::chrono::duration<double, std::micro>( std::chrono::steady_clock::now() - request ).count();
+	}
+
+	for ( cBenchmarkResource* resource : resources )
+		delete resource;
+
+	measurePollingBaseline( result );
+
+	return result;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stdint.h>
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+namespace wv
+{
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	class cTaskScheduler;
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	namespace Debug
+	{
+
+	///////////////////////////////////////////////////////////////////////////////////////
+
+		struct sLoaderBenchmarkResult
+		{
+			uint32_t numLoads = 0;
+
+			// microseconds from addLoad until the load starts, with every worker asleep
+			double idleMean = 0.0;
+			double idleMax  = 0.0;
+
+			// microseconds until the last of numLoads requested at once has finished
+			double burstTotal = 0.0;
+
+			// idleMean and idleMax for a simulated worker that sleeps 100 ms whenever the
+			// queue is empty, the way the loader used to, over pollLoads requests
+			uint32_t pollLoads = 0;
+			double pollIdleMean = 0.0;
+			double pollIdleMax  = 0.0;
+		};
+
+	///////////////////////////////////////////////////////////////////////////////////////
+
+		/// <summary>
+		/// Times how long empty resource loads wait before a worker picks them up, and the
+		/// same for the old polling loader as a baseline. Takes about a second because of
+		/// the baseline. Blocks the calling thread, which must not be one of the scheduler's workers
+		/// </summary>
+		sLoaderBenchmarkResult RunLoaderBenchmark( cTaskScheduler* _pTaskScheduler, uint32_t _numLoads = 100 );
+
+	}
+
+}
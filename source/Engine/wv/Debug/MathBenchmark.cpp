@@ -0,0 +1,93 @@
+#include "MathBenchmark.h"
+
+#include <wv/Math/Matrix.h>
+#include <wv/Debug/Print.h>
+
+#include <chrono>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+static const uint32_t NUM_MATRICES = 64; // small enough to stay in cache, the kernels are what is measured
+
+static volatile float g_sink = 0.0f;
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+template<typename F>
+static double timeLoop( uint32_t _iterations, F _func )
+{
+	auto start = std::chrono::high_resolution_clock::now();
+
+	for ( uint32_t i = 0; i < _iterations; i++ )
+		_func( i % NUM_MATRICES );
+
+	auto end = std::chrono::high_resolution_clock::now();
+	return std::chrono::duration<double, std::nano>( end - start ).count() / (double)_iterations;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+wv::Debug::sMathBenchmarkResult wv::Debug::RunMathBenchmark( uint32_t _iterations )
+{
+	sMathBenchmarkResult result{};
+	result.iterations = _iterations;
+#ifdef WV_MATH_SSE
+	result.sse = true;
+#endif
+
+	if ( _iterations == 0 )
+		return result;
+
+	// well conditioned affine matrices, same kind the engine inverts every frame
+	std::vector<cMatrix4x4f> matrices( NUM_MATRICES );
+	std::vector<cVector3f>   points  ( NUM_MATRICES );
+	for ( uint32_t i = 0; i < NUM_MATRICES; i++ )
+	{
+		float f = (float)i;
+		cMatrix4x4f m{ 1.0f };
+		m = Matrix::translate( m, cVector3f{ f, -f * 0.5f, f * 2.0f } );
+		m = Matrix::rotateY( m, f * 0.1f );
+		m = Matrix::rotateX( m, f * 0.05f );
+		m = Matrix::scale( m, cVector3f{ 1.0f + f * 0.01f } );
+		
+		matrices[ i ] = m;
+		points[ i ]   = cVector3f{ f, f * 0.25f, -f };
+	}
+
+	// results are written out and summed at the end so none of the work can be dropped
+	std::vector<cMatrix4x4f> results( NUM_MATRICES );
+	std::vector<cVector3f>   resultPoints( NUM_MATRICES );
+
+	auto next = []( uint32_t _i ) { return ( _i + 1 ) % NUM_MATRICES; };
+
+	result.multiply.scalar = timeLoop( _iterations, [&]( uint32_t _i ) { results[ _i ] = Matrix::multiply<float, 4, 4, 4>( matrices[ _i ], matrices[ next( _i ) ] ); } );
+	result.multiply.simd   = timeLoop( _iterations, [&]( uint32_t _i ) { results[ _i ] = Matrix::multiply( matrices[ _i ], matrices[ next( _i ) ] ); } );
+	
+	result.inverse.scalar = timeLoop( _iterations, [&]( uint32_t _i ) { results[ _i ] = Matrix::inverse<float>( matrices[ _i ] ); } );
+	result.inverse.simd   = timeLoop( _iterations, [&]( uint32_t _i ) { results[ _i ] = Matrix::inverse( matrices[ _i ] ); } );
+
+	result.transpose.scalar = timeLoop( _iterations, [&]( uint32_t _i ) { results[ _i ] = Matrix::transpose<float, 4, 4>( matrices[ _i ] ); } );
+	result.transpose.simd   = timeLoop( _iterations, [&]( uint32_t _i ) { results[ _i ] = Matrix::transpose( matrices[ _i ] ); } );
+
+	result.transformPoint.scalar = timeLoop( _iterations, [&]( uint32_t _i ) { resultPoints[ _i ] = Matrix::transformPoint<float>( matrices[ _i ], points[ _i ] ); } );
+	result.transformPoint.simd   = timeLoop( _iterations, [&]( uint32_t _i ) { resultPoints[ _i ] = Matrix::transformPoint( matrices[ _i ], points[ _i ] ); } );
+
+	float sum = 0.0f;
+	for ( uint32_t i = 0; i < NUM_MATRICES; i++ )
+	{
+		for ( int r = 0; r < 4; r++ )
+			for ( int c = 0; c < 4; c++ )
+				sum += results[ i ].m[ r ][ c ];
+		sum += resultPoints[ i ].x + resultPoints[ i ].y + resultPoints[ i ].z;
+	}
+	g_sink = sum;
+
+	Debug::Print( Debug::WV_PRINT_INFO, "Math benchmark ( %u iterations, %s )\n", _iterations, result.sse ? "SSE" : "scalar fallback" );
+	Debug::Print( Debug::WV_PRINT_INFO, "  multiply       %6.2fns -> %6.2fns\n", result.multiply.scalar,       result.multiply.simd );
+	Debug::Print( Debug::WV_PRINT_INFO, "  inverse        %6.2fns -> %6.2fns\n", result.inverse.scalar,        result.inverse.simd );
+	Debug::Print( Debug::WV_PRINT_INFO, "  transpose      %6.2fns -> %6.2fns\n", result.transpose.scalar,      result.transpose.simd );
+	Debug::Print( Debug::WV_PRINT_INFO, "  transformPoint %6.2fns -> %6.2fns\n", result.transformPoint.scalar, result.transformPoint.simd );
+
+	return result;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <stdint.h>
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+namespace wv
+{
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	namespace Debug 
+	{
+
+	///////////////////////////////////////////////////////////////////////////////////////
+
+		struct sMathBenchmarkTiming
+		{
+			double scalar = 0.0; // nanoseconds per call
+			double simd   = 0.0;
+		};
+
+		struct sMathBenchmarkResult
+		{
+			uint32_t iterations = 0;
+			bool     sse        = false;
+
+			sMathBenchmarkTiming multiply;
+			sMathBenchmarkTiming inverse;
+			sMathBenchmarkTiming transpose;
+			sMathBenchmarkTiming transformPoint;
+		};
+
+	///////////////////////////////////////////////////////////////////////////////////////
+
+		/// <summary>
+		/// Times the generic matrix templates against the float 4x4 SIMD overloads.
+		/// Blocks the calling thread
+		/// </summary>
+		sMathBenchmarkResult RunMathBenchmark( uint32_t _iterations = 1000000 );
+
+	}
+
+}
@@ -60,7 +60,7 @@ void wv::iGraphicsDevice::initEmbeds()
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
-void wv::iGraphicsDevice::draw( sMesh* _mesh )
+void wv::iGraphicsDevice::draw( sMesh* _mesh, uint32_t _lod )
 {
 	WV_TRACE();
 
@@ -80,18 +80,18 @@ void wv::iGraphicsDevice::draw( sMesh* _mesh )
 			
 			mat->setAsActive( this );
 			mat->setInstanceUniforms( _mesh );
-			drawPrimitive( _mesh->primitives[ i ] );
+			drawPrimitive( _mesh->primitives[ i ], _lod );
 		}
 		else
 		{
-			drawPrimitive( _mesh->primitives[ i ] );
+			drawPrimitive( _mesh->primitives[ i ], _lod );
 		}
 	}
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
-void wv::iGraphicsDevice::drawNode( sMeshNode* _node )
+void wv::iGraphicsDevice::drawNode( sMeshNode* _node, uint32_t _lod )
 {
 	WV_TRACE();
 
@@ -99,10 +99,10 @@ void wv::iGraphicsDevice::drawNode( sMeshNode* _node )
 		return;
 
 	for( auto& mesh : _node->meshes )
-		draw( mesh );
+		draw( mesh, _lod );
 
 	for( auto& childNode : _node->children )
-		drawNode( childNode );
+		drawNode( childNode, _lod );
 }
 
 
@@ -65,8 +65,8 @@ namespace wv
 
 		void initEmbeds();
 
-		void draw( sMesh* _mesh );
-		void drawNode( sMeshNode* _node );
+		void draw( sMesh* _mesh, uint32_t _lod = 0 );
+		void drawNode( sMeshNode* _node, uint32_t _lod = 0 );
 
 		std::thread::id getThreadID() { return m_threadID; }
 
@@ -90,6 +90,9 @@ namespace wv
 		virtual void setClearColor( const wv::cColor& _color ) = 0;
 		virtual void clearRenderTarget( bool _color, bool _depth ) = 0;
 
+		virtual void setDepthTest( bool _enabled ) = 0;
+		virtual void setAlphaBlending( bool _enabled ) = 0;
+
 		virtual sShaderProgram* createProgram( sShaderProgramDesc* _desc ) = 0;
 		virtual void destroyProgram( sShaderProgram* _pProgram ) = 0;
 
@@ -107,13 +110,27 @@ namespace wv
 
 		virtual Primitive* createPrimitive( PrimitiveDesc* _desc ) = 0;
 		virtual void destroyPrimitive( Primitive* _primitive ) = 0;
+		virtual void updatePrimitive( Primitive* _primitive, void* _vertices, uint32_t _sizeVertices ) = 0;
 
 		virtual void createTexture( Texture* _pTexture, TextureDesc* _desc ) = 0;
 		virtual void destroyTexture( Texture** _texture ) = 0;
 
 		virtual void bindTextureToSlot( Texture* _texture, unsigned int _slot ) = 0;
 
-		virtual void drawPrimitive( Primitive* _primitive ) = 0;
+		virtual void drawPrimitive( Primitive* _primitive, uint32_t _lod ) = 0;
+
+		/// <summary>
+		/// Draws part of a dynamic primitive, so batches streamed in one updatePrimitive can be drawn one by one
+		/// </summary>
+		virtual void drawPrimitiveRange( Primitive* _primitive, uint32_t _firstVertex, uint32_t _numVertices ) = 0;
+
+		virtual void beginGPUTimer() = 0;
+		virtual void endGPUTimer() = 0;
+		
+		/// <summary>
+		/// Time in seconds of the latest timed frame that the GPU has finished, negative if not supported
+		/// </summary>
+		virtual double getGPUTime() = 0;
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
@@ -54,6 +54,17 @@ static GLenum getGlBufferEnum( wv::eGPUBufferType _type )
 	return GL_NONE;
 }
 
+static GLenum getGlTopology( wv::PrimitiveTopology _topology )
+{
+	switch( _topology )
+	{
+	case wv::WV_PRIMITIVE_TOPOLOGY_TRIANGLES: return GL_TRIANGLES; break;
+	case wv::WV_PRIMITIVE_TOPOLOGY_LINES:     return GL_LINES;     break;
+	}
+
+	return GL_TRIANGLES;
+}
+
 static GLenum getGlBufferUsage( wv::eGPUBufferUsage _usage )
 {
 	switch( _usage )
@@ -289,6 +300,37 @@ void wv::cOpenGLGraphicsDevice::clearRenderTarget( bool _color, bool _depth )
 #endif
 }
 
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cOpenGLGraphicsDevice::setDepthTest( bool _enabled )
+{
+	WV_TRACE();
+
+#ifdef WV_SUPPORT_OPENGL
+	if ( _enabled )
+		glEnable( GL_DEPTH_TEST );
+	else
+		glDisable( GL_DEPTH_TEST );
+#endif
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cOpenGLGraphicsDevice::setAlphaBlending( bool _enabled )
+{
+	WV_TRACE();
+
+#ifdef WV_SUPPORT_OPENGL
+	if ( _enabled )
+	{
+		glEnable( GL_BLEND );
+		glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
+	}
+	else
+		glDisable( GL_BLEND );
+#endif
+}
+
 wv::sShaderProgram* wv::cOpenGLGraphicsDevice::createProgram( sShaderProgramDesc* _desc )
 {
 	eShaderProgramType&   type   = _desc->type;
@@ -624,23 +666,36 @@ wv::Primitive* wv::cOpenGLGraphicsDevice::createPrimitive( PrimitiveDesc* _desc
 
 	WV_ASSERT_ERR( "ERROR\n" );
 
+	int stride = 0;
+	for ( unsigned int i = 0; i < _desc->layout.numElements; i++ )
+		stride += _desc->layout.elements[ i ].size;
+
 	sGPUBufferDesc vbDesc;
 	vbDesc.name  = "vbo";
 	vbDesc.type  = WV_BUFFER_TYPE_VERTEX;
-	vbDesc.usage = WV_BUFFER_USAGE_STATIC_DRAW;
+	vbDesc.usage = _desc->type == WV_PRIMITIVE_TYPE_DYNAMIC ? WV_BUFFER_USAGE_DYNAMIC_DRAW : WV_BUFFER_USAGE_STATIC_DRAW;
 	vbDesc.size  = _desc->sizeVertices;
 	primitive.vertexBuffer = createGPUBuffer( &vbDesc );
+	primitive.vertexBuffer->stride = stride;
 	primitive.material = _desc->pMaterial;
+	primitive.mode = _desc->type;
+	primitive.topology = _desc->topology;
+
+	primitive.numLODs = _desc->numLODs;
+	for ( uint32_t i = 0; i < _desc->numLODs; i++ )
+		primitive.lods[ i ] = _desc->lods[ i ];
 
-	uint32_t count = _desc->sizeVertices / sizeof( Vertex );
-	primitive.vertexBuffer->count = count;
-	
 	glBindBuffer( GL_ARRAY_BUFFER, primitive.vertexBuffer->handle );
 	
 	WV_ASSERT_ERR( "ERROR\n" );
 
-	primitive.vertexBuffer->buffer( (uint8_t*)_desc->vertices, _desc->sizeVertices );
-	bufferData( primitive.vertexBuffer );
+	// dynamic primitives may be created empty with only a capacity
+	if ( _desc->vertices )
+	{
+		primitive.vertexBuffer->count = _desc->sizeVertices / stride;
+		primitive.vertexBuffer->buffer( (uint8_t*)_desc->vertices, _desc->sizeVertices );
+		bufferData( primitive.vertexBuffer );
+	}
 
 	if ( _desc->numIndices > 0 )
 	{
@@ -681,13 +736,6 @@ wv::Primitive* wv::cOpenGLGraphicsDevice::createPrimitive( PrimitiveDesc* _desc
 	}
 	
 	int offset = 0;
-	int stride = 0;
-	for ( unsigned int i = 0; i < _desc->layout.numElements; i++ )
-	{
-		sVertexAttribute& element = _desc->layout.elements[ i ];
-		stride += element.size;
-	}
-
 	for ( unsigned int i = 0; i < _desc->layout.numElements; i++ )
 	{
 		sVertexAttribute& element = _desc->layout.elements[ i ];
@@ -720,8 +768,6 @@ wv::Primitive* wv::cOpenGLGraphicsDevice::createPrimitive( PrimitiveDesc* _desc
 	
 	WV_ASSERT_ERR( "ERROR\n" );
 
-	primitive.vertexBuffer->stride = stride;
-	
 	return &primitive;
 #else
 	return nullptr;
@@ -747,6 +793,45 @@ void wv::cOpenGLGraphicsDevice::destroyPrimitive( Primitive* _primitive )
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
+void wv::cOpenGLGraphicsDevice::updatePrimitive( Primitive* _primitive, void* _vertices, uint32_t _sizeVertices )
+{
+	WV_TRACE();
+
+#ifdef WV_SUPPORT_OPENGL
+	if ( _primitive->mode != WV_PRIMITIVE_TYPE_DYNAMIC )
+	{
+		Debug::Print( Debug::WV_PRINT_ERROR, "Cannot update a static primitive\n" );
+		return;
+	}
+
+	cGPUBuffer& buffer = *_primitive->vertexBuffer;
+
+	if ( _sizeVertices > (uint32_t)buffer.size )
+	{
+		// grow geometrically so that the buffer settles after a few frames
+		size_t size = buffer.size > 0 ? buffer.size : 1024;
+		while ( size < _sizeVertices )
+			size *= 2;
+
+		allocateBuffer( &buffer, size );
+	}
+	else
+	{
+		// orphan the old storage instead of waiting for the GPU to finish with it
+		glNamedBufferData( buffer.handle, buffer.size, 0, getGlBufferUsage( buffer.usage ) );
+	}
+
+	if ( _sizeVertices > 0 )
+		glNamedBufferSubData( buffer.handle, 0, _sizeVertices, _vertices );
+
+	WV_ASSERT_ERR( "Failed to update primitive\n" );
+
+	buffer.count = _sizeVertices / buffer.stride;
+#endif
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
 void wv::cOpenGLGraphicsDevice::createTexture( Texture* _pTexture, TextureDesc* _desc )
 {
 	WV_TRACE();
@@ -895,7 +980,7 @@ void wv::cOpenGLGraphicsDevice::bindTextureToSlot( Texture* _texture, unsigned i
 }
 ///////////////////////////////////////////////////////////////////////////////////////
 
-void wv::cOpenGLGraphicsDevice::drawPrimitive( Primitive* _primitive )
+void wv::cOpenGLGraphicsDevice::drawPrimitive( Primitive* _primitive, uint32_t _lod )
 {
 	WV_TRACE();
 
@@ -908,13 +993,27 @@ void wv::cOpenGLGraphicsDevice::drawPrimitive( Primitive* _primitive )
 	for ( auto& buf : shaderBuffers )
 		bufferData( buf );
 	
-	/// TODO: change GL_TRIANGLES
+	GLenum topology = getGlTopology( _primitive->topology );
+
 	if ( _primitive->drawType == WV_PRIMITIVE_DRAW_TYPE_INDICES )
 	{
-		glDrawElements( GL_TRIANGLES, _primitive->indexBuffer->count, GL_UNSIGNED_INT, 0 );
+		if ( _primitive->numLODs > 0 )
+		{
+			const sPrimitiveLOD& lod = _primitive->lods[ _lod < _primitive->numLODs ? _lod : _primitive->numLODs - 1 ];
+			glDrawElements( topology, lod.numIndices, GL_UNSIGNED_INT, VPTRi32( lod.firstIndex * sizeof( uint32_t ) ) );
+		}
+		else
+			glDrawElements( topology, _primitive->indexBuffer->count, GL_UNSIGNED_INT, 0 );
 
 		WV_ASSERT_ERR( "ERROR\n" );
 	}
+	else if ( _primitive->mode == WV_PRIMITIVE_TYPE_DYNAMIC )
+	{
+		// the vertex array already points at the streamed buffer
+		if ( _primitive->vertexBuffer->count > 0 )
+			glDrawArrays( topology, 0, _primitive->vertexBuffer->count );
+		WV_ASSERT_ERR( "ERROR\n" );
+	}
 	else
 	{ 
 	#ifndef EMSCRIPTEN
@@ -924,7 +1023,7 @@ void wv::cOpenGLGraphicsDevice::drawPrimitive( Primitive* _primitive )
 		glBindVertexBuffer( 0, vbo, 0, _primitive->vertexBuffer->stride );
 		WV_ASSERT_ERR( "ERROR\n" );
 
-		glDrawArrays( GL_TRIANGLES, 0, numVertices );
+		glDrawArrays( topology, 0, numVertices );
 		WV_ASSERT_ERR( "ERROR\n" );
 	#else
 		Debug::Print( Debug::WV_PRINT_FATAL, "glBindVertexBuffer is not supported on WebGL. Index Buffer is required\n" );
@@ -935,6 +1034,35 @@ void wv::cOpenGLGraphicsDevice::drawPrimitive( Primitive* _primitive )
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
+void wv::cOpenGLGraphicsDevice::drawPrimitiveRange( Primitive* _primitive, uint32_t _firstVertex, uint32_t _numVertices )
+{
+	WV_TRACE();
+
+#ifdef WV_SUPPORT_OPENGL
+	if ( _primitive->mode != WV_PRIMITIVE_TYPE_DYNAMIC || _primitive->drawType == WV_PRIMITIVE_DRAW_TYPE_INDICES )
+	{
+		Debug::Print( Debug::WV_PRINT_ERROR, "Only dynamic primitives without indices can be drawn in ranges\n" );
+		return;
+	}
+
+	if ( _numVertices == 0 || _firstVertex + _numVertices > _primitive->vertexBuffer->count )
+		return;
+
+	glBindVertexArray( _primitive->vaoHandle );
+
+	WV_ASSERT_ERR( "ERROR\n" );
+
+	std::vector<cGPUBuffer*>& shaderBuffers = m_activePipeline->pVertexProgram->shaderBuffers;
+	for ( auto& buf : shaderBuffers )
+		bufferData( buf );
+
+	glDrawArrays( getGlTopology( _primitive->topology ), _firstVertex, _numVertices );
+	WV_ASSERT_ERR( "ERROR\n" );
+#endif
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
 bool wv::cOpenGLGraphicsDevice::getError( std::string* _out )
 {
 	WV_TRACE();
@@ -966,3 +1094,61 @@ bool wv::cOpenGLGraphicsDevice::getError( std::string* _out )
 	return false;
 #endif
 }
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cOpenGLGraphicsDevice::beginGPUTimer()
+{
+	WV_TRACE();
+
+#if defined( WV_SUPPORT_OPENGL ) && !defined( EMSCRIPTEN ) // WebGL does not support GL_TIME_ELAPSED
+	if ( !glGetQueryObjectui64v )
+		return;
+
+	if ( m_timerQueries[ 0 ] == 0 )
+		glGenQueries( WV_GPU_TIMER_QUERIES, m_timerQueries );
+
+	// oldest first so that the newest result is kept
+	for ( int i = 0; i < WV_GPU_TIMER_QUERIES; i++ )
+	{
+		int index = ( m_timerIndex + i ) % WV_GPU_TIMER_QUERIES;
+		if ( !m_timerPending[ index ] )
+			continue;
+
+		GLint available = 0;
+		glGetQueryObjectiv( m_timerQueries[ index ], GL_QUERY_RESULT_AVAILABLE, &available );
+		if ( !available )
+			continue;
+
+		GLuint64 elapsed = 0;
+		glGetQueryObjectui64v( m_timerQueries[ index ], GL_QUERY_RESULT, &elapsed );
+		m_gpuTime = (double)elapsed * 1e-9;
+		m_timerPending[ index ] = false;
+	}
+
+	// skip timing this frame rather than waiting on the query
+	if ( m_timerPending[ m_timerIndex ] )
+		return;
+
+	glBeginQuery( GL_TIME_ELAPSED, m_timerQueries[ m_timerIndex ] );
+	m_timerActive = true;
+#endif
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cOpenGLGraphicsDevice::endGPUTimer()
+{
+	WV_TRACE();
+
+#if defined( WV_SUPPORT_OPENGL ) && !defined( EMSCRIPTEN )
+	if ( !m_timerActive )
+		return;
+
+	glEndQuery( GL_TIME_ELAPSED );
+	
+	m_timerPending[ m_timerIndex ] = true;
+	m_timerIndex = ( m_timerIndex + 1 ) % WV_GPU_TIMER_QUERIES;
+	m_timerActive = false;
+#endif
+}
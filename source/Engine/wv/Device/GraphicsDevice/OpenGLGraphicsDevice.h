@@ -46,6 +46,9 @@ namespace wv
 		virtual void setClearColor( const wv::cColor& _color ) override;
 		virtual void clearRenderTarget( bool _color, bool _depth ) override;
 
+		virtual void setDepthTest( bool _enabled ) override;
+		virtual void setAlphaBlending( bool _enabled ) override;
+
 		virtual sShaderProgram* createProgram( sShaderProgramDesc* _desc ) override;
 		virtual void destroyProgram( sShaderProgram* _pProgram ) override;
 
@@ -63,13 +66,19 @@ namespace wv
 
 		virtual Primitive* createPrimitive( PrimitiveDesc* _desc ) override;
 		virtual void destroyPrimitive( Primitive* _primitive ) override;
+		virtual void updatePrimitive( Primitive* _primitive, void* _vertices, uint32_t _sizeVertices ) override;
 
 		virtual void createTexture( Texture* _pTexture, TextureDesc* _desc ) override;
 		virtual void destroyTexture( Texture** _texture ) override;
 
 		virtual void bindTextureToSlot( Texture* _texture, unsigned int _slot ) override;
 
-		virtual void drawPrimitive( Primitive* _primitive ) override;
+		virtual void drawPrimitive( Primitive* _primitive, uint32_t _lod ) override;
+		virtual void drawPrimitiveRange( Primitive* _primitive, uint32_t _firstVertex, uint32_t _numVertices ) override;
+
+		virtual void beginGPUTimer() override;
+		virtual void endGPUTimer() override;
+		virtual double getGPUTime() override { return m_gpuTime; }
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
@@ -92,6 +101,14 @@ namespace wv
 
 		// states
 		std::vector<wv::Handle> m_boundTextureSlots;
+
+	// results are read a few frames late to avoid stalling on the GPU
+	#define WV_GPU_TIMER_QUERIES 4
+		wv::Handle m_timerQueries[ WV_GPU_TIMER_QUERIES ] = { 0 };
+		bool m_timerPending[ WV_GPU_TIMER_QUERIES ] = { false };
+		int  m_timerIndex = 0;
+		bool m_timerActive = false;
+		double m_gpuTime = -1.0;
 	};
 
 	template<typename ...Args>
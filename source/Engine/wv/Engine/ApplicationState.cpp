@@ -5,8 +5,13 @@
 
 #include <wv/Reflection/Reflection.h>
 #include <wv/Memory/FileSystem.h>
+#include <wv/Memory/PoolAllocator.h>
 
 #include <wv/Engine/Engine.h>
+#include <wv/Scene/TransformHierarchy.h>
+#include <wv/Entity/EntityWorld.h>
+#include <wv/Entity/EntitySystems.h>
+#include <wv/Physics/PhysicsEngine.h>
 
 void wv::cApplicationState::onCreate()
 {
@@ -25,6 +30,9 @@ void wv::cApplicationState::onDestroy()
 	}
 
 	m_scenes.clear();
+
+	// scene objects are pooled, hand the now empty blocks back in one go
+	Pool::releaseUnused();
 }
 
 void wv::cApplicationState::update( double _deltaTime )
@@ -32,17 +40,31 @@ void wv::cApplicationState::update( double _deltaTime )
 	if( m_pNextScene )
 	{
 		if( m_pCurrentScene )
+		{
 			m_pCurrentScene->onUnload();
 
-		m_pNextScene->onLoad();
+			// hand back the blocks the old scene emptied before the next one loads
+			Pool::releaseUnused();
+		}
+
+		loadIntoEngine( m_pNextScene );
 
 		Debug::Print( Debug::WV_PRINT_DEBUG, "Switched Scene\n" );
 		m_pCurrentScene = m_pNextScene;
 		m_pNextScene = nullptr;
+
+		cEngine::get()->m_pTransformHierarchy->invalidate();
 	}
 
+	cEngine* engine = cEngine::get();
+	cEntityWorld* world = m_pCurrentScene->getWorld();
+
 	m_pCurrentScene->update( _deltaTime );
-	m_pCurrentScene->m_transform.update( nullptr );
+	Systems::syncRigidbodies( world, engine->m_pPhysicsEngine );
+	Systems::dispatchPhysicsEvents( world, engine->m_pPhysicsEngine );
+	
+	engine->m_pTransformHierarchy->update( &m_pCurrentScene->m_transform );
+	Systems::updateTransforms( world, engine->m_pTaskScheduler );
 }
 
 void wv::cApplicationState::draw( iDeviceContext* _pContext, iGraphicsDevice* _pDevice )
@@ -51,6 +73,7 @@ void wv::cApplicationState::draw( iDeviceContext* _pContext, iGraphicsDevice* _p
 		return;
 	
 	m_pCurrentScene->draw( _pContext, _pDevice );
+	Systems::drawMeshes( m_pCurrentScene->getWorld() );
 }
 
 void wv::cApplicationState::reloadScene()
@@ -76,12 +99,31 @@ void wv::cApplicationState::reloadScene()
 	}
 
 	delete m_pCurrentScene;
+	Pool::releaseUnused();
+
+	// the new root can land on the old one's address, so the cached transforms have to go now
+	cEngine::get()->m_pTransformHierarchy->invalidate();
 
 	m_pCurrentScene = loadScene( cEngine::get()->m_pFileSystem, path );
 	m_scenes[ index ] = m_pCurrentScene;
 
 	m_pCurrentScene->onCreate();
-	m_pCurrentScene->onLoad();
+	loadIntoEngine( m_pCurrentScene );
+}
+
+void wv::cApplicationState::loadIntoEngine( cSceneRoot* _pScene )
+{
+	cEngine* engine = cEngine::get();
+	
+	_pScene->setResourceRegistry( engine->m_pResourceRegistry );
+	_pScene->setPhysicsEngine   ( engine->m_pPhysicsEngine );
+
+	engine->m_pPhysicsEngine->setLayerConfig( _pScene->getPhysicsLayers() );
+
+	// whole scene goes into the broad phase at once
+	engine->m_pPhysicsEngine->beginBatch();
+	_pScene->onLoad();
+	engine->m_pPhysicsEngine->endBatch();
 }
 
 wv::iSceneObject* parseSceneObject( const wv::Json& _json )
@@ -125,6 +167,13 @@ wv::cSceneRoot* wv::cApplicationState::loadScene( cFileSystem* _pFileSystem, con
 	wv::Json root = wv::Json::parse( src, err );
 
 	wv::cSceneRoot* scene = new wv::cSceneRoot( root[ "name" ].string_value(), _path);
+
+	if( root[ "physics" ][ "layers" ].is_object() )
+	{
+		sPhysicsLayerConfig layers{};
+		PhysicsLayers::parse( root[ "physics" ][ "layers" ], layers );
+		scene->setPhysicsLayers( layers );
+	}
 	
 	for( auto& objJson : root[ "scene" ].array_items() )
 		scene->addChild( parseSceneObject( objJson ) );
@@ -28,7 +28,10 @@ namespace wv
 
 		void reloadScene();
 
-		wv::cSceneRoot* loadScene( cFileSystem* _pFileSystem, const std::string& _path );
+		/// <summary>
+		/// Parses the scene file. Nothing is loaded until the scene is switched to
+		/// </summary>
+		static wv::cSceneRoot* loadScene( cFileSystem* _pFileSystem, const std::string& _path );
 
 		/// <returns>scene index</returns>
 		int addScene( cSceneRoot* _pScene );
@@ -42,6 +45,11 @@ namespace wv
 
 	private:
 
+		/// <summary>
+		/// Loads the scene into the engine's registry and physics engine
+		/// </summary>
+		void loadIntoEngine( cSceneRoot* _pScene );
+
 		std::vector<cSceneRoot*> m_scenes;
 
 		cSceneRoot* m_pNextScene = nullptr;
@@ -19,6 +19,7 @@
 
 #include <wv/Physics/PhysicsEngine.h>
 #include <wv/Primitive/Mesh.h>
+#include <wv/Primitive/SpriteBatch.h>
 
 #include <wv/RenderTarget/RenderTarget.h>
 #include <wv/RenderTarget/IntermediateRenderTargetHandler.h>
@@ -28,6 +29,14 @@
 
 #include <wv/Engine/ApplicationState.h>
 
+#include <wv/Graphics/GPUBuffer.h>
+#include <wv/Graphics/OcclusionCuller.h>
+#include <wv/Graphics/RenderGraph.h>
+#include <wv/Graphics/DynamicResolution.h>
+#include <wv/Thread/TaskScheduler.h>
+
+#include <wv/Scene/TransformHierarchy.h>
+
 #include <wv/Debug/Print.h>
 #include <wv/Debug/Draw.h>
 
@@ -42,6 +51,7 @@
 
 #include <type_traits>
 #include <random>
+#include <chrono>
 
 #ifdef EMSCRIPTEN
 #include <emscripten.h>
@@ -90,13 +100,26 @@ wv::cEngine::cEngine( EngineDesc* _desc )
 	
 	m_pApplicationState = _desc->pApplicationState;
 
+#ifdef WV_PLATFORM_PSVITA
+	m_pTaskScheduler = new cTaskScheduler( 0 );
+#else
+	{
+		int numThreads = (int)std::thread::hardware_concurrency();
+		m_pTaskScheduler = new cTaskScheduler( numThreads > 1 ? numThreads - 1 : 0 );
+	}
+#endif
+
+	m_pOcclusionCuller = new cOcclusionCuller( m_pTaskScheduler );
+	m_pTransformHierarchy = new cTransformHierarchy( m_pTaskScheduler );
+	m_pDynamicResolution = new cDynamicResolution( _desc->dynamicResolution );
+
 	/// TODO: move to descriptor
 	m_pPhysicsEngine = new cJoltPhysicsEngine();
-	m_pPhysicsEngine->init();
+	m_pPhysicsEngine->init( m_pTaskScheduler );
 	
 
 	m_pFileSystem = _desc->systems.pFileSystem;
-	m_pResourceRegistry = new cResourceRegistry( m_pFileSystem, graphics );
+	m_pResourceRegistry = new cResourceRegistry( m_pFileSystem, graphics, m_pTaskScheduler );
 	m_pResourceRegistry->initializeEmbeded();
 
 	graphics->initEmbeds();
@@ -113,9 +136,13 @@ wv::cEngine::cEngine( EngineDesc* _desc )
 		m_deferredPipeline->load( m_pFileSystem, graphics );
 		
 		createScreenQuad();
-		createGBuffer();
 	}
+
+	m_pSpriteBatch = new cSpriteBatch();
+	m_pSpriteBatch->create( m_pFileSystem, graphics );
 #endif
+
+	createRenderGraph();
 	
 	graphics->setRenderTarget( m_pScreenRenderTarget );
 	graphics->setClearColor( wv::Color::Black );
@@ -176,7 +203,17 @@ wv::Handle wv::cEngine::getUniqueHandle()
 void wv::cEngine::onResize( int _width, int _height )
 {
 	context->onResize( _width, _height );
-	recreateScreenRenderTarget( _width, _height );
+	graphics->onResize( _width, _height );
+
+	m_pScreenRenderTarget->width  = _width;
+	m_pScreenRenderTarget->height = _height;
+
+	// transient targets are resized once on the next frame
+	if( m_pRenderGraph )
+	{
+		Vector2i size = getViewportSize();
+		m_pRenderGraph->setOutputSize( size.x, size.y );
+	}
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////
@@ -277,7 +314,30 @@ void wv::cEngine::terminate()
 	freeflightCamera = nullptr;
 
 	graphics->destroyMesh( &m_screenQuad );
-	graphics->destroyRenderTarget( &m_gbuffer );
+	
+	m_pRenderGraph->destroy( graphics );
+	delete m_pRenderGraph;
+	m_pRenderGraph = nullptr;
+
+	if( m_pSpriteBatch )
+	{
+		m_pSpriteBatch->destroy( graphics );
+		delete m_pSpriteBatch;
+		m_pSpriteBatch = nullptr;
+	}
+
+	delete m_pDynamicResolution;
+	delete m_pOcclusionCuller;
+	delete m_pTransformHierarchy;
+	m_pDynamicResolution = nullptr;
+	m_pOcclusionCuller = nullptr;
+	m_pTransformHierarchy = nullptr;
+
+	// cancels queued loads and waits for running ones, so it has to go before the scheduler
+	delete m_pResourceRegistry;
+	delete m_pTaskScheduler;
+	m_pResourceRegistry = nullptr;
+	m_pTaskScheduler = nullptr;
 
 	// destroy modules
 	Debug::Draw::Internal::deinitDebugDraw( graphics );
@@ -294,6 +354,8 @@ void wv::cEngine::terminate()
 
 void wv::cEngine::tick()
 {
+	std::chrono::high_resolution_clock::time_point frameStart = std::chrono::high_resolution_clock::now();
+	
 	double dt = context->getDeltaTime();
 	
 #ifdef WV_PLATFORM_WASM
@@ -345,23 +407,11 @@ void wv::cEngine::tick()
 	/// ------------------ render ------------------ ///
 	
 
-#ifndef WV_PLATFORM_PSVITA
-	if( !m_gbuffer )
-		return;
-#endif
-
 	if ( m_pScreenRenderTarget->width == 0 || m_pScreenRenderTarget->height == 0 )
 		return;
 
-#ifdef WV_PLATFORM_PSVITA
-	graphics->setRenderTarget( nullptr );
-#else
-	graphics->setRenderTarget( m_gbuffer );
-#endif
-
 	graphics->beginRender();
-	
-	graphics->clearRenderTarget( true, true );
+	graphics->beginGPUTimer();
 
 #ifdef WV_SUPPORT_IMGUI
 	/// TODO: move
@@ -372,47 +422,16 @@ void wv::cEngine::tick()
 	ImGui::DockSpaceOverViewport( 0, 0, ImGuiDockNodeFlags_PassthruCentralNode );
 #endif // WV_SUPPORT_IMGUI
 	
-	m_pApplicationState->draw( context, graphics );
-	m_pResourceRegistry->drawMeshInstances();
-
-#ifdef WV_DEBUG
-	Debug::Draw::Internal::drawDebug( graphics );
-#endif
-
-#ifndef WV_PLATFORM_PSVITA
-	if( m_pIRTHandler )
-	{
-		if( m_pIRTHandler->m_pRenderTarget )
-			graphics->setRenderTarget( m_pIRTHandler->m_pRenderTarget );
-	}
-	else
-		graphics->setRenderTarget( m_pScreenRenderTarget );
-	
-	graphics->clearRenderTarget( true, true );
-
-	// bind gbuffer textures to deferred pass
-	for ( int i = 0; i < m_gbuffer->numTextures; i++ )
-		graphics->bindTextureToSlot( m_gbuffer->textures[ i ], i );
-
-	// render screen quad with deferred shader
-	m_deferredPipeline->use( graphics );
-	graphics->draw( m_screenQuad );
-	
-	if( m_pIRTHandler )
-	{
-		graphics->setRenderTarget( m_pScreenRenderTarget );
-		graphics->clearRenderTarget( true, true );
-		m_pIRTHandler->draw( graphics );
-	}
-
-#ifdef WV_SUPPORT_IMGUI
-	ImGui::Render();
-	ImGui_ImplOpenGL3_RenderDrawData( ImGui::GetDrawData() );
-#endif // WV_SUPPORT_IMGUI
-#endif
+	m_pRenderGraph->setResolutionScale( m_pDynamicResolution->getScale() );
+	m_pRenderGraph->execute( graphics );
 
+	graphics->endGPUTimer();
 	graphics->endRender();
 
+	// measured before swapping to leave out the vsync wait
+	std::chrono::duration<double> cpuTime = std::chrono::high_resolution_clock::now() - frameStart;
+	m_pDynamicResolution->update( cpuTime.count(), graphics->getGPUTime() );
+
 	context->swapBuffers();
 
 #ifndef WV_PLATFORM_PSVITA
@@ -423,8 +442,10 @@ void wv::cEngine::tick()
 			m_pIRTHandler->destroy();
 			m_pIRTHandler->create( graphics );
 
-			if( m_pIRTHandler->m_pRenderTarget )
-				recreateScreenRenderTarget( m_pIRTHandler->m_pRenderTarget->width, m_pIRTHandler->m_pRenderTarget->height );
+			m_pRenderGraph->setImportedTarget( m_viewportTarget, m_pIRTHandler->m_pRenderTarget );
+			
+			Vector2i size = getViewportSize();
+			m_pRenderGraph->setOutputSize( size.x, size.y );
 		}
 	}
 #endif
@@ -530,13 +551,88 @@ void wv::cEngine::createScreenQuad()
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
-void wv::cEngine::createGBuffer()
+static void scenePass( wv::cRenderGraph* _pGraph, wv::iGraphicsDevice* _pGraphics, void* _pUserData )
 {
-	Vector2i size = getViewportSize();
+	wv::cEngine* pEngine = (wv::cEngine*)_pUserData;
+	wv::iCamera* camera = pEngine->currentCamera;
+
+	pEngine->m_pApplicationState->draw( pEngine->context, _pGraphics );
+
+	pEngine->m_pOcclusionCuller->beginFrame( camera->getViewMatrix() * camera->getProjectionMatrix() );
+	pEngine->m_pResourceRegistry->drawMeshInstances( pEngine->m_pOcclusionCuller );
+
+#ifdef WV_DEBUG
+	wv::Debug::Draw::Internal::drawDebug( _pGraphics );
+#endif
+}
+
+static void deferredPass( wv::cRenderGraph* _pGraph, wv::iGraphicsDevice* _pGraphics, void* _pUserData )
+{
+	wv::cEngine* pEngine = (wv::cEngine*)_pUserData;
+	wv::RenderTarget* gbuffer = _pGraph->getRenderTarget( pEngine->m_gbuffer );
+
+	// bind gbuffer textures to deferred pass
+	for ( int i = 0; i < gbuffer->numTextures; i++ )
+		_pGraphics->bindTextureToSlot( gbuffer->textures[ i ], i );
+
+	// only part of the gbuffer is used when the resolution is scaled down
+	wv::cGPUBuffer* deferredBlock = pEngine->m_deferredPipeline->getShaderBuffer( "UbDeferredData" );
+	if ( deferredBlock )
+	{
+		wv::Vector2i size = _pGraph->getViewportSize( pEngine->m_gbuffer );
+		float uvScale[ 4 ] = { (float)size.x / (float)gbuffer->width, (float)size.y / (float)gbuffer->height, 0.0f, 0.0f };
+		deferredBlock->buffer( &uvScale );
+	}
+
+	// render screen quad with deferred shader
+	pEngine->m_deferredPipeline->use( _pGraphics );
+	_pGraphics->draw( pEngine->m_screenQuad );
+}
+
+static void spritePass( wv::cRenderGraph* _pGraph, wv::iGraphicsDevice* _pGraphics, void* _pUserData )
+{
+	wv::cEngine* pEngine = (wv::cEngine*)_pUserData;
+	wv::Vector2i size = _pGraph->getViewportSize( pEngine->m_litTarget );
+
+	pEngine->m_pSpriteBatch->draw( _pGraphics, size.x, size.y );
+}
+
+static void viewportPass( wv::cRenderGraph* _pGraph, wv::iGraphicsDevice* _pGraphics, void* _pUserData )
+{
+	wv::cEngine* pEngine = (wv::cEngine*)_pUserData;
+	pEngine->m_pIRTHandler->draw( _pGraphics );
+}
+
+static void imguiPass( wv::cRenderGraph* _pGraph, wv::iGraphicsDevice* _pGraphics, void* _pUserData )
+{
+#ifdef WV_SUPPORT_IMGUI
+	ImGui::Render();
+	ImGui_ImplOpenGL3_RenderDrawData( ImGui::GetDrawData() );
+#endif // WV_SUPPORT_IMGUI
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
 
-	RenderTargetDesc rtDesc;
-	rtDesc.width  = size.x;
-	rtDesc.height = size.y;
+void wv::cEngine::createRenderGraph()
+{
+	m_pRenderGraph = new cRenderGraph();
+
+#ifdef WV_PLATFORM_PSVITA
+	// forward rendering straight to the default framebuffer
+	m_screenTarget = m_pRenderGraph->importTarget( "screen", nullptr, true );
+
+	sRenderPassDesc scene;
+	scene.name = "scene";
+	scene.target = m_screenTarget;
+	scene.clearColor = true;
+	scene.clearDepth = true;
+	scene.execute = scenePass;
+	scene.pUserData = this;
+	m_pRenderGraph->addPass( scene );
+#else
+	m_screenTarget = m_pRenderGraph->importTarget( "screen", m_pScreenRenderTarget, true );
+
+	sRenderGraphTargetDesc gbufferDesc;
 #ifdef WV_PLATFORM_WINDOWS
 	TextureDesc texDescs[] = {
 		{ wv::WV_TEXTURE_CHANNELS_RGBA, wv::WV_TEXTURE_FORMAT_BYTE },
@@ -551,32 +647,69 @@ void wv::cEngine::createGBuffer()
 		{ wv::WV_TEXTURE_CHANNELS_RG,  wv::WV_TEXTURE_FORMAT_FLOAT }
 	#endif
 	};
-	rtDesc.pTextureDescs = texDescs;
-	rtDesc.numTextures = 4;
+	for ( int i = 0; i < 4; i++ )
+		gbufferDesc.textureDescs[ i ] = texDescs[ i ];
+	gbufferDesc.numTextures = 4;
 #endif
+	gbufferDesc.dynamicResolution = true;
+	m_gbuffer = m_pRenderGraph->createTransientTarget( "gbuffer", gbufferDesc );
 
-	wv::cCommandBuffer& buffer = graphics->getCommandBuffer();
-	buffer.push( WV_GPUTASK_CREATE_RENDERTARGET, &m_gbuffer, &rtDesc );
-	graphics->submitCommandBuffer( buffer );
-	graphics->executeCommandBuffer( buffer );
-
-
-}
-
-void wv::cEngine::recreateScreenRenderTarget( int _width, int _height )
-{
-	graphics->onResize( _width, _height );
+	// the lit image goes to the intermediate target if there is one
+	m_litTarget = m_screenTarget;
+	if ( m_pIRTHandler )
+	{
+		m_viewportTarget = m_pRenderGraph->importTarget( "viewport", m_pIRTHandler->m_pRenderTarget, false );
+		m_litTarget = m_viewportTarget;
+	}
 
-	// recreate render target
-	m_pScreenRenderTarget->width = _width;
-	m_pScreenRenderTarget->height = _height;
-	
-	if( m_gbuffer )
-		graphics->destroyRenderTarget( &m_gbuffer );
+	sRenderPassDesc scene;
+	scene.name = "scene";
+	scene.target = m_gbuffer;
+	scene.clearColor = true;
+	scene.clearDepth = true;
+	scene.execute = scenePass;
+	scene.pUserData = this;
+	m_pRenderGraph->addPass( scene );
+
+	sRenderPassDesc deferred;
+	deferred.name = "deferred";
+	deferred.reads = { m_gbuffer };
+	deferred.target = m_litTarget;
+	deferred.clearColor = true;
+	deferred.clearDepth = true;
+	deferred.execute = deferredPass;
+	deferred.pUserData = this;
+	m_pRenderGraph->addPass( deferred );
+
+	sRenderPassDesc sprites;
+	sprites.name = "sprites";
+	sprites.target = m_litTarget;
+	sprites.execute = spritePass;
+	sprites.pUserData = this;
+	m_pRenderGraph->addPass( sprites );
+
+	if ( m_pIRTHandler )
+	{
+		sRenderPassDesc viewport;
+		viewport.name = "viewport";
+		viewport.reads = { m_viewportTarget };
+		viewport.target = m_screenTarget;
+		viewport.clearColor = true;
+		viewport.clearDepth = true;
+		viewport.execute = viewportPass;
+		viewport.pUserData = this;
+		m_pRenderGraph->addPass( viewport );
+	}
 
-	if( _width == 0 || _height == 0 )
-		return;
+	sRenderPassDesc imgui;
+	imgui.name = "imgui";
+	imgui.target = m_screenTarget;
+	imgui.hasSideEffects = true;
+	imgui.execute = imguiPass;
+	imgui.pUserData = this;
+	m_pRenderGraph->addPass( imgui );
+#endif
 
-	createGBuffer();
+	Vector2i size = getViewportSize();
+	m_pRenderGraph->setOutputSize( size.x, size.y );
 }
-
@@ -4,6 +4,8 @@
 #include <wv/Events/InputListener.h>
 
 #include <wv/Math/Vector2.h>
+#include <wv/Graphics/RenderGraph.h>
+#include <wv/Graphics/DynamicResolution.h>
 
 #include <wv/Types.h>
 
@@ -32,6 +34,10 @@ namespace wv
 
 	class cResourceRegistry;
 	class cJoltPhysicsEngine;
+	class cTaskScheduler;
+	class cOcclusionCuller;
+	class cSpriteBatch;
+	class cTransformHierarchy;
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
@@ -61,6 +67,11 @@ namespace wv
 		/// </summary>
 		iIntermediateRenderTargetHandler* pIRTHandler = nullptr;
 
+		/// <summary>
+		/// Scales the G-buffer resolution to stay within a frame time budget
+		/// </summary>
+		sDynamicResolutionDesc dynamicResolution;
+
 		cApplicationState* pApplicationState = nullptr;
 	};
 
@@ -102,7 +113,14 @@ namespace wv
 		// deferred rendering
 		sMesh*             m_screenQuad      = nullptr;
 		cProgramPipeline* m_deferredPipeline = nullptr;
-		RenderTarget*     m_gbuffer         = nullptr;
+
+		// render graph
+		cRenderGraph*        m_pRenderGraph   = nullptr;
+		hRenderGraphResource m_gbuffer        = WV_RENDER_GRAPH_INVALID_HANDLE;
+		hRenderGraphResource m_screenTarget   = WV_RENDER_GRAPH_INVALID_HANDLE;
+		hRenderGraphResource m_viewportTarget = WV_RENDER_GRAPH_INVALID_HANDLE;
+		hRenderGraphResource m_litTarget      = WV_RENDER_GRAPH_INVALID_HANDLE;
+		cDynamicResolution*  m_pDynamicResolution = nullptr;
 
 		// engine
 		iDeviceContext*  context  = nullptr;
@@ -121,9 +139,13 @@ namespace wv
 		cApplicationState* m_pApplicationState = nullptr;
 
 		// modules
-		cFileSystem*        m_pFileSystem       = nullptr;
-		cResourceRegistry*  m_pResourceRegistry = nullptr;
-		cJoltPhysicsEngine* m_pPhysicsEngine    = nullptr;
+		cFileSystem*         m_pFileSystem         = nullptr;
+		cResourceRegistry*   m_pResourceRegistry   = nullptr;
+		cJoltPhysicsEngine*  m_pPhysicsEngine      = nullptr;
+		cTaskScheduler*      m_pTaskScheduler      = nullptr;
+		cOcclusionCuller*    m_pOcclusionCuller    = nullptr;
+		cSpriteBatch*        m_pSpriteBatch        = nullptr;
+		cTransformHierarchy* m_pTransformHierarchy = nullptr;
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
@@ -133,9 +155,7 @@ namespace wv
 		void shutdownImgui();
 
 		void createScreenQuad();
-		void createGBuffer();
-
-		void recreateScreenRenderTarget( int _width, int _height );
+		void createRenderGraph();
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
@@ -0,0 +1,132 @@
+#include "HeadlessServer.h"
+
+#include <wv/Engine/SimulationWorld.h>
+#include <wv/Engine/ApplicationState.h>
+#include <wv/Scene/SceneRoot.h>
+#include <wv/Memory/FileSystem.h>
+#include <wv/Memory/PoolAllocator.h>
+#include <wv/Resource/ResourceRegistry.h>
+#include <wv/Thread/TaskScheduler.h>
+#include <wv/Debug/Print.h>
+
+#include <chrono>
+#include <thread>
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+wv::cHeadlessServer::cHeadlessServer( const sHeadlessServerDesc& _desc ) :
+	m_pFileSystem{ _desc.pFileSystem },
+	m_tickRate{ _desc.tickRate }
+{
+	int numWorkers = _desc.numWorkers;
+	if ( numWorkers < 0 )
+	{
+		int numThreads = (int)std::thread::hardware_concurrency();
+		numWorkers = numThreads > 1 ? numThreads - 1 : 0;
+	}
+
+	m_pTaskScheduler = new cTaskScheduler( numWorkers );
+
+	// no graphics device, only resources that do not touch the GPU can be loaded
+	m_pResourceRegistry = new cResourceRegistry( m_pFileSystem, nullptr, m_pTaskScheduler );
+
+	Debug::Print( Debug::WV_PRINT_DEBUG, "Created headless server with %i workers\n", numWorkers );
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+wv::cHeadlessServer::~cHeadlessServer()
+{
+	for ( cSimulationWorld* world : m_worlds )
+		delete world;
+	m_worlds.clear();
+
+	// cancels queued loads and waits for running ones, so it has to go before the scheduler
+	delete m_pResourceRegistry;
+	delete m_pTaskScheduler;
+	delete m_pFileSystem;
+	m_pResourceRegistry = nullptr;
+	m_pTaskScheduler    = nullptr;
+	m_pFileSystem       = nullptr;
+
+	// scene objects are pooled, hand the now empty blocks back in one go
+	Pool::releaseUnused();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+wv::cSimulationWorld* wv::cHeadlessServer::createWorld( const std::string& _scenePath )
+{
+	cSceneRoot* scene = cApplicationState::loadScene( m_pFileSystem, _scenePath );
+	if ( !scene )
+		return nullptr;
+
+	cSimulationWorld* world = new cSimulationWorld( m_pTaskScheduler, m_pResourceRegistry );
+	world->setScene( scene );
+	m_worlds.push_back( world );
+
+	return world;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cHeadlessServer::destroyWorld( cSimulationWorld* _pWorld )
+{
+	for ( size_t i = 0; i < m_worlds.size(); i++ )
+	{
+		if ( m_worlds[ i ] != _pWorld )
+			continue;
+
+		m_worlds.erase( m_worlds.begin() + i );
+		delete _pWorld;
+		return;
+	}
+
+	Debug::Print( Debug::WV_PRINT_ERROR, "World is not owned by this server\n" );
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cHeadlessServer::step( double _deltaTime )
+{
+	const auto start = std::chrono::steady_clock::now();
+
+	m_deltaTime = _deltaTime;
+
+	// a world waiting on its own physics jobs runs them itself, so this cannot starve
+	m_pTaskScheduler->parallelFor( (uint32_t)m_worlds.size(), stepWorldJob, this, WV_TASK_PRIORITY_NORMAL );
+
+	m_stepTime = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cHeadlessServer::run()
+{
+	const std::chrono::duration<double> interval{ 1.0 / m_tickRate };
+
+	m_running = true;
+	auto next = std::chrono::steady_clock::now();
+
+	while ( m_running )
+	{
+		step( interval.count() );
+
+		next += std::chrono::duration_cast<std::chrono::steady_clock::duration>( interval );
+
+		// fell behind, skip ahead instead of stepping back to back to catch up
+		const auto now = std::chrono::steady_clock::now();
+		if ( next < now )
+			next = now;
+
+		std::this_thread::sleep_until( next );
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cHeadlessServer::stepWorldJob( void* _pUserData, uint32_t _index )
+{
+	cHeadlessServer* server = (cHeadlessServer*)_pUserData;
+	server->m_worlds[ _index ]->step( server->m_deltaTime );
+}
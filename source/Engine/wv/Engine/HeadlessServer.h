@@ -0,0 +1,103 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+#include <atomic>
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+namespace wv
+{
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	class cFileSystem;
+	class cResourceRegistry;
+	class cTaskScheduler;
+	class cSimulationWorld;
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	struct sHeadlessServerDesc
+	{
+		/// <summary>
+		/// Owned and deleted by the server
+		/// </summary>
+		cFileSystem* pFileSystem = nullptr;
+
+		/// <summary>
+		/// Negative picks one less than the number of hardware threads
+		/// </summary>
+		int numWorkers = -1;
+
+		double tickRate = 60.0;
+	};
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	/// <summary>
+	/// Runs any number of simulation worlds without a window or graphics device.
+	/// The worlds share one task scheduler and one resource registry, so a cooked shape
+	/// is only loaded once however many worlds use it. Each step the worlds are stepped
+	/// in parallel, one task per world, and each world's physics step spreads over the
+	/// same workers.
+	///
+	/// Scenes should only hold objects that simulate. Cooked shapes have to be cooked
+	/// beforehand, there is no mesh parser without the engine
+	/// </summary>
+	class cHeadlessServer
+	{
+	public:
+		 cHeadlessServer( const sHeadlessServerDesc& _desc );
+		~cHeadlessServer();
+
+		/// <summary>
+		/// Parses the scene and loads it into a new world. Returns nullptr if the scene could not be parsed
+		/// </summary>
+		cSimulationWorld* createWorld( const std::string& _scenePath );
+		void destroyWorld( cSimulationWorld* _pWorld );
+
+		/// <summary>
+		/// Steps every world once, blocks until all of them are done
+		/// </summary>
+		void step( double _deltaTime );
+
+		/// <summary>
+		/// Steps at the tick rate until quit is called
+		/// </summary>
+		void run();
+		void quit() { m_running = false; }
+
+		size_t            getNumWorlds()            { return m_worlds.size(); }
+		cSimulationWorld* getWorld( size_t _index ) { return m_worlds[ _index ]; }
+
+		cResourceRegistry* getResourceRegistry() { return m_pResourceRegistry; }
+		cTaskScheduler*    getTaskScheduler()    { return m_pTaskScheduler; }
+
+		/// <summary>
+		/// Wall time of the last step in seconds
+		/// </summary>
+		double getStepTime() { return m_stepTime; }
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	private:
+
+		static void stepWorldJob( void* _pUserData, uint32_t _index );
+
+		cFileSystem*       m_pFileSystem       = nullptr;
+		cTaskScheduler*    m_pTaskScheduler    = nullptr;
+		cResourceRegistry* m_pResourceRegistry = nullptr;
+
+		std::vector<cSimulationWorld*> m_worlds;
+
+		double m_tickRate  = 60.0;
+		double m_deltaTime = 0.0; // of the step in progress
+		double m_stepTime  = 0.0;
+
+		std::atomic<bool> m_running{ false };
+	};
+
+}
@@ -0,0 +1,100 @@
+#include "SimulationWorld.h"
+
+#include <wv/Scene/SceneRoot.h>
+#include <wv/Scene/TransformHierarchy.h>
+#include <wv/Entity/EntityWorld.h>
+#include <wv/Entity/EntitySystems.h>
+#include <wv/Physics/PhysicsEngine.h>
+#include <wv/Resource/ResourceRegistry.h>
+#include <wv/Thread/TaskScheduler.h>
+#include <wv/Debug/Print.h>
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+wv::cSimulationWorld::cSimulationWorld( cTaskScheduler* _pTaskScheduler, cResourceRegistry* _pResourceRegistry ) :
+	m_pTaskScheduler{ _pTaskScheduler },
+	m_pResourceRegistry{ _pResourceRegistry }
+{
+	m_pTransformHierarchy = new cTransformHierarchy( m_pTaskScheduler );
+
+	m_pPhysicsEngine = new cJoltPhysicsEngine();
+	m_pPhysicsEngine->init( m_pTaskScheduler );
+
+	// the step has to be done before the scene reads the poses back
+	m_pPhysicsEngine->setAsyncStepping( false );
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+wv::cSimulationWorld::~cSimulationWorld()
+{
+	destroyScene();
+
+	m_pPhysicsEngine->terminate();
+	delete m_pPhysicsEngine;
+	m_pPhysicsEngine = nullptr;
+
+	delete m_pTransformHierarchy;
+	m_pTransformHierarchy = nullptr;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cSimulationWorld::setScene( cSceneRoot* _pScene )
+{
+	destroyScene();
+
+	m_pScene = _pScene;
+	if ( !m_pScene )
+		return;
+
+	m_pScene->setResourceRegistry( m_pResourceRegistry );
+	m_pScene->setPhysicsEngine   ( m_pPhysicsEngine );
+
+	m_pPhysicsEngine->setLayerConfig( m_pScene->getPhysicsLayers() );
+
+	m_pScene->onCreate();
+
+	// whole scene goes into the broad phase at once
+	m_pPhysicsEngine->beginBatch();
+	m_pScene->onLoad();
+	m_pPhysicsEngine->endBatch();
+
+	m_pTransformHierarchy->invalidate();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cSimulationWorld::step( double _deltaTime )
+{
+	if ( !m_pScene )
+		return;
+
+	cEntityWorld* world = m_pScene->getWorld();
+
+	m_pPhysicsEngine->update( _deltaTime );
+
+	m_pScene->update( _deltaTime );
+	Systems::syncRigidbodies( world, m_pPhysicsEngine );
+	Systems::dispatchPhysicsEvents( world, m_pPhysicsEngine );
+
+	m_pTransformHierarchy->update( &m_pScene->m_transform );
+	Systems::updateTransforms( world, m_pTaskScheduler );
+
+	m_numSteps++;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cSimulationWorld::destroyScene()
+{
+	if ( !m_pScene )
+		return;
+
+	m_pScene->onUnload();
+	m_pScene->onDestroy();
+	delete m_pScene;
+	m_pScene = nullptr;
+
+	m_pTransformHierarchy->invalidate();
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <stdint.h>
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+namespace wv
+{
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	class cSceneRoot;
+	class cResourceRegistry;
+	class cJoltPhysicsEngine;
+	class cTaskScheduler;
+	class cTransformHierarchy;
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	/// <summary>
+	/// One scene with its own physics engine and transform hierarchy. Nothing is shared
+	/// with other worlds except the task scheduler and the resource registry, so different
+	/// worlds can be stepped at the same time from different threads.
+	///
+	/// Does not draw, the scene's objects only simulate
+	/// </summary>
+	class cSimulationWorld
+	{
+	public:
+		 cSimulationWorld( cTaskScheduler* _pTaskScheduler, cResourceRegistry* _pResourceRegistry );
+		~cSimulationWorld();
+
+		/// <summary>
+		/// Takes ownership of the scene, creates it and loads it into this world's physics.
+		/// Any previous scene is unloaded and deleted
+		/// </summary>
+		void setScene( cSceneRoot* _pScene );
+
+		/// <summary>
+		/// Physics steps, scene update, then transforms. Only one thread may step a world at a time
+		/// </summary>
+		void step( double _deltaTime );
+
+		cSceneRoot*         getScene()         { return m_pScene; }
+		cJoltPhysicsEngine* getPhysicsEngine() { return m_pPhysicsEngine; }
+		uint64_t            getNumSteps()      { return m_numSteps; }
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	private:
+
+		void destroyScene();
+
+		cTaskScheduler*    m_pTaskScheduler    = nullptr;
+		cResourceRegistry* m_pResourceRegistry = nullptr;
+
+		cJoltPhysicsEngine*  m_pPhysicsEngine      = nullptr;
+		cTransformHierarchy* m_pTransformHierarchy = nullptr;
+		cSceneRoot*          m_pScene              = nullptr;
+
+		uint64_t m_numSteps = 0;
+	};
+
+}
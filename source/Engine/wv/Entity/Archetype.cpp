@@ -0,0 +1,147 @@
+#include "Archetype.h"
+
+#include <wv/Debug/Print.h>
+
+#include <string.h>
+#include <new>
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+static const size_t CHUNK_ALIGNMENT = 64;
+
+static inline uint32_t alignUp( uint32_t _value, uint32_t _alignment )
+{
+	return ( _value + _alignment - 1 ) & ~( _alignment - 1 );
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+wv::cArchetype::cArchetype( ComponentMask _mask ) :
+	m_mask{ _mask }
+{
+	uint32_t rowSize = sizeof( hEntity );
+	for ( uint32_t id = 0; id < WV_MAX_COMPONENT_TYPES; id++ )
+	{
+		if ( !hasComponent( id ) )
+			continue;
+
+		m_componentIDs.push_back( id );
+		rowSize += Component::getInfo( id ).size;
+	}
+
+	// shrink until every array fits with its alignment padding
+	m_capacity = CHUNK_SIZE / rowSize;
+	while ( m_capacity > 0 )
+	{
+		uint32_t offset = m_capacity * sizeof( hEntity );
+		for ( uint32_t id : m_componentIDs )
+		{
+			const sComponentInfo& info = Component::getInfo( id );
+			offset = alignUp( offset, info.alignment );
+			m_offsets[ id ] = offset;
+			offset += info.size * m_capacity;
+		}
+
+		if ( offset <= CHUNK_SIZE )
+			break;
+
+		m_capacity--;
+	}
+
+	if ( m_capacity == 0 )
+		Debug::Print( Debug::WV_PRINT_FATAL, "Archetype row of %u bytes does not fit in a chunk\n", rowSize );
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+wv::cArchetype::~cArchetype()
+{
+	clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+uint32_t wv::cArchetype::add( hEntity _entity )
+{
+	if ( m_chunks.empty() || m_chunks.back().count == m_capacity )
+	{
+		sArchetypeChunk chunk;
+		chunk.pData = (uint8_t*)::operator new( CHUNK_SIZE, std::align_val_t{ CHUNK_ALIGNMENT } );
+		m_chunks.push_back( chunk );
+	}
+
+	uint32_t row = m_numEntities++;
+	sArchetypeChunk& chunk = m_chunks.back();
+	
+	( (hEntity*)chunk.pData )[ chunk.count ] = _entity;
+	for ( uint32_t id : m_componentIDs )
+	{
+		const sComponentInfo& info = Component::getInfo( id );
+		memcpy( chunk.pData + m_offsets[ id ] + chunk.count * info.size, info.pDefault, info.size );
+	}
+	
+	chunk.count++;
+	return row;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+wv::hEntity wv::cArchetype::remove( uint32_t _row )
+{
+	uint32_t last = m_numEntities - 1;
+	hEntity moved{ 0 };
+	
+	if ( _row != last )
+	{
+		hEntity* dst = &getEntities( _row / m_capacity )[ _row % m_capacity ];
+		hEntity* src = &getEntities( last / m_capacity )[ last % m_capacity ];
+		*dst  = *src;
+		moved = *src;
+
+		for ( uint32_t id : m_componentIDs )
+			memcpy( getRowComponent( _row, id ), getRowComponent( last, id ), Component::getInfo( id ).size );
+	}
+
+	m_numEntities--;
+
+	sArchetypeChunk& chunk = m_chunks.back();
+	chunk.count--;
+	if ( chunk.count == 0 )
+	{
+		::operator delete( chunk.pData, std::align_val_t{ CHUNK_ALIGNMENT } );
+		m_chunks.pop_back();
+	}
+
+	return moved;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cArchetype::copyShared( uint32_t _row, cArchetype* _pSource, uint32_t _sourceRow )
+{
+	for ( uint32_t id : m_componentIDs )
+	{
+		if ( !_pSource->hasComponent( id ) )
+			continue;
+
+		memcpy( getRowComponent( _row, id ), _pSource->getRowComponent( _sourceRow, id ), Component::getInfo( id ).size );
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cArchetype::clear()
+{
+	for ( auto& chunk : m_chunks )
+		::operator delete( chunk.pData, std::align_val_t{ CHUNK_ALIGNMENT } );
+	
+	m_chunks.clear();
+	m_numEntities = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+uint8_t* wv::cArchetype::getRowComponent( uint32_t _row, uint32_t _id )
+{
+	return m_chunks[ _row / m_capacity ].pData + m_offsets[ _id ] + ( _row % m_capacity ) * Component::getInfo( _id ).size;
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <wv/Entity/Entity.h>
+
+#include <stdint.h>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+namespace wv
+{
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	struct sArchetypeChunk
+	{
+		uint8_t* pData = nullptr;
+		uint32_t count = 0;
+	};
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	/// <summary>
+	/// Storage for every entity with exactly the same set of components.
+	/// Entities live in fixed size chunks, each chunk holds one tightly packed array per 
+	/// component type. Every chunk except the last is always full
+	/// </summary>
+	class cArchetype
+	{
+	public:
+		static const uint32_t CHUNK_SIZE = 16 * 1024;
+
+		cArchetype( ComponentMask _mask );
+		~cArchetype();
+
+		ComponentMask getMask()          { return m_mask; }
+		uint32_t      getChunkCapacity() { return m_capacity; }
+		uint32_t      getNumEntities()   { return m_numEntities; }
+		uint32_t      getNumChunks()     { return (uint32_t)m_chunks.size(); }
+		
+		sArchetypeChunk& getChunk( uint32_t _chunk ) { return m_chunks[ _chunk ]; }
+
+		bool hasComponent( uint32_t _id ) { return ( m_mask >> _id ) & 1; }
+
+		hEntity* getEntities( uint32_t _chunk ) { return (hEntity*)m_chunks[ _chunk ].pData; }
+		
+		/// <summary>
+		/// Start of the component array in a chunk, nullptr if the component is not part of this archetype
+		/// </summary>
+		void* getComponents( uint32_t _chunk, uint32_t _id )
+		{
+			if ( !hasComponent( _id ) )
+				return nullptr;
+			return m_chunks[ _chunk ].pData + m_offsets[ _id ];
+		}
+
+		template<typename T>
+		T* getComponents( uint32_t _chunk ) { return (T*)getComponents( _chunk, Component::getID<T>() ); }
+
+		/// <summary>
+		/// Appends an entity with default initialized components. Returns the flat row index
+		/// </summary>
+		uint32_t add( hEntity _entity );
+
+		/// <summary>
+		/// Removes a row by moving the last entity into it.
+		/// Returns the entity that was moved, or an invalid handle if none was
+		/// </summary>
+		hEntity remove( uint32_t _row );
+
+		/// <summary>
+		/// Copies every component both archetypes share from a row in _pSource
+		/// </summary>
+		void copyShared( uint32_t _row, cArchetype* _pSource, uint32_t _sourceRow );
+
+		void clear();
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	private:
+
+		uint8_t* getRowComponent( uint32_t _row, uint32_t _id );
+
+		ComponentMask m_mask = 0;
+		std::vector<uint32_t> m_componentIDs;
+		uint32_t m_offsets[ WV_MAX_COMPONENT_TYPES ] = { 0 };
+		
+		uint32_t m_capacity    = 0;
+		uint32_t m_numEntities = 0;
+
+		std::vector<sArchetypeChunk> m_chunks;
+	};
+
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <wv/Math/Transform.h>
+#include <wv/Math/Quaternion.h>
+#include <wv/Misc/Color.h>
+#include <wv/Physics/PhysicsTypes.h>
+
+#include <stdint.h>
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+namespace wv
+{
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	class cMeshResource;
+	class iSceneObject;
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	struct sTransformComponent
+	{
+		cVector3f    position{ 0.0f, 0.0f, 0.0f };
+		cQuaternionf orientation{};
+		cVector3f    scale{ 1.0f, 1.0f, 1.0f };
+
+		cMatrix4x4f matrix{ 1.0f };
+
+		// set by scene object wrappers, the matrix is then copied from the scene hierarchy
+		Transformf* pSource = nullptr;
+	};
+
+	struct sMeshComponent
+	{
+		cMeshResource* pResource = nullptr;
+		
+		// rasterized into the occlusion buffer before anything is drawn
+		bool occluder = false;
+		
+		// lod selected last frame, used for hysteresis
+		uint32_t lod = 0;
+	};
+
+	struct sRigidbodyComponent
+	{
+		hPhysicsBody body{ 0 };
+
+		// receives the physics events of the body
+		iSceneObject* pOwner = nullptr;
+	};
+
+	struct sLightComponent
+	{
+		cColor color{ Color::White };
+		float intensity = 1.0f;
+		float range     = 10.0f;
+	};
+
+}
@@ -0,0 +1,45 @@
+#include "Entity.h"
+
+#include <wv/Debug/Print.h>
+
+#include <mutex>
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+static wv::sComponentInfo g_componentInfos[ wv::WV_MAX_COMPONENT_TYPES ];
+static uint32_t           g_numComponentTypes = 0;
+static std::mutex         g_componentMutex;
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+uint32_t wv::Component::registerType( uint32_t _size, uint32_t _alignment, const void* _pDefault )
+{
+	std::scoped_lock lock( g_componentMutex );
+
+	if ( g_numComponentTypes >= WV_MAX_COMPONENT_TYPES )
+	{
+		Debug::Print( Debug::WV_PRINT_FATAL, "Too many component types, max is %u\n", WV_MAX_COMPONENT_TYPES );
+		return WV_INVALID_COMPONENT;
+	}
+
+	sComponentInfo& info = g_componentInfos[ g_numComponentTypes ];
+	info.size      = _size;
+	info.alignment = _alignment;
+	info.pDefault  = _pDefault;
+
+	return g_numComponentTypes++;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+const wv::sComponentInfo& wv::Component::getInfo( uint32_t _id )
+{
+	return g_componentInfos[ _id ];
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+uint32_t wv::Component::getNumTypes()
+{
+	return g_numComponentTypes;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <wv/Types.h>
+
+#include <stdint.h>
+#include <type_traits>
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+namespace wv
+{
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	/*
+	 * entity handle value is ( generation << WV_ENTITY_INDEX_BITS ) | ( index + 1 )
+	 * so a zero handle is never valid and stale handles are rejected after the slot is reused
+	 */
+	DEFINE_UNIQUE_HANDLE( Entity );
+
+	static const uint32_t WV_ENTITY_INDEX_BITS = 20;
+	static const uint32_t WV_ENTITY_INDEX_MASK = ( 1u << WV_ENTITY_INDEX_BITS ) - 1;
+	static const uint32_t WV_MAX_ENTITIES      = WV_ENTITY_INDEX_MASK - 1;
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	typedef uint64_t ComponentMask;
+	
+	static const uint32_t WV_MAX_COMPONENT_TYPES = 64;
+	static const uint32_t WV_INVALID_COMPONENT   = ~0u;
+
+	struct sComponentInfo
+	{
+		uint32_t size      = 0;
+		uint32_t alignment = 0;
+		
+		// bytes of a default constructed component, copied into new rows
+		const void* pDefault = nullptr;
+	};
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	namespace Component
+	{
+		uint32_t registerType( uint32_t _size, uint32_t _alignment, const void* _pDefault );
+		
+		const sComponentInfo& getInfo( uint32_t _id );
+		uint32_t getNumTypes();
+
+		/// <summary>
+		/// Id of a component type, assigned on first use. 
+		/// Components are moved between chunks with memcpy and never destructed
+		/// </summary>
+		template<typename T>
+		uint32_t getID()
+		{
+			static_assert( std::is_trivially_destructible_v<T>, "Components must be trivially destructible" );
+
+			static const T defaultValue{};
+			static const uint32_t id = registerType( sizeof( T ), alignof( T ), &defaultValue );
+			return id;
+		}
+
+		template<typename... Ts>
+		ComponentMask getMask()
+		{
+			return ( ComponentMask( 0 ) | ... | ( ComponentMask( 1 ) << getID<Ts>() ) );
+		}
+	}
+
+}
@@ -0,0 +1,130 @@
+#include "EntitySystems.h"
+
+#include <wv/Entity/EntityWorld.h>
+#include <wv/Entity/Components.h>
+
+#include <wv/Primitive/Mesh.h>
+#include <wv/Scene/SceneObject.h>
+#include <wv/Thread/TaskScheduler.h>
+
+#ifdef WV_SUPPORT_PHYSICS
+#include <wv/Physics/PhysicsEngine.h>
+#endif
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::Systems::syncRigidbodies( cEntityWorld* _pWorld, cJoltPhysicsEngine* _pPhysicsEngine )
+{
+#ifdef WV_SUPPORT_PHYSICS
+	if ( !_pWorld || !_pPhysicsEngine )
+		return;
+
+	const float alpha = _pPhysicsEngine->getInterpolationAlpha();
+
+	// only bodies that moved are in here, sleeping bodies cost nothing
+	for ( const sPhysicsBodyTransform& body : _pPhysicsEngine->getActiveBodyTransforms() )
+	{
+		// user data is the entity that owns the body
+		sTransformComponent* transform = _pWorld->getComponent<sTransformComponent>( hEntity{ body.userData } );
+		if ( !transform )
+			continue;
+
+		// rendered between the last two fixed steps so motion is smooth at any frame rate
+		transform->position    = body.previousPosition + ( body.position - body.previousPosition ) * alpha;
+		transform->orientation = cQuaternionf::nlerp( body.previousOrientation, body.orientation, alpha );
+
+		// keep the scene object in step so its children follow the body
+		if ( transform->pSource )
+		{
+			transform->pSource->position = transform->position;
+			transform->pSource->setOrientation( transform->orientation );
+		}
+	}
+#endif // WV_SUPPORT_PHYSICS
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#ifdef WV_SUPPORT_PHYSICS
+static wv::iSceneObject* getBodyOwner( wv::cEntityWorld* _pWorld, uint32_t _userData )
+{
+	if ( _userData == 0 )
+		return nullptr;
+
+	wv::sRigidbodyComponent* rigidbody = _pWorld->getComponent<wv::sRigidbodyComponent>( wv::hEntity{ _userData } );
+	return rigidbody ? rigidbody->pOwner : nullptr;
+}
+#endif // WV_SUPPORT_PHYSICS
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::Systems::dispatchPhysicsEvents( cEntityWorld* _pWorld, cJoltPhysicsEngine* _pPhysicsEngine )
+{
+#ifdef WV_SUPPORT_PHYSICS
+	if ( !_pWorld || !_pPhysicsEngine )
+		return;
+
+	for ( const sPhysicsEvent& event : _pPhysicsEngine->getEvents() )
+	{
+		if ( iSceneObject* owner = getBodyOwner( _pWorld, event.userData1 ) )
+			owner->onPhysicsEvent( event );
+
+		if ( !event.body2.isValid() )
+			continue;
+
+		iSceneObject* other = getBodyOwner( _pWorld, event.userData2 );
+		if ( !other )
+			continue;
+
+		// seen from the other body
+		sPhysicsEvent swapped = event;
+		swapped.body1     = event.body2;
+		swapped.body2     = event.body1;
+		swapped.userData1 = event.userData2;
+		swapped.userData2 = event.userData1;
+		swapped.normal    = -event.normal;
+		other->onPhysicsEvent( swapped );
+	}
+#endif // WV_SUPPORT_PHYSICS
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::Systems::updateTransforms( cEntityWorld* _pWorld, cTaskScheduler* _pTaskScheduler )
+{
+	if ( !_pWorld )
+		return;
+
+	_pWorld->parallelEachChunk<sTransformComponent>( _pTaskScheduler, 
+		[]( uint32_t _count, hEntity* _pEntities, sTransformComponent* _pTransforms )
+		{
+			for ( uint32_t i = 0; i < _count; i++ )
+			{
+				sTransformComponent& transform = _pTransforms[ i ];
+				
+				if ( transform.pSource )
+					transform.matrix = transform.pSource->getMatrix();
+				else
+					Transformf::composeMatrix( transform.position, transform.orientation, transform.scale, transform.matrix );
+			}
+		} );
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::Systems::drawMeshes( cEntityWorld* _pWorld )
+{
+	if ( !_pWorld )
+		return;
+
+	_pWorld->eachChunk<sTransformComponent, sMeshComponent>( 
+		[]( uint32_t _count, hEntity* _pEntities, sTransformComponent* _pTransforms, sMeshComponent* _pMeshes )
+		{
+			for ( uint32_t i = 0; i < _count; i++ )
+			{
+				sMeshComponent& mesh = _pMeshes[ i ];
+				if ( mesh.pResource )
+					mesh.pResource->addToDrawQueue( &_pTransforms[ i ].matrix, &mesh.lod, mesh.occluder );
+			}
+		} );
+}
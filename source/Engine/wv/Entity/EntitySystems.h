@@ -0,0 +1,43 @@
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+namespace wv
+{
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	class cEntityWorld;
+	class cTaskScheduler;
+	class cJoltPhysicsEngine;
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	namespace Systems
+	{
+		/// <summary>
+		/// Copies the pose of every body that moved in the last physics step into the 
+		/// transform component of the entity stored in its user data, blended by the 
+		/// interpolation alpha. Runs every frame, also when no step was taken
+		/// </summary>
+		void syncRigidbodies( cEntityWorld* _pWorld, cJoltPhysicsEngine* _pPhysicsEngine );
+
+		/// <summary>
+		/// Hands the events of the last physics update to the owners of the bodies involved,
+		/// found through the entity in the body user data. Both owners of a contact get it
+		/// </summary>
+		void dispatchPhysicsEvents( cEntityWorld* _pWorld, cJoltPhysicsEngine* _pPhysicsEngine );
+
+		/// <summary>
+		/// Rebuilds the world matrix of every transform component, one chunk per job.
+		/// Components with a source transform copy its matrix, so run this after the scene hierarchy
+		/// </summary>
+		void updateTransforms( cEntityWorld* _pWorld, cTaskScheduler* _pTaskScheduler );
+
+		/// <summary>
+		/// Queues every mesh component on its resource, drawn by the render graph
+		/// </summary>
+		void drawMeshes( cEntityWorld* _pWorld );
+	}
+
+}
@@ -0,0 +1,199 @@
+#include "EntityWorld.h"
+
+#include <wv/Debug/Print.h>
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+static inline uint32_t entityIndex( wv::hEntity _entity )
+{
+	return ( _entity.value() & wv::WV_ENTITY_INDEX_MASK ) - 1;
+}
+
+static inline uint32_t entityGeneration( wv::hEntity _entity )
+{
+	return _entity.value() >> wv::WV_ENTITY_INDEX_BITS;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+wv::cEntityWorld::cEntityWorld()
+{
+
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+wv::cEntityWorld::~cEntityWorld()
+{
+	clear();
+
+	for ( cArchetype* archetype : m_archetypes )
+		delete archetype;
+
+	m_archetypes.clear();
+	m_archetypeMap.clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+wv::hEntity wv::cEntityWorld::createEntity( ComponentMask _mask )
+{
+	uint32_t index;
+	if ( !m_freeIndices.empty() )
+	{
+		index = m_freeIndices.back();
+		m_freeIndices.pop_back();
+	}
+	else
+	{
+		if ( m_records.size() >= WV_MAX_ENTITIES )
+		{
+			Debug::Print( Debug::WV_PRINT_ERROR, "Entity limit of %u reached\n", WV_MAX_ENTITIES );
+			return hEntity{ 0 };
+		}
+
+		index = (uint32_t)m_records.size();
+		m_records.push_back( {} );
+	}
+
+	sEntityRecord& record = m_records[ index ];
+	
+	// generation wraps within the bits left over by the index
+	const uint32_t generation = record.generation & ( ~0u >> WV_ENTITY_INDEX_BITS );
+	hEntity entity{ ( generation << WV_ENTITY_INDEX_BITS ) | ( index + 1 ) };
+
+	record.pArchetype = getArchetype( _mask );
+	record.row = record.pArchetype->add( entity );
+	
+	m_numEntities++;
+	return entity;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cEntityWorld::destroyEntity( hEntity& _entity )
+{
+	sEntityRecord* record = getRecord( _entity );
+	if ( !record )
+		return;
+
+	hEntity moved = record->pArchetype->remove( record->row );
+	if ( moved.isValid() )
+		m_records[ entityIndex( moved ) ].row = record->row;
+
+	record->pArchetype = nullptr;
+	record->row = 0;
+	record->generation++;
+
+	m_freeIndices.push_back( entityIndex( _entity ) );
+	m_numEntities--;
+
+	_entity.invalidate();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+bool wv::cEntityWorld::isAlive( hEntity _entity )
+{
+	return getRecord( _entity ) != nullptr;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cEntityWorld::clear()
+{
+	for ( cArchetype* archetype : m_archetypes )
+		archetype->clear();
+
+	m_freeIndices.clear();
+	for ( uint32_t i = 0; i < (uint32_t)m_records.size(); i++ )
+	{
+		sEntityRecord& record = m_records[ i ];
+		if ( record.pArchetype )
+			record.generation++;
+
+		record.pArchetype = nullptr;
+		record.row = 0;
+		m_freeIndices.push_back( i );
+	}
+
+	m_numEntities = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+wv::cEntityWorld::sEntityRecord* wv::cEntityWorld::getRecord( hEntity _entity )
+{
+	if ( !_entity.isValid() )
+		return nullptr;
+
+	const uint32_t index = entityIndex( _entity );
+	if ( index >= m_records.size() )
+		return nullptr;
+
+	sEntityRecord& record = m_records[ index ];
+	if ( !record.pArchetype )
+		return nullptr;
+	
+	const uint32_t generation = record.generation & ( ~0u >> WV_ENTITY_INDEX_BITS );
+	if ( generation != entityGeneration( _entity ) )
+		return nullptr;
+
+	return &record;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+wv::cArchetype* wv::cEntityWorld::getArchetype( ComponentMask _mask )
+{
+	auto it = m_archetypeMap.find( _mask );
+	if ( it != m_archetypeMap.end() )
+		return it->second;
+
+	cArchetype* archetype = new cArchetype( _mask );
+	m_archetypes.push_back( archetype );
+	m_archetypeMap[ _mask ] = archetype;
+	return archetype;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cEntityWorld::moveEntity( hEntity _entity, ComponentMask _newMask )
+{
+	sEntityRecord* record = getRecord( _entity );
+	if ( !record || record->pArchetype->getMask() == _newMask )
+		return;
+
+	cArchetype* source = record->pArchetype;
+	cArchetype* target = getArchetype( _newMask );
+
+	const uint32_t sourceRow = record->row;
+	const uint32_t targetRow = target->add( _entity );
+	target->copyShared( targetRow, source, sourceRow );
+
+	hEntity moved = source->remove( sourceRow );
+	if ( moved.isValid() )
+		m_records[ entityIndex( moved ) ].row = sourceRow;
+
+	record->pArchetype = target;
+	record->row = targetRow;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void* wv::cEntityWorld::getComponent( hEntity _entity, uint32_t _id )
+{
+	sEntityRecord* record = getRecord( _entity );
+	if ( !record )
+		return nullptr;
+
+	cArchetype* archetype = record->pArchetype;
+	if ( !archetype->hasComponent( _id ) )
+		return nullptr;
+
+	const uint32_t capacity = archetype->getChunkCapacity();
+	const uint32_t chunk = record->row / capacity;
+	const uint32_t index = record->row % capacity;
+
+	return (uint8_t*)archetype->getComponents( chunk, _id ) + index * Component::getInfo( _id ).size;
+}
@@ -0,0 +1,214 @@
+#pragma once
+
+#include <wv/Entity/Entity.h>
+#include <wv/Entity/Archetype.h>
+#include <wv/Thread/TaskScheduler.h>
+
+#include <stdint.h>
+#include <vector>
+#include <unordered_map>
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+namespace wv
+{
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	/// <summary>
+	/// Archetype based entity storage. Entities with the same set of components share an 
+	/// archetype and are iterated chunk by chunk in memory order.
+	/// 
+	/// Adding or removing components, creating or destroying entities moves rows around, 
+	/// so component pointers are only valid until the next structural change.
+	/// Not thread safe, structural changes must happen on one thread
+	/// </summary>
+	class cEntityWorld
+	{
+	public:
+		cEntityWorld();
+		~cEntityWorld();
+
+		hEntity createEntity( ComponentMask _mask );
+		void    destroyEntity( hEntity& _entity );
+		
+		template<typename... Ts>
+		hEntity createEntity() { return createEntity( Component::getMask<Ts...>() ); }
+
+		bool isAlive( hEntity _entity );
+
+		/// <summary>
+		/// Destroys every entity and frees all chunks
+		/// </summary>
+		void clear();
+
+		uint32_t getNumEntities()   { return m_numEntities; }
+		uint32_t getNumArchetypes() { return (uint32_t)m_archetypes.size(); }
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+		template<typename T> T*   getComponent   ( hEntity _entity );
+		template<typename T> bool hasComponent   ( hEntity _entity );
+		template<typename T> T*   addComponent   ( hEntity _entity, const T& _value = T{} );
+		template<typename T> void removeComponent( hEntity _entity );
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+		/// <summary>
+		/// Calls _func( count, entities, Ts*... ) for every chunk that has all of Ts
+		/// </summary>
+		template<typename... Ts, typename F> void eachChunk( F&& _func );
+		
+		/// <summary>
+		/// Calls _func( entity, Ts&... ) for every entity that has all of Ts
+		/// </summary>
+		template<typename... Ts, typename F> void each( F&& _func );
+
+		/// <summary>
+		/// Same as eachChunk but chunks are spread over the worker pool.
+		/// _func must only touch the chunk it is given
+		/// </summary>
+		template<typename... Ts, typename F> void parallelEachChunk( cTaskScheduler* _pTaskScheduler, F&& _func );
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	private:
+
+		struct sEntityRecord
+		{
+			cArchetype* pArchetype = nullptr;
+			uint32_t    row        = 0;
+			uint32_t    generation = 0;
+		};
+
+		struct sChunkRef
+		{
+			cArchetype* pArchetype;
+			uint32_t    chunk;
+		};
+
+		sEntityRecord* getRecord( hEntity _entity );
+		cArchetype*    getArchetype( ComponentMask _mask );
+		void           moveEntity( hEntity _entity, ComponentMask _newMask );
+		void*          getComponent( hEntity _entity, uint32_t _id );
+
+		template<typename F> 
+		static void parallelChunkJob( void* _pUserData, uint32_t _index );
+
+		std::vector<sEntityRecord> m_records;
+		std::vector<uint32_t>      m_freeIndices;
+		uint32_t m_numEntities = 0;
+
+		std::vector<cArchetype*> m_archetypes;
+		std::unordered_map<ComponentMask, cArchetype*> m_archetypeMap;
+
+		std::vector<sChunkRef> m_parallelChunks;
+	};
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	template<typename T>
+	inline T* cEntityWorld::getComponent( hEntity _entity )
+	{
+		return (T*)getComponent( _entity, Component::getID<T>() );
+	}
+
+	template<typename T>
+	inline bool cEntityWorld::hasComponent( hEntity _entity )
+	{
+		sEntityRecord* record = getRecord( _entity );
+		return record && record->pArchetype->hasComponent( Component::getID<T>() );
+	}
+
+	template<typename T>
+	inline T* cEntityWorld::addComponent( hEntity _entity, const T& _value )
+	{
+		sEntityRecord* record = getRecord( _entity );
+		if ( !record )
+			return nullptr;
+
+		moveEntity( _entity, record->pArchetype->getMask() | Component::getMask<T>() );
+		
+		T* component = getComponent<T>( _entity );
+		*component = _value;
+		return component;
+	}
+
+	template<typename T>
+	inline void cEntityWorld::removeComponent( hEntity _entity )
+	{
+		sEntityRecord* record = getRecord( _entity );
+		if ( !record )
+			return;
+
+		moveEntity( _entity, record->pArchetype->getMask() & ~Component::getMask<T>() );
+	}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	template<typename... Ts, typename F>
+	inline void cEntityWorld::eachChunk( F&& _func )
+	{
+		const ComponentMask mask = Component::getMask<Ts...>();
+		
+		for ( cArchetype* archetype : m_archetypes )
+		{
+			if ( ( archetype->getMask() & mask ) != mask )
+				continue;
+
+			for ( uint32_t c = 0; c < archetype->getNumChunks(); c++ )
+				_func( archetype->getChunk( c ).count, archetype->getEntities( c ), archetype->template getComponents<Ts>( c )... );
+		}
+	}
+
+	template<typename... Ts, typename F>
+	inline void cEntityWorld::each( F&& _func )
+	{
+		eachChunk<Ts...>( [ & ]( uint32_t _count, hEntity* _pEntities, Ts*... _pComponents )
+			{
+				for ( uint32_t i = 0; i < _count; i++ )
+					_func( _pEntities[ i ], _pComponents[ i ]... );
+			} );
+	}
+
+	template<typename... Ts, typename F>
+	inline void cEntityWorld::parallelEachChunk( cTaskScheduler* _pTaskScheduler, F&& _func )
+	{
+		const ComponentMask mask = Component::getMask<Ts...>();
+		
+		m_parallelChunks.clear();
+		for ( cArchetype* archetype : m_archetypes )
+		{
+			if ( ( archetype->getMask() & mask ) != mask )
+				continue;
+
+			for ( uint32_t c = 0; c < archetype->getNumChunks(); c++ )
+				m_parallelChunks.push_back( { archetype, c } );
+		}
+
+		if ( m_parallelChunks.empty() )
+			return;
+
+		auto job = [ & ]( uint32_t _index )
+			{
+				sChunkRef& ref = m_parallelChunks[ _index ];
+				_func( ref.pArchetype->getChunk( ref.chunk ).count, ref.pArchetype->getEntities( ref.chunk ), ref.pArchetype->template getComponents<Ts>( ref.chunk )... );
+			};
+
+		if ( !_pTaskScheduler )
+		{
+			for ( uint32_t i = 0; i < (uint32_t)m_parallelChunks.size(); i++ )
+				job( i );
+			return;
+		}
+
+		_pTaskScheduler->parallelFor( (uint32_t)m_parallelChunks.size(), parallelChunkJob<decltype( job )>, &job );
+	}
+
+	template<typename F>
+	inline void cEntityWorld::parallelChunkJob( void* _pUserData, uint32_t _index )
+	{
+		( *(F*)_pUserData )( _index );
+	}
+
+}
@@ -0,0 +1,62 @@
+#include "DynamicResolution.h"
+
+#include <math.h>
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+// smoothing of the measured frame time
+#define WV_DYNRES_SMOOTHING 0.1
+
+// relative to the target frame time
+#define WV_DYNRES_SPIKE_THRESHOLD    1.2
+#define WV_DYNRES_INCREASE_THRESHOLD 0.85
+
+#define WV_DYNRES_DECREASE_RATE 0.5f
+#define WV_DYNRES_INCREASE_RATE 0.05f
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+wv::cDynamicResolution::cDynamicResolution( const sDynamicResolutionDesc& _desc ) :
+	m_desc{ _desc },
+	m_scale{ _desc.maxScale }
+{
+
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cDynamicResolution::update( double _cpuTime, double _gpuTime )
+{
+	m_cpuTime = _cpuTime;
+	m_gpuTime = _gpuTime;
+
+	// the render scale only affects the GPU side, the CPU time is a fallback
+	// for when there is no timer available
+	double frameTime = _gpuTime >= 0.0 ? _gpuTime : _cpuTime;
+	if ( frameTime <= 0.0 )
+		return;
+
+	if ( m_frameTime <= 0.0 )
+		m_frameTime = frameTime;
+	else
+		m_frameTime += ( frameTime - m_frameTime ) * WV_DYNRES_SMOOTHING;
+
+	if ( !m_desc.enabled || m_desc.targetFrameTime <= 0.0 )
+		return;
+
+	const double target = m_desc.targetFrameTime;
+	
+	// react to the raw frame time on spikes, the smoothed one otherwise
+	double measured = frameTime > target * WV_DYNRES_SPIKE_THRESHOLD ? frameTime : m_frameTime;
+
+	// cost is assumed to scale with the pixel count
+	float desired = m_scale * (float)sqrt( target / measured );
+
+	if ( measured > target )
+		m_scale += ( desired - m_scale ) * WV_DYNRES_DECREASE_RATE;
+	else if ( measured < target * WV_DYNRES_INCREASE_THRESHOLD )
+		m_scale += ( desired - m_scale ) * WV_DYNRES_INCREASE_RATE;
+
+	if ( m_scale < m_desc.minScale ) m_scale = m_desc.minScale;
+	if ( m_scale > m_desc.maxScale ) m_scale = m_desc.maxScale;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+namespace wv
+{
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	struct sDynamicResolutionDesc
+	{
+		bool enabled = false;
+
+		// seconds of CPU or GPU time a frame is allowed to take
+		double targetFrameTime = 1.0 / 60.0;
+
+		float minScale = 0.5f;
+		float maxScale = 1.0f;
+	};
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	/// <summary>
+	/// Steers the render scale towards the frame time budget. 
+	/// Scales down immediately on spikes and recovers slowly 
+	/// </summary>
+	class cDynamicResolution
+	{
+	public:
+		cDynamicResolution( const sDynamicResolutionDesc& _desc );
+
+		/// <summary>
+		/// _gpuTime is ignored if negative
+		/// </summary>
+		void update( double _cpuTime, double _gpuTime );
+
+		float  getScale()     { return m_desc.enabled ? m_scale : 1.0f; }
+		double getFrameTime() { return m_frameTime; }
+		double getCPUTime()   { return m_cpuTime; }
+		double getGPUTime()   { return m_gpuTime; }
+
+		void setEnabled( bool _enabled ) { m_desc.enabled = _enabled; }
+		bool isEnabled() { return m_desc.enabled; }
+
+		sDynamicResolutionDesc& getDesc() { return m_desc; }
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	private:
+
+		sDynamicResolutionDesc m_desc;
+
+		float m_scale = 1.0f;
+
+		double m_frameTime = 0.0;
+		double m_cpuTime = 0.0;
+		double m_gpuTime = -1.0;
+	};
+
+}
@@ -0,0 +1,403 @@
+#include "OcclusionCuller.h"
+
+#include <wv/Primitive/Mesh.h>
+#include <wv/Thread/TaskScheduler.h>
+
+#include <math.h>
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#define WV_OCCLUSION_SSE
+#include <emmintrin.h>
+#endif
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+wv::cOcclusionCuller::cOcclusionCuller( cTaskScheduler* _pTaskScheduler, int _width, int _height ) :
+	m_pTaskScheduler{ _pTaskScheduler },
+	m_width { ( _width + 3 ) & ~3 }, // rows are processed four pixels at a time
+	m_height{ _height }
+{
+	m_depth.resize( m_width * m_height, 1.0f );
+
+	int w = m_width;
+	int h = m_height;
+	while ( true )
+	{
+		m_hierarchyWidth.push_back( w );
+		m_hierarchyHeight.push_back( h );
+		m_hierarchy.push_back( std::vector<float>( w * h, 1.0f ) );
+
+		if ( w == 1 && h == 1 )
+			break;
+
+		w = ( w + 1 ) / 2;
+		h = ( h + 1 ) / 2;
+	}
+
+	int numWorkers = m_pTaskScheduler ? m_pTaskScheduler->getNumWorkers() : 0;
+	m_numBands = ( numWorkers + 1 ) * 2;
+	if ( m_numBands > m_height / 4 )
+		m_numBands = m_height / 4;
+	if ( m_numBands < 1 )
+		m_numBands = 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cOcclusionCuller::beginFrame( const cMatrix4x4f& _viewProjection )
+{
+	m_viewProjection = _viewProjection;
+	m_triangles.clear();
+	m_hasOccluders = false;
+	m_stats = {};
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cOcclusionCuller::addOccluder( sMesh* _pMesh )
+{
+	addOccluder( _pMesh->triangles, _pMesh->transform.getMatrix() );
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cOcclusionCuller::addOccluder( const std::vector<Triangle3f>& _triangles, const cMatrix4x4f& _model )
+{
+	if ( !enabled )
+		return;
+
+	cMatrix4x4f mvp = _model * m_viewProjection;
+
+	for ( auto& triangle : _triangles )
+	{
+		const cVector4f c0 = Matrix::projectPoint( mvp, triangle.v0 );
+		const cVector4f c1 = Matrix::projectPoint( mvp, triangle.v1 );
+		const cVector4f c2 = Matrix::projectPoint( mvp, triangle.v2 );
+
+		sClipVertex in[ 3 ] = {
+			{ c0.x, c0.y, c0.z, c0.w },
+			{ c1.x, c1.y, c1.z, c1.w },
+			{ c2.x, c2.y, c2.z, c2.w }
+		};
+
+		// clip against the near plane, z + w >= 0
+		sClipVertex out[ 4 ];
+		int numOut = 0;
+
+		for ( int i = 0; i < 3; i++ )
+		{
+			const sClipVertex& a = in[ i ];
+			const sClipVertex& b = in[ ( i + 1 ) % 3 ];
+			float da = a.z + a.w;
+			float db = b.z + b.w;
+
+			if ( da >= 0.0f )
+				out[ numOut++ ] = a;
+
+			if ( ( da >= 0.0f ) != ( db >= 0.0f ) )
+			{
+				float t = da / ( da - db );
+				out[ numOut++ ] = {
+					a.x + ( b.x - a.x ) * t,
+					a.y + ( b.y - a.y ) * t,
+					a.z + ( b.z - a.z ) * t,
+					a.w + ( b.w - a.w ) * t
+				};
+			}
+		}
+
+		for ( int i = 2; i < numOut; i++ )
+			setupTriangle( out[ 0 ], out[ i - 1 ], out[ i ] );
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cOcclusionCuller::setupTriangle( const sClipVertex& _v0, const sClipVertex& _v1, const sClipVertex& _v2 )
+{
+	float sx[ 3 ], sy[ 3 ], sz[ 3 ];
+	const sClipVertex* v[ 3 ] = { &_v0, &_v1, &_v2 };
+
+	for ( int i = 0; i < 3; i++ )
+	{
+		if ( v[ i ]->w <= 0.00001f )
+			return;
+
+		float invW = 1.0f / v[ i ]->w;
+		sx[ i ] = ( v[ i ]->x * invW * 0.5f + 0.5f ) * (float)m_width;
+		sy[ i ] = ( 0.5f - v[ i ]->y * invW * 0.5f ) * (float)m_height;
+		sz[ i ] = v[ i ]->z * invW * 0.5f + 0.5f;
+	}
+
+	float area = ( sx[ 1 ] - sx[ 0 ] ) * ( sy[ 2 ] - sy[ 0 ] ) - ( sx[ 2 ] - sx[ 0 ] ) * ( sy[ 1 ] - sy[ 0 ] );
+	if ( fabsf( area ) < 0.0001f )
+		return;
+
+	// both windings are rasterized, flip to keep the edge functions positive inside
+	if ( area < 0.0f )
+	{
+		float t;
+		t = sx[ 1 ]; sx[ 1 ] = sx[ 2 ]; sx[ 2 ] = t;
+		t = sy[ 1 ]; sy[ 1 ] = sy[ 2 ]; sy[ 2 ] = t;
+		t = sz[ 1 ]; sz[ 1 ] = sz[ 2 ]; sz[ 2 ] = t;
+		area = -area;
+	}
+
+	if ( sz[ 0 ] > 1.0f && sz[ 1 ] > 1.0f && sz[ 2 ] > 1.0f )
+		return;
+
+	sOccluderTriangle tri;
+	tri.minX = (int)floorf( fminf( sx[ 0 ], fminf( sx[ 1 ], sx[ 2 ] ) ) );
+	tri.maxX = (int)ceilf ( fmaxf( sx[ 0 ], fmaxf( sx[ 1 ], sx[ 2 ] ) ) );
+	tri.minY = (int)floorf( fminf( sy[ 0 ], fminf( sy[ 1 ], sy[ 2 ] ) ) );
+	tri.maxY = (int)ceilf ( fmaxf( sy[ 0 ], fmaxf( sy[ 1 ], sy[ 2 ] ) ) );
+
+	tri.minX = tri.minX < 0 ? 0 : tri.minX;
+	tri.minY = tri.minY < 0 ? 0 : tri.minY;
+	tri.maxX = tri.maxX > m_width  - 1 ? m_width  - 1 : tri.maxX;
+	tri.maxY = tri.maxY > m_height - 1 ? m_height - 1 : tri.maxY;
+
+	if ( tri.minX > tri.maxX || tri.minY > tri.maxY )
+		return;
+
+	for ( int i = 0; i < 3; i++ )
+	{
+		int a = i;
+		int b = ( i + 1 ) % 3;
+		tri.edgeA[ i ] = sy[ a ] - sy[ b ];
+		tri.edgeB[ i ] = sx[ b ] - sx[ a ];
+		tri.edgeC[ i ] = -( tri.edgeA[ i ] * sx[ a ] + tri.edgeB[ i ] * sy[ a ] );
+	}
+
+	// barycentrics, v1 is weighted by edge 2->0 and v2 by edge 0->1
+	float invArea = 1.0f / area;
+	float dz1 = ( sz[ 1 ] - sz[ 0 ] ) * invArea;
+	float dz2 = ( sz[ 2 ] - sz[ 0 ] ) * invArea;
+	tri.depthA = tri.edgeA[ 2 ] * dz1 + tri.edgeA[ 0 ] * dz2;
+	tri.depthB = tri.edgeB[ 2 ] * dz1 + tri.edgeB[ 0 ] * dz2;
+	tri.depthC = tri.edgeC[ 2 ] * dz1 + tri.edgeC[ 0 ] * dz2 + sz[ 0 ];
+
+	m_triangles.push_back( tri );
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cOcclusionCuller::rasterizeOccluders()
+{
+	m_stats.numOccluderTriangles = (uint32_t)m_triangles.size();
+	m_hasOccluders = enabled && !m_triangles.empty();
+	
+	if ( !m_hasOccluders )
+		return;
+
+	for ( auto& depth : m_depth )
+		depth = 1.0f;
+
+	if ( m_pTaskScheduler )
+		m_pTaskScheduler->parallelFor( m_numBands, rasterizeBandJob, this );
+	else
+		rasterizeBand( 0, m_height );
+
+	buildHierarchy();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cOcclusionCuller::rasterizeBandJob( void* _pUserData, uint32_t _band )
+{
+	cOcclusionCuller* culler = (cOcclusionCuller*)_pUserData;
+	
+	int bandHeight = ( culler->m_height + culler->m_numBands - 1 ) / culler->m_numBands;
+	int minY = (int)_band * bandHeight;
+	int maxY = minY + bandHeight;
+	if ( maxY > culler->m_height )
+		maxY = culler->m_height;
+
+	culler->rasterizeBand( minY, maxY );
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cOcclusionCuller::rasterizeBand( int _minY, int _maxY )
+{
+	for ( auto& tri : m_triangles )
+	{
+		int y0 = tri.minY > _minY ? tri.minY : _minY;
+		int y1 = tri.maxY < _maxY - 1 ? tri.maxY : _maxY - 1;
+		int x0 = tri.minX & ~3;
+
+		for ( int y = y0; y <= y1; y++ )
+		{
+			float  py  = (float)y + 0.5f;
+			float* row = &m_depth[ y * m_width ];
+
+			float rowE0 = tri.edgeB[ 0 ] * py + tri.edgeC[ 0 ];
+			float rowE1 = tri.edgeB[ 1 ] * py + tri.edgeC[ 1 ];
+			float rowE2 = tri.edgeB[ 2 ] * py + tri.edgeC[ 2 ];
+			float rowZ  = tri.depthB     * py + tri.depthC;
+
+		#ifdef WV_OCCLUSION_SSE
+			const __m128 offset = _mm_setr_ps( 0.5f, 1.5f, 2.5f, 3.5f );
+			const __m128 zero   = _mm_setzero_ps();
+			
+			for ( int x = x0; x <= tri.maxX; x += 4 )
+			{
+				__m128 px = _mm_add_ps( _mm_set1_ps( (float)x ), offset );
+
+				__m128 e0 = _mm_add_ps( _mm_mul_ps( _mm_set1_ps( tri.edgeA[ 0 ] ), px ), _mm_set1_ps( rowE0 ) );
+				__m128 e1 = _mm_add_ps( _mm_mul_ps( _mm_set1_ps( tri.edgeA[ 1 ] ), px ), _mm_set1_ps( rowE1 ) );
+				__m128 e2 = _mm_add_ps( _mm_mul_ps( _mm_set1_ps( tri.edgeA[ 2 ] ), px ), _mm_set1_ps( rowE2 ) );
+
+				__m128 mask = _mm_and_ps( _mm_cmpge_ps( e0, zero ), _mm_and_ps( _mm_cmpge_ps( e1, zero ), _mm_cmpge_ps( e2, zero ) ) );
+				if ( _mm_movemask_ps( mask ) == 0 )
+					continue;
+
+				__m128 z = _mm_add_ps( _mm_mul_ps( _mm_set1_ps( tri.depthA ), px ), _mm_set1_ps( rowZ ) );
+				z = _mm_max_ps( z, zero );
+
+				__m128 current = _mm_loadu_ps( row + x );
+				__m128 nearest = _mm_min_ps( current, z );
+				_mm_storeu_ps( row + x, _mm_or_ps( _mm_and_ps( mask, nearest ), _mm_andnot_ps( mask, current ) ) );
+			}
+		#else
+			for ( int x = x0; x <= tri.maxX; x++ )
+			{
+				float px = (float)x + 0.5f;
+
+				if ( tri.edgeA[ 0 ] * px + rowE0 < 0.0f ||
+					 tri.edgeA[ 1 ] * px + rowE1 < 0.0f ||
+					 tri.edgeA[ 2 ] * px + rowE2 < 0.0f )
+					continue;
+
+				float z = tri.depthA * px + rowZ;
+				z = z < 0.0f ? 0.0f : z;
+
+				if ( z < row[ x ] )
+					row[ x ] = z;
+			}
+		#endif
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cOcclusionCuller::buildHierarchy()
+{
+	m_hierarchy[ 0 ] = m_depth;
+
+	for ( size_t level = 1; level < m_hierarchy.size(); level++ )
+	{
+		const std::vector<float>& src = m_hierarchy[ level - 1 ];
+		std::vector<float>& dst = m_hierarchy[ level ];
+		
+		int srcWidth  = m_hierarchyWidth [ level - 1 ];
+		int srcHeight = m_hierarchyHeight[ level - 1 ];
+		int dstWidth  = m_hierarchyWidth [ level ];
+		int dstHeight = m_hierarchyHeight[ level ];
+
+		for ( int y = 0; y < dstHeight; y++ )
+		{
+			int sy0 = y * 2;
+			int sy1 = sy0 + 1 < srcHeight ? sy0 + 1 : sy0;
+
+			for ( int x = 0; x < dstWidth; x++ )
+			{
+				int sx0 = x * 2;
+				int sx1 = sx0 + 1 < srcWidth ? sx0 + 1 : sx0;
+
+				float d = src[ sy0 * srcWidth + sx0 ];
+				d = fmaxf( d, src[ sy0 * srcWidth + sx1 ] );
+				d = fmaxf( d, src[ sy1 * srcWidth + sx0 ] );
+				d = fmaxf( d, src[ sy1 * srcWidth + sx1 ] );
+				dst[ y * dstWidth + x ] = d;
+			}
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+bool wv::cOcclusionCuller::isVisible( const cBoundingBoxf& _bounds, const cMatrix4x4f& _model )
+{
+	if ( !_bounds.isValid() )
+		return true;
+
+	m_stats.numTested++;
+
+	cMatrix4x4f mvp = _model * m_viewProjection;
+
+	int   outsideAll = 0x3F;
+	bool  behindNear = false;
+	float minX =  1e30f, minY =  1e30f, minZ =  1e30f;
+	float maxX = -1e30f, maxY = -1e30f;
+
+	for ( int i = 0; i < 8; i++ )
+	{
+		const cVector4f corner = Matrix::projectPoint( mvp, _bounds.getCorner( i ) );
+		const float* c = &corner.x;
+
+		int outside = 0;
+		outside |= ( c[ 0 ] < -c[ 3 ] ) << 0;
+		outside |= ( c[ 0 ] >  c[ 3 ] ) << 1;
+		outside |= ( c[ 1 ] < -c[ 3 ] ) << 2;
+		outside |= ( c[ 1 ] >  c[ 3 ] ) << 3;
+		outside |= ( c[ 2 ] < -c[ 3 ] ) << 4;
+		outside |= ( c[ 2 ] >  c[ 3 ] ) << 5;
+		outsideAll &= outside;
+
+		if ( c[ 3 ] <= 0.00001f )
+		{
+			behindNear = true;
+			continue;
+		}
+
+		float invW = 1.0f / c[ 3 ];
+		float sx = ( c[ 0 ] * invW * 0.5f + 0.5f ) * (float)m_width;
+		float sy = ( 0.5f - c[ 1 ] * invW * 0.5f ) * (float)m_height;
+		float sz = c[ 2 ] * invW * 0.5f + 0.5f;
+
+		minX = fminf( minX, sx ); maxX = fmaxf( maxX, sx );
+		minY = fminf( minY, sy ); maxY = fmaxf( maxY, sy );
+		minZ = fminf( minZ, sz );
+	}
+
+	if ( outsideAll != 0 )
+	{
+		m_stats.numFrustumCulled++;
+		return false;
+	}
+
+	// crossing the near plane, nothing sensible to test against
+	if ( behindNear || !enabled || !m_hasOccluders )
+		return true;
+
+	int x0 = (int)floorf( minX ); x0 = x0 < 0 ? 0 : x0;
+	int y0 = (int)floorf( minY ); y0 = y0 < 0 ? 0 : y0;
+	int x1 = (int)floorf( maxX ); x1 = x1 > m_width  - 1 ? m_width  - 1 : x1;
+	int y1 = (int)floorf( maxY ); y1 = y1 > m_height - 1 ? m_height - 1 : y1;
+
+	if ( x0 > x1 || y0 > y1 )
+		return true;
+
+	// pick the level where the rect covers at most 4x4 texels
+	int level = 0;
+	while ( level < (int)m_hierarchy.size() - 1 && 
+		( ( x1 >> level ) - ( x0 >> level ) > 3 || ( y1 >> level ) - ( y0 >> level ) > 3 ) )
+		level++;
+
+	const std::vector<float>& depth = m_hierarchy[ level ];
+	int width = m_hierarchyWidth[ level ];
+
+	for ( int y = y0 >> level; y <= ( y1 >> level ); y++ )
+	{
+		for ( int x = x0 >> level; x <= ( x1 >> level ); x++ )
+		{
+			if ( depth[ y * width + x ] >= minZ )
+				return true;
+		}
+	}
+
+	m_stats.numOcclusionCulled++;
+	return false;
+}
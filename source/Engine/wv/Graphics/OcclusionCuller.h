@@ -0,0 +1,117 @@
+#pragma once
+
+#include <wv/Math/Matrix.h>
+#include <wv/Math/BoundingBox.h>
+#include <wv/Math/Triangle.h>
+
+#include <stdint.h>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+namespace wv
+{
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	class cTaskScheduler;
+	struct sMesh;
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	struct sOcclusionCullingStats
+	{
+		uint32_t numOccluderTriangles = 0;
+		uint32_t numTested            = 0;
+		uint32_t numFrustumCulled     = 0;
+		uint32_t numOcclusionCulled   = 0;
+	};
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	/// <summary>
+	/// Software occlusion culler. Occluders are rasterized into a small CPU depth buffer
+	/// which is reduced into a hierarchical max-depth buffer. Bounding boxes are tested 
+	/// against the frustum and then against the hierarchy.
+	/// 
+	/// Nothing in here touches the graphics device
+	/// </summary>
+	class cOcclusionCuller
+	{
+	public:
+		cOcclusionCuller( cTaskScheduler* _pTaskScheduler, int _width = 256, int _height = 128 );
+
+		void beginFrame( const cMatrix4x4f& _viewProjection );
+
+		/// <summary>
+		/// Adds the triangles of a mesh, using the current world matrix of the mesh transform
+		/// </summary>
+		void addOccluder( sMesh* _pMesh );
+		void addOccluder( const std::vector<Triangle3f>& _triangles, const cMatrix4x4f& _model );
+
+		/// <summary>
+		/// Rasterizes all occluders added this frame and builds the depth hierarchy
+		/// </summary>
+		void rasterizeOccluders();
+
+		bool isVisible( const cBoundingBoxf& _bounds, const cMatrix4x4f& _model );
+
+		int getWidth()  { return m_width; }
+		int getHeight() { return m_height; }
+
+		const float* getDepthBuffer() { return m_depth.data(); }
+		sOcclusionCullingStats getStats() { return m_stats; }
+
+		// only turns off the depth test, isVisible still culls against the frustum
+		bool enabled = true;
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	private:
+
+		struct sOccluderTriangle
+		{
+			int minX, minY, maxX, maxY;
+			
+			// edge functions, e( x, y ) = a * x + b * y + c
+			float edgeA[ 3 ];
+			float edgeB[ 3 ];
+			float edgeC[ 3 ];
+			
+			// depth plane, z( x, y ) = a * x + b * y + c
+			float depthA, depthB, depthC;
+		};
+
+		struct sClipVertex
+		{
+			float x, y, z, w;
+		};
+
+		static void rasterizeBandJob( void* _pUserData, uint32_t _band );
+
+		void setupTriangle( const sClipVertex& _v0, const sClipVertex& _v1, const sClipVertex& _v2 );
+		void rasterizeBand( int _minY, int _maxY );
+		void buildHierarchy();
+
+		cTaskScheduler* m_pTaskScheduler = nullptr;
+
+		int m_width  = 0;
+		int m_height = 0;
+		int m_numBands = 1;
+
+		cMatrix4x4f m_viewProjection{ 1.0f };
+		
+		std::vector<sOccluderTriangle> m_triangles;
+		std::vector<float> m_depth;
+		
+		// max depth per texel, level 0 is full resolution
+		std::vector<std::vector<float>> m_hierarchy;
+		std::vector<int> m_hierarchyWidth;
+		std::vector<int> m_hierarchyHeight;
+
+		bool m_hasOccluders = false;
+
+		sOcclusionCullingStats m_stats;
+	};
+
+}
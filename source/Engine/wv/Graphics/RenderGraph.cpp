@@ -0,0 +1,483 @@
+#include "RenderGraph.h"
+
+#include <wv/Device/GraphicsDevice.h>
+#include <wv/Graphics/CommandBuffer.h>
+#include <wv/RenderTarget/RenderTarget.h>
+
+#include <wv/Debug/Print.h>
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+wv::hRenderGraphResource wv::cRenderGraph::createTransientTarget( const std::string& _name, const sRenderGraphTargetDesc& _desc )
+{
+	sResource resource;
+	resource.name = _name;
+	resource.desc = _desc;
+	resource.isTransient = true;
+
+	m_resources.push_back( resource );
+	m_dirty = true;
+
+	return (hRenderGraphResource)( m_resources.size() - 1 );
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+wv::hRenderGraphResource wv::cRenderGraph::importTarget( const std::string& _name, RenderTarget* _pTarget, bool _isOutput )
+{
+	sResource resource;
+	resource.name = _name;
+	resource.pTarget = _pTarget;
+	resource.isOutput = _isOutput;
+
+	m_resources.push_back( resource );
+	m_dirty = true;
+
+	return (hRenderGraphResource)( m_resources.size() - 1 );
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cRenderGraph::setImportedTarget( hRenderGraphResource _resource, RenderTarget* _pTarget )
+{
+	if ( _resource >= m_resources.size() || m_resources[ _resource ].isTransient )
+	{
+		Debug::Print( Debug::WV_PRINT_ERROR, "Invalid imported render graph resource\n" );
+		return;
+	}
+
+	m_resources[ _resource ].pTarget = _pTarget;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+wv::hRenderPass wv::cRenderGraph::addPass( const sRenderPassDesc& _desc )
+{
+	if ( _desc.target >= m_resources.size() )
+	{
+		Debug::Print( Debug::WV_PRINT_ERROR, "Render pass '%s' has no valid target\n", _desc.name.c_str() );
+		return WV_RENDER_GRAPH_INVALID_HANDLE;
+	}
+
+	sPass pass;
+	pass.desc = _desc;
+
+	m_passes.push_back( pass );
+	m_dirty = true;
+
+	return (hRenderPass)( m_passes.size() - 1 );
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cRenderGraph::setPassEnabled( hRenderPass _pass, bool _enabled )
+{
+	if ( _pass >= m_passes.size() || m_passes[ _pass ].enabled == _enabled )
+		return;
+
+	m_passes[ _pass ].enabled = _enabled;
+	m_dirty = true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cRenderGraph::setOutputSize( int _width, int _height )
+{
+	if ( m_outputWidth == _width && m_outputHeight == _height )
+		return;
+
+	m_outputWidth  = _width;
+	m_outputHeight = _height;
+	m_dirty = true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cRenderGraph::execute( iGraphicsDevice* _pGraphicsDevice )
+{
+	if ( m_outputWidth <= 0 || m_outputHeight <= 0 )
+		return;
+
+	if ( m_dirty )
+		compile( _pGraphicsDevice );
+
+	RenderTarget* pBound = nullptr;
+	bool hasBound = false;
+
+	// targets that have been cleared and not drawn to since
+	std::vector<RenderTarget*> cleared;
+
+	for ( hRenderPass passIndex : m_executionOrder )
+	{
+		sRenderPassDesc& desc = m_passes[ passIndex ].desc;
+		RenderTarget* pTarget = m_resources[ desc.target ].pTarget;
+
+		if ( !hasBound || pTarget != pBound )
+		{
+			_pGraphicsDevice->setRenderTarget( pTarget );
+			pBound = pTarget;
+			hasBound = true;
+
+			if ( pTarget && m_resources[ desc.target ].desc.dynamicResolution )
+			{
+				Vector2i size = getViewportSize( desc.target );
+				_pGraphicsDevice->setViewport( size.x, size.y );
+			}
+		}
+
+		bool isCleared = false;
+		for ( size_t i = 0; i < cleared.size(); i++ )
+		{
+			if ( cleared[ i ] != pTarget )
+				continue;
+
+			isCleared = true;
+			break;
+		}
+
+		if ( ( desc.clearColor || desc.clearDepth ) && !isCleared )
+		{
+			_pGraphicsDevice->clearRenderTarget( desc.clearColor, desc.clearDepth );
+			cleared.push_back( pTarget );
+		}
+
+		if ( desc.execute.m_fptr )
+		{
+			desc.execute( this, _pGraphicsDevice, desc.pUserData );
+
+			for ( size_t i = 0; i < cleared.size(); i++ )
+			{
+				if ( cleared[ i ] != pTarget )
+					continue;
+
+				cleared.erase( cleared.begin() + i );
+				break;
+			}
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cRenderGraph::destroy( iGraphicsDevice* _pGraphicsDevice )
+{
+	_pGraphicsDevice->setRenderTarget( nullptr );
+
+	for ( size_t i = 0; i < m_pool.size(); i++ )
+	{
+		RenderTarget* pTarget = m_pool[ i ].pTarget;
+		RenderTarget* pDestroy = pTarget;
+		_pGraphicsDevice->destroyRenderTarget( &pDestroy );
+
+		delete[] pTarget->textures;
+		delete pTarget;
+	}
+
+	m_pool.clear();
+	m_executionOrder.clear();
+
+	for ( size_t i = 0; i < m_resources.size(); i++ )
+	{
+		if ( m_resources[ i ].isTransient )
+			m_resources[ i ].pTarget = nullptr;
+	}
+
+	m_dirty = true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+wv::RenderTarget* wv::cRenderGraph::getRenderTarget( hRenderGraphResource _resource )
+{
+	if ( _resource >= m_resources.size() )
+		return nullptr;
+
+	return m_resources[ _resource ].pTarget;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+wv::Vector2i wv::cRenderGraph::getViewportSize( hRenderGraphResource _resource )
+{
+	RenderTarget* pTarget = getRenderTarget( _resource );
+	if ( !pTarget )
+		return { 0, 0 };
+
+	if ( !m_resources[ _resource ].desc.dynamicResolution )
+		return { pTarget->width, pTarget->height };
+
+	Vector2i size{ (int)( (float)pTarget->width * m_resolutionScale ), (int)( (float)pTarget->height * m_resolutionScale ) };
+	if ( size.x < 1 ) size.x = 1;
+	if ( size.y < 1 ) size.y = 1;
+	if ( size.x > pTarget->width  ) size.x = pTarget->width;
+	if ( size.y > pTarget->height ) size.y = pTarget->height;
+
+	return size;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cRenderGraph::compile( iGraphicsDevice* _pGraphicsDevice )
+{
+	m_dirty = false;
+	m_executionOrder.clear();
+
+	const size_t numPasses = m_passes.size();
+	const size_t numResources = m_resources.size();
+
+	// order passes so that every pass runs after the passes writing what it reads
+	// passes writing to the same target keep their declaration order
+	std::vector<std::vector<hRenderPass>> dependents( numPasses );
+	std::vector<int> numDependencies( numPasses, 0 );
+
+	for ( size_t i = 0; i < numPasses; i++ )
+	{
+		if ( !m_passes[ i ].enabled )
+			continue;
+
+		const sRenderPassDesc& desc = m_passes[ i ].desc;
+
+		for ( size_t j = 0; j < numPasses; j++ )
+		{
+			if ( i == j || !m_passes[ j ].enabled )
+				continue;
+
+			hRenderGraphResource written = m_passes[ j ].desc.target;
+			bool dependsOn = ( j < i && written == desc.target );
+
+			for ( size_t r = 0; r < desc.reads.size() && !dependsOn; r++ )
+				dependsOn = desc.reads[ r ] == written;
+
+			if ( !dependsOn )
+				continue;
+
+			dependents[ j ].push_back( (hRenderPass)i );
+			numDependencies[ i ]++;
+		}
+	}
+
+	std::vector<hRenderPass> ordered;
+	std::vector<bool> scheduled( numPasses, false );
+	for ( ;; )
+	{
+		// lowest index first keeps the declaration order wherever possible
+		size_t next = numPasses;
+		for ( size_t i = 0; i < numPasses; i++ )
+		{
+			if ( m_passes[ i ].enabled && !scheduled[ i ] && numDependencies[ i ] == 0 )
+			{
+				next = i;
+				break;
+			}
+		}
+
+		if ( next == numPasses )
+			break;
+
+		scheduled[ next ] = true;
+		ordered.push_back( (hRenderPass)next );
+
+		for ( hRenderPass dependent : dependents[ next ] )
+			numDependencies[ dependent ]--;
+	}
+
+	for ( size_t i = 0; i < numPasses; i++ )
+	{
+		if ( m_passes[ i ].enabled && !scheduled[ i ] )
+		{
+			Debug::Print( Debug::WV_PRINT_ERROR, "Render graph has a cycle at pass '%s'\n", m_passes[ i ].desc.name.c_str() );
+			return;
+		}
+	}
+
+	// cull passes that nothing downstream reads from
+	std::vector<bool> needed( numResources, false );
+	std::vector<bool> alive( numPasses, false );
+	for ( size_t i = ordered.size(); i > 0; i-- )
+	{
+		const sRenderPassDesc& desc = m_passes[ ordered[ i - 1 ] ].desc;
+
+		if ( !desc.hasSideEffects && !m_resources[ desc.target ].isOutput && !needed[ desc.target ] )
+			continue;
+
+		alive[ ordered[ i - 1 ] ] = true;
+		for ( hRenderGraphResource read : desc.reads )
+			needed[ read ] = true;
+	}
+
+	for ( hRenderPass pass : ordered )
+	{
+		if ( alive[ pass ] )
+			m_executionOrder.push_back( pass );
+	}
+
+	// transient lifetimes
+	const uint32_t unused = WV_RENDER_GRAPH_INVALID_HANDLE;
+	std::vector<uint32_t> firstUse( numResources, unused );
+	std::vector<uint32_t> lastUse( numResources, unused );
+
+	for ( uint32_t i = 0; i < (uint32_t)m_executionOrder.size(); i++ )
+	{
+		const sRenderPassDesc& desc = m_passes[ m_executionOrder[ i ] ].desc;
+
+		std::vector<hRenderGraphResource> used = desc.reads;
+		used.push_back( desc.target );
+
+		for ( hRenderGraphResource resource : used )
+		{
+			if ( firstUse[ resource ] == unused )
+				firstUse[ resource ] = i;
+			lastUse[ resource ] = i;
+		}
+	}
+
+	// assign pooled targets, a target is returned to the pool after its last use
+	for ( size_t i = 0; i < m_pool.size(); i++ )
+	{
+		m_pool[ i ].inUse = false;
+		m_pool[ i ].referenced = false;
+	}
+
+	for ( size_t r = 0; r < numResources; r++ )
+	{
+		if ( m_resources[ r ].isTransient )
+			m_resources[ r ].pTarget = nullptr;
+	}
+
+	for ( uint32_t i = 0; i < (uint32_t)m_executionOrder.size(); i++ )
+	{
+		for ( size_t r = 0; r < numResources; r++ )
+		{
+			if ( m_resources[ r ].isTransient && firstUse[ r ] == i )
+				m_resources[ r ].pTarget = acquireTarget( _pGraphicsDevice, resolveDesc( m_resources[ r ].desc ) );
+		}
+
+		for ( size_t r = 0; r < numResources; r++ )
+		{
+			if ( m_resources[ r ].isTransient && lastUse[ r ] == i )
+				releaseTarget( m_resources[ r ].pTarget );
+		}
+	}
+
+	// anything not picked up this time is stale, most likely from a resize
+	bool destroyed = false;
+	for ( size_t i = 0; i < m_pool.size(); )
+	{
+		if ( m_pool[ i ].referenced )
+		{
+			i++;
+			continue;
+		}
+
+		if ( !destroyed )
+		{
+			// the device may still have the target bound
+			_pGraphicsDevice->setRenderTarget( nullptr );
+			destroyed = true;
+		}
+
+		RenderTarget* pTarget = m_pool[ i ].pTarget;
+		RenderTarget* pDestroy = pTarget;
+		_pGraphicsDevice->destroyRenderTarget( &pDestroy );
+
+		delete[] pTarget->textures;
+		delete pTarget;
+
+		m_pool.erase( m_pool.begin() + i );
+	}
+
+	Debug::Print( Debug::WV_PRINT_DEBUG, "Compiled render graph: %i/%i passes, %i render targets\n",
+				  (int)m_executionOrder.size(), (int)numPasses, (int)m_pool.size() );
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+bool wv::cRenderGraph::isCompatible( const sRenderGraphTargetDesc& _a, const sRenderGraphTargetDesc& _b )
+{
+	if ( _a.width != _b.width || _a.height != _b.height || _a.numTextures != _b.numTextures )
+		return false;
+
+	for ( int i = 0; i < _a.numTextures; i++ )
+	{
+		const TextureDesc& a = _a.textureDescs[ i ];
+		const TextureDesc& b = _b.textureDescs[ i ];
+
+		if ( a.channels != b.channels || a.format != b.format || a.filtering != b.filtering )
+			return false;
+	}
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+wv::sRenderGraphTargetDesc wv::cRenderGraph::resolveDesc( const sRenderGraphTargetDesc& _desc )
+{
+	sRenderGraphTargetDesc desc = _desc;
+
+	if ( desc.width <= 0 || desc.height <= 0 )
+	{
+		desc.width  = (int)( (float)m_outputWidth  * desc.scale );
+		desc.height = (int)( (float)m_outputHeight * desc.scale );
+	}
+
+	if ( desc.width  < 1 ) desc.width  = 1;
+	if ( desc.height < 1 ) desc.height = 1;
+
+	desc.scale = 1.0f;
+	return desc;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+wv::RenderTarget* wv::cRenderGraph::acquireTarget( iGraphicsDevice* _pGraphicsDevice, const sRenderGraphTargetDesc& _desc )
+{
+	for ( size_t i = 0; i < m_pool.size(); i++ )
+	{
+		if ( m_pool[ i ].inUse || !isCompatible( m_pool[ i ].desc, _desc ) )
+			continue;
+
+		m_pool[ i ].inUse = true;
+		m_pool[ i ].referenced = true;
+		return m_pool[ i ].pTarget;
+	}
+
+	sPooledTarget pooled;
+	pooled.desc = _desc;
+	pooled.inUse = true;
+	pooled.referenced = true;
+
+	RenderTargetDesc rtDesc;
+	rtDesc.width  = _desc.width;
+	rtDesc.height = _desc.height;
+	rtDesc.pTextureDescs = pooled.desc.textureDescs;
+	rtDesc.numTextures = _desc.numTextures;
+
+	wv::cCommandBuffer& buffer = _pGraphicsDevice->getCommandBuffer();
+	buffer.push( WV_GPUTASK_CREATE_RENDERTARGET, &pooled.pTarget, &rtDesc );
+	_pGraphicsDevice->submitCommandBuffer( buffer );
+	_pGraphicsDevice->executeCommandBuffer( buffer );
+
+	if ( !pooled.pTarget )
+	{
+		Debug::Print( Debug::WV_PRINT_ERROR, "Failed to create render graph target\n" );
+		return nullptr;
+	}
+
+	m_pool.push_back( pooled );
+	return pooled.pTarget;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cRenderGraph::releaseTarget( RenderTarget* _pTarget )
+{
+	for ( size_t i = 0; i < m_pool.size(); i++ )
+	{
+		if ( m_pool[ i ].pTarget != _pTarget )
+			continue;
+
+		m_pool[ i ].inUse = false;
+		return;
+	}
+}
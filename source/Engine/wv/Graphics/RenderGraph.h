@@ -0,0 +1,158 @@
+#pragma once
+
+#include <wv/Types.h>
+#include <wv/Texture/Texture.h>
+#include <wv/Memory/Function.h>
+#include <wv/Math/Vector2.h>
+
+#include <string>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+namespace wv
+{
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	class iGraphicsDevice;
+	class RenderTarget;
+	class cRenderGraph;
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	typedef uint32_t hRenderGraphResource;
+	typedef uint32_t hRenderPass;
+
+	#define WV_RENDER_GRAPH_INVALID_HANDLE 0xFFFFFFFF
+	#define WV_RENDER_GRAPH_MAX_TEXTURES   8
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	struct sRenderGraphTargetDesc
+	{
+		// size relative to the graph output size, ignored if width and height are set
+		float scale  = 1.0f;
+		int   width  = 0;
+		int   height = 0;
+
+		TextureDesc textureDescs[ WV_RENDER_GRAPH_MAX_TEXTURES ];
+		int numTextures = 0;
+
+		// allocated at full size, passes render into a viewport scaled by the resolution scale
+		bool dynamicResolution = false;
+	};
+
+	struct sRenderPassDesc
+	{
+		std::string name;
+
+		std::vector<hRenderGraphResource> reads;
+		hRenderGraphResource target = WV_RENDER_GRAPH_INVALID_HANDLE;
+
+		// only issued if the target has been drawn to since it was last cleared
+		bool clearColor = false;
+		bool clearDepth = false;
+
+		// passes with side effects are never culled
+		bool hasSideEffects = false;
+
+		// the graph keeps track of the bound target, passes should not change it
+
+		wv::Function<void, cRenderGraph*, iGraphicsDevice*, void*> execute;
+		void* pUserData = nullptr;
+	};
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	/// <summary>
+	/// Passes declare which targets they read and write. On compile the graph orders 
+	/// the passes, culls the ones that don't contribute to an output and assigns
+	/// transient targets to pooled render targets, sharing them between resources
+	/// with the same description whose lifetimes don't overlap.
+	/// </summary>
+	class cRenderGraph
+	{
+	public:
+
+		hRenderGraphResource createTransientTarget( const std::string& _name, const sRenderGraphTargetDesc& _desc );
+		hRenderGraphResource importTarget( const std::string& _name, RenderTarget* _pTarget, bool _isOutput );
+		void setImportedTarget( hRenderGraphResource _resource, RenderTarget* _pTarget );
+
+		hRenderPass addPass( const sRenderPassDesc& _desc );
+		void setPassEnabled( hRenderPass _pass, bool _enabled );
+
+		/// <summary>
+		/// Transient targets are resized on the next execute, 
+		/// any number of calls in between only cause one reallocation
+		/// </summary>
+		void setOutputSize( int _width, int _height );
+
+		void  setResolutionScale( float _scale ) { m_resolutionScale = _scale; }
+		float getResolutionScale()               { return m_resolutionScale; }
+		
+		void execute( iGraphicsDevice* _pGraphicsDevice );
+		void destroy( iGraphicsDevice* _pGraphicsDevice );
+
+		RenderTarget* getRenderTarget( hRenderGraphResource _resource );
+		
+		/// <summary>
+		/// The part of the target that is rendered to this frame
+		/// </summary>
+		Vector2i getViewportSize( hRenderGraphResource _resource );
+
+		int getNumPhysicalTargets() { return (int)m_pool.size(); }
+		int getNumExecutedPasses()  { return (int)m_executionOrder.size(); }
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	private:
+
+		struct sResource
+		{
+			std::string name;
+			sRenderGraphTargetDesc desc;
+			
+			bool isTransient = false;
+			bool isOutput    = false;
+			
+			RenderTarget* pTarget = nullptr; // imported or assigned from the pool
+		};
+
+		struct sPass
+		{
+			sRenderPassDesc desc;
+			bool enabled = true;
+		};
+
+		struct sPooledTarget
+		{
+			RenderTarget* pTarget = nullptr;
+			sRenderGraphTargetDesc desc;
+			bool inUse = false;
+			bool referenced = false;
+		};
+
+		void compile( iGraphicsDevice* _pGraphicsDevice );
+		
+		bool isCompatible( const sRenderGraphTargetDesc& _a, const sRenderGraphTargetDesc& _b );
+		sRenderGraphTargetDesc resolveDesc( const sRenderGraphTargetDesc& _desc );
+		
+		RenderTarget* acquireTarget( iGraphicsDevice* _pGraphicsDevice, const sRenderGraphTargetDesc& _desc );
+		void releaseTarget( RenderTarget* _pTarget );
+
+		std::vector<sResource> m_resources;
+		std::vector<sPass> m_passes;
+		std::vector<sPooledTarget> m_pool;
+
+		std::vector<hRenderPass> m_executionOrder;
+
+		int m_outputWidth  = 0;
+		int m_outputHeight = 0;
+
+		float m_resolutionScale = 1.0f;
+
+		bool m_dirty = true;
+	};
+
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <wv/Math/Vector3.h>
+
+#include <limits>
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+namespace wv
+{
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	template<typename T>
+	class cBoundingBox
+	{
+
+	public:
+
+		cVector3<T> min{  std::numeric_limits<T>::max(),  std::numeric_limits<T>::max(),  std::numeric_limits<T>::max() };
+		cVector3<T> max{ -std::numeric_limits<T>::max(), -std::numeric_limits<T>::max(), -std::numeric_limits<T>::max() };
+
+		bool isValid() const { return min.x <= max.x && min.y <= max.y && min.z <= max.z; }
+
+		cVector3<T> getCenter () const { return ( min + max ) * (T)0.5; }
+		cVector3<T> getExtents() const { return ( max - min ) * (T)0.5; }
+
+		cVector3<T> getCorner( int _index ) const
+		{
+			return {
+				( _index & 1 ) ? max.x : min.x,
+				( _index & 2 ) ? max.y : min.y,
+				( _index & 4 ) ? max.z : min.z
+			};
+		}
+
+		void expand( const cVector3<T>& _point );
+		void expand( const cBoundingBox<T>& _box );
+
+	};
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	typedef cBoundingBox<float>  cBoundingBoxf;
+	typedef cBoundingBox<double> cBoundingBoxd;
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	template<typename T>
+	inline void cBoundingBox<T>::expand( const cVector3<T>& _point )
+	{
+		min.x = _point.x < min.x ? _point.x : min.x;
+		min.y = _point.y < min.y ? _point.y : min.y;
+		min.z = _point.z < min.z ? _point.z : min.z;
+
+		max.x = _point.x > max.x ? _point.x : max.x;
+		max.y = _point.y > max.y ? _point.y : max.y;
+		max.z = _point.z > max.z ? _point.z : max.z;
+	}
+
+	template<typename T>
+	inline void cBoundingBox<T>::expand( const cBoundingBox<T>& _box )
+	{
+		if ( !_box.isValid() )
+			return;
+
+		expand( _box.min );
+		expand( _box.max );
+	}
+
+}
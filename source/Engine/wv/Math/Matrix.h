@@ -2,10 +2,12 @@
 
 #include <wv/Math/Vector3.h>
 #include <wv/Math/Vector4.h>
+#include <wv/Math/SIMD.h>
 
 #include <stdint.h>
 #include <type_traits>
 #include <array>
+#include <cstring>
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
@@ -25,11 +27,13 @@ namespace wv
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
-		T m[ R ][ C ];
+		// 16 byte aligned when the size allows it so 4x4 float rows can be loaded directly
+		alignas( ( sizeof( T ) * R * C ) % 16 == 0 ? 16 : alignof( T ) ) T m[ R ][ C ];
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
 		cMatrix( void ) : m{ 0 } { }
+		cMatrix( const cMatrix<T, R, C>& _o ) = default;
 		cMatrix( const T& _val ) :
 			m{ 0 }
 		{
@@ -91,20 +95,27 @@ namespace wv
 
 		auto res = _mat * tmpMat;
 		
-		return { res[ 1 ][ 0 ], res[ 1 ][ 0 ], res[ 2 ][ 0 ], res[ 3 ][ 0 ] };
+		return { res[ 0 ][ 0 ], res[ 1 ][ 0 ], res[ 2 ][ 0 ], res[ 3 ][ 0 ] };
 	}
 
 	template<typename T>
 	cVector4<T> operator * ( const cVector4<T>& _vec, const cMatrix<T, 4, 4>& _mat )
 	{
 		cMatrix<T, 1, 4> tmpMat{};
-		tmpMat.setRow( 0, { _vec.x, _vec.y, _vec.z, _vec.z } );
+		tmpMat.setRow( 0, { _vec.x, _vec.y, _vec.z, _vec.w } );
 		
 		auto res = tmpMat * _mat;
 
 		return { res[ 0 ][ 0 ], res[ 0 ][ 1 ], res[ 0 ][ 2 ], res[ 0 ][ 3 ] };
 	}
 
+	inline cVector4<float> operator * ( const cVector4<float>& _vec, const cMatrix<float, 4, 4>& _mat )
+	{
+		cVector4<float> res;
+		SIMD::transformVector4( &_mat.m[ 0 ][ 0 ], &_vec.x, &res.x );
+		return res;
+	}
+
 ///////////////////////////////////////////////////////////////////////////////////////
 
 	namespace Matrix
@@ -199,6 +210,74 @@ namespace wv
 			return res;
 		}
 
+		/// <summary>
+		/// Transforms a point ( w = 1 ) using the row vector convention, p * M
+		/// </summary>
+		template<typename T>
+		cVector3<T> transformPoint( const cMatrix<T, 4, 4>& _m, const cVector3<T>& _p )
+		{
+			return {
+				_p.x * _m.m[ 0 ][ 0 ] + _p.y * _m.m[ 1 ][ 0 ] + _p.z * _m.m[ 2 ][ 0 ] + _m.m[ 3 ][ 0 ],
+				_p.x * _m.m[ 0 ][ 1 ] + _p.y * _m.m[ 1 ][ 1 ] + _p.z * _m.m[ 2 ][ 1 ] + _m.m[ 3 ][ 1 ],
+				_p.x * _m.m[ 0 ][ 2 ] + _p.y * _m.m[ 1 ][ 2 ] + _p.z * _m.m[ 2 ][ 2 ] + _m.m[ 3 ][ 2 ]
+			};
+		}
+
+		/// <summary>
+		/// Like transformPoint but keeps w, for points going into clip space
+		/// </summary>
+		template<typename T>
+		cVector4<T> projectPoint( const cMatrix<T, 4, 4>& _m, const cVector3<T>& _p )
+		{
+			return cVector4<T>{ _p.x, _p.y, _p.z, T( 1 ) } * _m;
+		}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+		// float 4x4 overloads, picked over the generic templates above
+
+		inline cMatrix<float, 4, 4> multiply( const cMatrix<float, 4, 4>& _a, const cMatrix<float, 4, 4>& _b )
+		{
+			cMatrix<float, 4, 4> res;
+			SIMD::multiply4x4( &_a.m[ 0 ][ 0 ], &_b.m[ 0 ][ 0 ], &res.m[ 0 ][ 0 ] );
+			return res;
+		}
+
+		inline cMatrix<float, 4, 4> inverse( const cMatrix<float, 4, 4>& _m )
+		{
+		#ifdef WV_MATH_SSE
+			cMatrix<float, 4, 4> res;
+			SIMD::inverse4x4( &_m.m[ 0 ][ 0 ], &res.m[ 0 ][ 0 ] );
+			return res;
+		#else
+			return inverse<float>( _m );
+		#endif
+		}
+
+		inline cMatrix<float, 4, 4> transpose( const cMatrix<float, 4, 4>& _m )
+		{
+			cMatrix<float, 4, 4> res;
+			SIMD::transpose4x4( &_m.m[ 0 ][ 0 ], &res.m[ 0 ][ 0 ] );
+			return res;
+		}
+
+		inline cVector3<float> transformPoint( const cMatrix<float, 4, 4>& _m, const cVector3<float>& _p )
+		{
+			cVector3<float> res;
+			SIMD::transformPoint( &_m.m[ 0 ][ 0 ], &_p.x, &res.x );
+			return res;
+		}
+
+		inline cVector4<float> projectPoint( const cMatrix<float, 4, 4>& _m, const cVector3<float>& _p )
+		{
+			const float p[ 4 ] = { _p.x, _p.y, _p.z, 1.0f };
+			cVector4<float> res;
+			SIMD::transformVector4( &_m.m[ 0 ][ 0 ], p, &res.x );
+			return res;
+		}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
 		template<typename T>
 		cMatrix<T, 4, 4> translate( const cMatrix<T, 4, 4>& _m, const wv::cVector3<T>& _pos )
 		{
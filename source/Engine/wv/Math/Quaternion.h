@@ -28,6 +28,21 @@ namespace wv
 
 		static cQuaternion<T> fromAxisAngle( const cVector3<T>& _axis, const T& _angle );
 
+		/// <summary>
+		/// Rotation about x, then y, then z. Same order as Transform and JPH::Quat::sEulerAngles
+		/// </summary>
+		static cQuaternion<T> fromEuler( const cVector3<T>& _radians );
+
+		/// <summary>
+		/// Inverse of fromEuler, in radians. y is kept within [-pi/2, pi/2]
+		/// </summary>
+		cVector3<T> toEuler( void ) const;
+
+		/// <summary>
+		/// Normalized lerp along the shortest arc, close enough to slerp for small steps
+		/// </summary>
+		static cQuaternion<T> nlerp( const cQuaternion<T>& _a, const cQuaternion<T>& _b, const T& _t );
+
 		void normalize ( void );
 		void toUnitNorm( void );
 
@@ -90,6 +105,53 @@ namespace wv
 		return cQuaternion<T>( x, y, z, w ).normalized();
 	}
 
+	template<typename T>
+	inline cQuaternion<T> cQuaternion<T>::fromEuler( const cVector3<T>& _radians )
+	{
+		// closed form of z * y * x
+		T cx = std::cos( _radians.x / 2.0 ), sx = std::sin( _radians.x / 2.0 );
+		T cy = std::cos( _radians.y / 2.0 ), sy = std::sin( _radians.y / 2.0 );
+		T cz = std::cos( _radians.z / 2.0 ), sz = std::sin( _radians.z / 2.0 );
+
+		return cQuaternion<T>(
+			cz * cy * sx - sz * cx * sy,
+			cz * cx * sy + sz * cy * sx,
+			cx * cy * sz - cz * sx * sy,
+			cz * cx * cy + sz * sx * sy
+		);
+	}
+
+	template<typename T>
+	inline cVector3<T> cQuaternion<T>::toEuler() const
+	{
+		T sinY = 2 * ( s * v.y - v.z * v.x );
+		if( sinY >  1 ) sinY =  1;
+		if( sinY < -1 ) sinY = -1;
+
+		return cVector3<T>(
+			std::atan2( 2 * ( s * v.x + v.y * v.z ), 1 - 2 * ( v.x * v.x + v.y * v.y ) ),
+			std::asin( sinY ),
+			std::atan2( 2 * ( s * v.z + v.x * v.y ), 1 - 2 * ( v.y * v.y + v.z * v.z ) )
+		);
+	}
+
+	template<typename T>
+	inline cQuaternion<T> cQuaternion<T>::nlerp( const cQuaternion<T>& _a, const cQuaternion<T>& _b, const T& _t )
+	{
+		T dot = _a.v.x * _b.v.x + _a.v.y * _b.v.y + _a.v.z * _b.v.z + _a.s * _b.s;
+		T sign = dot < T{ 0 } ? T{ -1 } : T{ 1 };
+
+		cQuaternion<T> q(
+			_a.v.x + ( _b.v.x * sign - _a.v.x ) * _t,
+			_a.v.y + ( _b.v.y * sign - _a.v.y ) * _t,
+			_a.v.z + ( _b.v.z * sign - _a.v.z ) * _t,
+			_a.s   + ( _b.s   * sign - _a.s   ) * _t
+		);
+		q.normalize();
+		
+		return q;
+	}
+
 	template<typename T>
 	inline void cQuaternion<T>::normalize()
 	{
@@ -126,14 +126,11 @@ namespace wv
 	inline RayIntersection Ray::intersect<sMesh>( sMesh* _t )
 	{
 		
-		cVector4f s{ start.x, start.y, start.z, 1.0f };
-		cVector4f e{   end.x,   end.y,   end.z, 1.0f };
-		s = Matrix::inverse( _t->transform.getMatrix() ) * s;
-		e = Matrix::inverse( _t->transform.getMatrix() ) * e;
+		cMatrix4x4f inv = Matrix::inverse( _t->transform.getMatrix() );
 
 		wv::Ray ray{
-			wv::cVector3f{ s.x, s.y, s.z },
-			wv::cVector3f{ e.x, e.y, e.z }
+			Matrix::transformPoint( inv, start ),
+			Matrix::transformPoint( inv, end )
 		};
 
 		float rayLen = ray.length();
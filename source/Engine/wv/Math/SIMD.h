@@ -0,0 +1,245 @@
+#pragma once
+
+#include <stdint.h>
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#define WV_MATH_SSE
+#include <emmintrin.h>
+#endif
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+namespace wv
+{
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	/// <summary>
+	/// 4x4 float kernels on row major matrices, row vector convention ( v * M ).
+	/// Uses SSE when available and falls back to the scalar versions otherwise.
+	/// Inputs and outputs need no alignment, and outputs may alias inputs
+	/// </summary>
+	namespace SIMD
+	{
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+		namespace Scalar
+		{
+			inline void multiply4x4( const float* _a, const float* _b, float* _out )
+			{
+				float res[ 16 ];
+				for ( int r = 0; r < 4; r++ )
+					for ( int c = 0; c < 4; c++ )
+						res[ r * 4 + c ] = _a[ r * 4 + 0 ] * _b[ 0 * 4 + c ] + _a[ r * 4 + 1 ] * _b[ 1 * 4 + c ]
+						                 + _a[ r * 4 + 2 ] * _b[ 2 * 4 + c ] + _a[ r * 4 + 3 ] * _b[ 3 * 4 + c ];
+
+				for ( int i = 0; i < 16; i++ )
+					_out[ i ] = res[ i ];
+			}
+
+			inline void transpose4x4( const float* _m, float* _out )
+			{
+				float res[ 16 ];
+				for ( int r = 0; r < 4; r++ )
+					for ( int c = 0; c < 4; c++ )
+						res[ c * 4 + r ] = _m[ r * 4 + c ];
+
+				for ( int i = 0; i < 16; i++ )
+					_out[ i ] = res[ i ];
+			}
+
+			inline void transformVector4( const float* _m, const float* _v, float* _out )
+			{
+				float res[ 4 ];
+				for ( int c = 0; c < 4; c++ )
+					res[ c ] = _v[ 0 ] * _m[ c ] + _v[ 1 ] * _m[ 4 + c ] + _v[ 2 ] * _m[ 8 + c ] + _v[ 3 ] * _m[ 12 + c ];
+
+				for ( int c = 0; c < 4; c++ )
+					_out[ c ] = res[ c ];
+			}
+		}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	#ifdef WV_MATH_SSE
+		#define WV_SHUFFLE( _a, _b, _x, _y, _z, _w ) _mm_shuffle_ps( _a, _b, _MM_SHUFFLE( _w, _z, _y, _x ) )
+		#define WV_SWIZZLE( _v, _x, _y, _z, _w )     WV_SHUFFLE( _v, _v, _x, _y, _z, _w )
+
+		// 2x2 matrices packed as ( m00, m01, m10, m11 )
+
+		inline __m128 mul2x2( __m128 _a, __m128 _b )
+		{
+			return _mm_add_ps( _mm_mul_ps( _a, WV_SWIZZLE( _b, 0, 3, 0, 3 ) ),
+			                   _mm_mul_ps( WV_SWIZZLE( _a, 1, 0, 3, 2 ), WV_SWIZZLE( _b, 2, 1, 2, 1 ) ) );
+		}
+
+		// adj( a ) * b
+		inline __m128 adjMul2x2( __m128 _a, __m128 _b )
+		{
+			return _mm_sub_ps( _mm_mul_ps( WV_SWIZZLE( _a, 3, 3, 0, 0 ), _b ),
+			                   _mm_mul_ps( WV_SWIZZLE( _a, 1, 1, 2, 2 ), WV_SWIZZLE( _b, 2, 3, 0, 1 ) ) );
+		}
+
+		// a * adj( b )
+		inline __m128 mulAdj2x2( __m128 _a, __m128 _b )
+		{
+			return _mm_sub_ps( _mm_mul_ps( _a, WV_SWIZZLE( _b, 3, 0, 3, 0 ) ),
+			                   _mm_mul_ps( WV_SWIZZLE( _a, 1, 0, 3, 2 ), WV_SWIZZLE( _b, 2, 1, 2, 1 ) ) );
+		}
+	#endif
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+		inline void multiply4x4( const float* _a, const float* _b, float* _out )
+		{
+		#ifdef WV_MATH_SSE
+			__m128 b0 = _mm_loadu_ps( _b + 0 );
+			__m128 b1 = _mm_loadu_ps( _b + 4 );
+			__m128 b2 = _mm_loadu_ps( _b + 8 );
+			__m128 b3 = _mm_loadu_ps( _b + 12 );
+
+			for ( int r = 0; r < 4; r++ )
+			{
+				__m128 row = _mm_loadu_ps( _a + r * 4 );
+				__m128 res = _mm_mul_ps( WV_SWIZZLE( row, 0, 0, 0, 0 ), b0 );
+				res = _mm_add_ps( res, _mm_mul_ps( WV_SWIZZLE( row, 1, 1, 1, 1 ), b1 ) );
+				res = _mm_add_ps( res, _mm_mul_ps( WV_SWIZZLE( row, 2, 2, 2, 2 ), b2 ) );
+				res = _mm_add_ps( res, _mm_mul_ps( WV_SWIZZLE( row, 3, 3, 3, 3 ), b3 ) );
+				_mm_storeu_ps( _out + r * 4, res );
+			}
+		#else
+			Scalar::multiply4x4( _a, _b, _out );
+		#endif
+		}
+
+		inline void transpose4x4( const float* _m, float* _out )
+		{
+		#ifdef WV_MATH_SSE
+			__m128 r0 = _mm_loadu_ps( _m + 0 );
+			__m128 r1 = _mm_loadu_ps( _m + 4 );
+			__m128 r2 = _mm_loadu_ps( _m + 8 );
+			__m128 r3 = _mm_loadu_ps( _m + 12 );
+			_MM_TRANSPOSE4_PS( r0, r1, r2, r3 );
+			_mm_storeu_ps( _out + 0,  r0 );
+			_mm_storeu_ps( _out + 4,  r1 );
+			_mm_storeu_ps( _out + 8,  r2 );
+			_mm_storeu_ps( _out + 12, r3 );
+		#else
+			Scalar::transpose4x4( _m, _out );
+		#endif
+		}
+
+		inline void transformVector4( const float* _m, const float* _v, float* _out )
+		{
+		#ifdef WV_MATH_SSE
+			__m128 v   = _mm_loadu_ps( _v );
+			__m128 res = _mm_mul_ps( WV_SWIZZLE( v, 0, 0, 0, 0 ), _mm_loadu_ps( _m + 0 ) );
+			res = _mm_add_ps( res, _mm_mul_ps( WV_SWIZZLE( v, 1, 1, 1, 1 ), _mm_loadu_ps( _m + 4 ) ) );
+			res = _mm_add_ps( res, _mm_mul_ps( WV_SWIZZLE( v, 2, 2, 2, 2 ), _mm_loadu_ps( _m + 8 ) ) );
+			res = _mm_add_ps( res, _mm_mul_ps( WV_SWIZZLE( v, 3, 3, 3, 3 ), _mm_loadu_ps( _m + 12 ) ) );
+			_mm_storeu_ps( _out, res );
+		#else
+			Scalar::transformVector4( _m, _v, _out );
+		#endif
+		}
+
+		/// <summary>
+		/// Transforms a point ( w = 1 ), writes three floats
+		/// </summary>
+		inline void transformPoint( const float* _m, const float* _p, float* _out )
+		{
+		#ifdef WV_MATH_SSE
+			// broadcast the scalars directly, packing them into one register first stalls on store forwarding
+			__m128 res = _mm_add_ps( _mm_mul_ps( _mm_set1_ps( _p[ 0 ] ), _mm_loadu_ps( _m + 0 ) ), _mm_loadu_ps( _m + 12 ) );
+			res = _mm_add_ps( res, _mm_mul_ps( _mm_set1_ps( _p[ 1 ] ), _mm_loadu_ps( _m + 4 ) ) );
+			res = _mm_add_ps( res, _mm_mul_ps( _mm_set1_ps( _p[ 2 ] ), _mm_loadu_ps( _m + 8 ) ) );
+			
+			alignas( 16 ) float tmp[ 4 ];
+			_mm_store_ps( tmp, res );
+			_out[ 0 ] = tmp[ 0 ];
+			_out[ 1 ] = tmp[ 1 ];
+			_out[ 2 ] = tmp[ 2 ];
+		#else
+			float p[ 4 ] = { _p[ 0 ], _p[ 1 ], _p[ 2 ], 1.0f };
+			float res[ 4 ];
+			Scalar::transformVector4( _m, p, res );
+			_out[ 0 ] = res[ 0 ];
+			_out[ 1 ] = res[ 1 ];
+			_out[ 2 ] = res[ 2 ];
+		#endif
+		}
+
+	#ifdef WV_MATH_SSE
+		/// <summary>
+		/// General inverse. Returns false and writes a zero matrix if the matrix is singular
+		/// </summary>
+		inline bool inverse4x4( const float* _m, float* _out )
+		{
+			__m128 r0 = _mm_loadu_ps( _m + 0 );
+			__m128 r1 = _mm_loadu_ps( _m + 4 );
+			__m128 r2 = _mm_loadu_ps( _m + 8 );
+			__m128 r3 = _mm_loadu_ps( _m + 12 );
+
+			// split into 2x2 blocks | A B |
+			//                       | C D |
+			__m128 A = _mm_movelh_ps( r0, r1 );
+			__m128 B = _mm_movehl_ps( r1, r0 );
+			__m128 C = _mm_movelh_ps( r2, r3 );
+			__m128 D = _mm_movehl_ps( r3, r2 );
+
+			// ( |A|, |B|, |C|, |D| )
+			__m128 detSub = _mm_sub_ps(
+				_mm_mul_ps( WV_SHUFFLE( r0, r2, 0, 2, 0, 2 ), WV_SHUFFLE( r1, r3, 1, 3, 1, 3 ) ),
+				_mm_mul_ps( WV_SHUFFLE( r0, r2, 1, 3, 1, 3 ), WV_SHUFFLE( r1, r3, 0, 2, 0, 2 ) ) );
+
+			__m128 detA = WV_SWIZZLE( detSub, 0, 0, 0, 0 );
+			__m128 detB = WV_SWIZZLE( detSub, 1, 1, 1, 1 );
+			__m128 detC = WV_SWIZZLE( detSub, 2, 2, 2, 2 );
+			__m128 detD = WV_SWIZZLE( detSub, 3, 3, 3, 3 );
+
+			__m128 adjDC = adjMul2x2( D, C );
+			__m128 adjAB = adjMul2x2( A, B );
+
+			__m128 X = _mm_sub_ps( _mm_mul_ps( detD, A ), mul2x2( B, adjDC ) );
+			__m128 W = _mm_sub_ps( _mm_mul_ps( detA, D ), mul2x2( C, adjAB ) );
+			__m128 Y = _mm_sub_ps( _mm_mul_ps( detB, C ), mulAdj2x2( D, adjAB ) );
+			__m128 Z = _mm_sub_ps( _mm_mul_ps( detC, B ), mulAdj2x2( A, adjDC ) );
+
+			// |M| = |A||D| + |B||C| - tr( adj( A )B adj( D )C )
+			__m128 tr = _mm_mul_ps( adjAB, WV_SWIZZLE( adjDC, 0, 2, 1, 3 ) );
+			tr = _mm_add_ps( tr, WV_SWIZZLE( tr, 2, 3, 0, 1 ) );
+			tr = _mm_add_ps( tr, WV_SWIZZLE( tr, 1, 0, 3, 2 ) );
+
+			__m128 det = _mm_sub_ps( _mm_add_ps( _mm_mul_ps( detA, detD ), _mm_mul_ps( detB, detC ) ), tr );
+
+			if ( _mm_cvtss_f32( det ) == 0.0f )
+			{
+				__m128 zero = _mm_setzero_ps();
+				_mm_storeu_ps( _out + 0,  zero );
+				_mm_storeu_ps( _out + 4,  zero );
+				_mm_storeu_ps( _out + 8,  zero );
+				_mm_storeu_ps( _out + 12, zero );
+				return false;
+			}
+
+			__m128 invDet = _mm_div_ps( _mm_setr_ps( 1.0f, -1.0f, -1.0f, 1.0f ), det );
+			X = _mm_mul_ps( X, invDet );
+			Y = _mm_mul_ps( Y, invDet );
+			Z = _mm_mul_ps( Z, invDet );
+			W = _mm_mul_ps( W, invDet );
+
+			_mm_storeu_ps( _out + 0,  WV_SHUFFLE( X, Y, 3, 1, 3, 1 ) );
+			_mm_storeu_ps( _out + 4,  WV_SHUFFLE( X, Y, 2, 0, 2, 0 ) );
+			_mm_storeu_ps( _out + 8,  WV_SHUFFLE( Z, W, 3, 1, 3, 1 ) );
+			_mm_storeu_ps( _out + 12, WV_SHUFFLE( Z, W, 2, 0, 2, 0 ) );
+			return true;
+		}
+
+		#undef WV_SWIZZLE
+		#undef WV_SHUFFLE
+	#endif
+
+	}
+
+}
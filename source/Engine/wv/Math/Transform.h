@@ -2,49 +2,156 @@
 
 #include <wv/Math/Vector3.h>
 #include <wv/Math/Matrix.h>
+#include <wv/Math/Quaternion.h>
+
+#include <stdint.h>
 
 #include <vector>
+#include <cmath>
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
 namespace wv 
 {
 
+///////////////////////////////////////////////////////////////////////////////////////
+
+	class cTransformHierarchy;
+
 ///////////////////////////////////////////////////////////////////////////////////////
 
 	template<typename T>
     class Transform
     {
+		// writes the world matrices it computes back
+		friend class cTransformHierarchy;
 
 	public:
 
-		inline void setPosition( wv::cVector3<T> _position ) { position = _position; }
-		inline void setRotation( wv::cVector3<T> _rotation ) { rotation = _rotation; }
-		inline void setScale   ( wv::cVector3<T> _scale )    { scale = _scale; }
+		Transform() = default;
+		Transform( const Transform<T>& _other );
+		~Transform();
+
+		/// <summary>
+		/// Copies the position, orientation and scale. Parent and children are left untouched
+		/// </summary>
+		Transform<T>& operator=( const Transform<T>& _other );
+
+		inline void setPosition( wv::cVector3<T> _position ) { position = _position; m_dirty = true; }
+		inline void setRotation( wv::cVector3<T> _rotation ) { rotation = _rotation; m_dirty = true; }
+		inline void setScale   ( wv::cVector3<T> _scale )    { scale = _scale;       m_dirty = true; }
+
+		/// <summary>
+		/// Sets the orientation directly. rotation is set to the matching euler angles,
+		/// so a later rotate or setRotation continues from this orientation
+		/// </summary>
+		inline void setOrientation( const cQuaternion<T>& _orientation ) 
+		{ 
+			const cVector3<T> euler = _orientation.toEuler();
+			rotation = { 
+				(T)Math::degrees( euler.x ), 
+				(T)Math::degrees( euler.y ), 
+				(T)Math::degrees( euler.z ) 
+			};
+
+			m_orientation = _orientation; 
+			m_eulerRotation = rotation; 
+			m_dirty = true; 
+		}
 		
-		inline void translate( wv::cVector3<T> _translation ) { position += _translation; }
-		inline void rotate   ( wv::cVector3<T> _rotation )    { rotation += _rotation; }
+		/// <summary>
+		/// Current orientation, including any change made through rotation
+		/// </summary>
+		inline const cQuaternion<T>& getOrientation() const { syncOrientation(); return m_orientation; }
 		
-		inline cMatrix<T, 4, 4> getMatrix() { return m_matrix; }
+		inline void translate( wv::cVector3<T> _translation ) { position += _translation; m_dirty = true; }
+		inline void rotate   ( wv::cVector3<T> _rotation )    { rotation += _rotation;    m_dirty = true; }
+		
+		inline const cMatrix<T, 4, 4>& getMatrix()      const { return m_matrix; }
+		inline const cMatrix<T, 4, 4>& getLocalMatrix() const { return m_localMatrix; }
+
+		inline Transform<T>* getParent() const { return m_parent; }
+		inline const std::vector<Transform<T>*>& getChildren() const { return m_children; }
 
 		void addChild( Transform<T>* _child );
 		void removeChild( Transform<T>* _child );
-
+		
+		/// <summary>
+		/// Unlinks every child at once, cheaper than removing them one by one
+		/// </summary>
+		void removeAllChildren();
+
+		/// <summary>
+		/// Updates this transform and every transform below it immediately
+		/// </summary>
 		void update  ( Transform<T>* _parent );
-
-		inline cVector3<T> forward() { return rotation.eulerToDirection(); }
+		void update  ( const cMatrix<T, 4, 4>& _parentMatrix );
+
+		/// <summary>
+		/// Rebuilds the local matrix if position, rotation or scale changed since the last call.
+		/// Returns true if it was rebuilt
+		/// </summary>
+		bool updateLocalMatrix();
+
+		/// <summary>
+		/// world = local * parent world
+		/// </summary>
+		void updateWorldMatrix( const Transform<T>* _parent );
+		void updateWorldMatrix( const cMatrix<T, 4, 4>& _parentMatrix );
+
+		/// <summary>
+		/// scale * rotation * translate, built directly without any matrix multiplies
+		/// </summary>
+		static void composeMatrix( const cVector3<T>& _position, const cQuaternion<T>& _orientation, const cVector3<T>& _scale, cMatrix<T, 4, 4>& _out );
+
+		/// <summary>
+		/// Incremented every time a parent/child link at or below this transform changes.
+		/// Links in other trees leave it alone, so each tree can be tracked on its own
+		/// </summary>
+		uint32_t getHierarchyRevision() const { return m_hierarchyRevision; }
+
+		/// <summary>
+		/// Local +z rotated by the orientation
+		/// </summary>
+		inline cVector3<T> forward() const
+		{ 
+			const cQuaternion<T>& q = getOrientation();
+			return { 
+				2 * ( q.v.x * q.v.z + q.v.y * q.s ), 
+				2 * ( q.v.y * q.v.z - q.v.x * q.s ), 
+				1 - 2 * ( q.v.x * q.v.x + q.v.y * q.v.y ) 
+			}; 
+		}
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
 		cVector3<T> position{ 0, 0, 0 };
-		cVector3<T> rotation{ 0, 0, 0 };
+		cVector3<T> rotation{ 0, 0, 0 }; // euler degrees, converted to the orientation when changed
 		cVector3<T> scale   { 1, 1, 1 };
 
 
 	private:
 
+		void syncOrientation() const;
+		void bumpHierarchyRevision();
+
 		cMatrix<T, 4, 4> m_matrix{ 1 };
+		cMatrix<T, 4, 4> m_localMatrix{ 1 };
+
+		// synced lazily from rotation, so also from const getters
+		mutable cQuaternion<T> m_orientation{};
+		mutable cVector3<T>    m_eulerRotation{ 0, 0, 0 };
+		mutable bool           m_dirty = true;
+
+		// the fields are public, so the last built values are kept to catch direct writes
+		cVector3<T> m_localPosition{ 0, 0, 0 };
+		cVector3<T> m_localScale   { 1, 1, 1 };
+
+		Transform<T>* m_parent = nullptr;
 		std::vector<Transform<T>*> m_children;
+
+		// a tree is only ever relinked by the thread that owns it
+		uint32_t m_hierarchyRevision = 0;
     };
 
 ///////////////////////////////////////////////////////////////////////////////////////
@@ -53,19 +160,63 @@ namespace wv
 	typedef Transform<double> Transformd;
 	typedef Transform<int>    Transformi;
 
+///////////////////////////////////////////////////////////////////////////////////////
+
+	template<typename T>
+	inline Transform<T>::Transform( const Transform<T>& _other ) :
+		position{ _other.position },
+		rotation{ _other.rotation },
+		scale   { _other.scale },
+		m_matrix     { _other.m_matrix },
+		m_localMatrix{ _other.m_localMatrix },
+		m_orientation  { _other.m_orientation },
+		m_eulerRotation{ _other.m_eulerRotation },
+		m_dirty        { _other.m_dirty },
+		m_localPosition{ _other.m_localPosition },
+		m_localScale   { _other.m_localScale }
+	{
+
+	}
+
+	template<typename T>
+	inline Transform<T>::~Transform()
+	{
+		if( m_parent )
+			m_parent->removeChild( this );
+
+		for( auto& child : m_children )
+			child->m_parent = nullptr;
+	}
+
+	template<typename T>
+	inline Transform<T>& Transform<T>::operator=( const Transform<T>& _other )
+	{
+		position = _other.position;
+		rotation = _other.rotation;
+		scale    = _other.scale;
+
+		// a pending euler change on _other stays pending here
+		m_orientation   = _other.m_orientation;
+		m_eulerRotation = _other.m_eulerRotation;
+		m_dirty = true;
+
+		return *this;
+	}
+
 ///////////////////////////////////////////////////////////////////////////////////////
 
 	template<typename T>
 	inline void Transform<T>::addChild( Transform<T>* _child )
 	{
-		if( _child == nullptr )
+		if( _child == nullptr || _child->m_parent == this )
 			return;
 
-		for( auto& child : m_children ) // if child is already added
-			if( child == _child ) 
-				return;
+		if( _child->m_parent )
+			_child->m_parent->removeChild( _child );
 		
 		m_children.push_back( _child );
+		_child->m_parent = this;
+		bumpHierarchyRevision();
 	}
 
 	template<typename T>
@@ -74,37 +225,132 @@ namespace wv
 		if( _child == nullptr )
 			return;
 
-		for( size_t i = 0; i++; i < m_children.size() )
+		for( size_t i = 0; i < m_children.size(); i++ )
 		{
 			if( m_children[ i ] != _child )
 				continue;
 
 			m_children.erase( m_children.begin() + i );
+			_child->m_parent = nullptr;
+			bumpHierarchyRevision();
 			return;
 		}
 	}
 
 	template<typename T>
-	inline void Transform<T>::update( Transform<T>* _parent )
+	inline void Transform<T>::removeAllChildren()
+	{
+		if( m_children.empty() )
+			return;
+
+		for( auto& child : m_children )
+			child->m_parent = nullptr;
+
+		m_children.clear();
+		bumpHierarchyRevision();
+	}
+
+	template<typename T>
+	inline void Transform<T>::bumpHierarchyRevision()
+	{
+		// every ancestor sees the change, so a subtree detached later still knows it changed
+		for( Transform<T>* transform = this; transform; transform = transform->m_parent )
+			transform->m_hierarchyRevision++;
+	}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	template<typename T>
+	inline void Transform<T>::syncOrientation() const
 	{
-		cMatrix<T, 4, 4> model{ 1 };
+		if( rotation.x == m_eulerRotation.x && rotation.y == m_eulerRotation.y && rotation.z == m_eulerRotation.z )
+			return;
 
-		model = Matrix::translate( model, position );
+		m_orientation = cQuaternion<T>::fromEuler( { 
+			Math::radians( rotation.x ), 
+			Math::radians( rotation.y ), 
+			Math::radians( rotation.z ) 
+		} );
+		m_eulerRotation = rotation;
+		m_dirty = true;
+	}
+
+	template<typename T>
+	inline void Transform<T>::composeMatrix( const cVector3<T>& _position, const cQuaternion<T>& _orientation, const cVector3<T>& _scale, cMatrix<T, 4, 4>& _out )
+	{
+		const T x = _orientation.v.x;
+		const T y = _orientation.v.y;
+		const T z = _orientation.v.z;
+		const T w = _orientation.s;
+
+		const T xx = x * x, yy = y * y, zz = z * z;
+		const T xy = x * y, xz = x * z, yz = y * z;
+		const T wx = w * x, wy = w * y, wz = w * z;
+
+		cMatrix<T, 4, 4>& m = _out;
+		m.m[ 0 ][ 0 ] = _scale.x * ( 1 - 2 * ( yy + zz ) );
+		m.m[ 0 ][ 1 ] = _scale.x * ( 2 * ( xy + wz ) );
+		m.m[ 0 ][ 2 ] = _scale.x * ( 2 * ( xz - wy ) );
+		m.m[ 0 ][ 3 ] = 0;
+
+		m.m[ 1 ][ 0 ] = _scale.y * ( 2 * ( xy - wz ) );
+		m.m[ 1 ][ 1 ] = _scale.y * ( 1 - 2 * ( xx + zz ) );
+		m.m[ 1 ][ 2 ] = _scale.y * ( 2 * ( yz + wx ) );
+		m.m[ 1 ][ 3 ] = 0;
+
+		m.m[ 2 ][ 0 ] = _scale.z * ( 2 * ( xz + wy ) );
+		m.m[ 2 ][ 1 ] = _scale.z * ( 2 * ( yz - wx ) );
+		m.m[ 2 ][ 2 ] = _scale.z * ( 1 - 2 * ( xx + yy ) );
+		m.m[ 2 ][ 3 ] = 0;
+
+		m.m[ 3 ][ 0 ] = _position.x;
+		m.m[ 3 ][ 1 ] = _position.y;
+		m.m[ 3 ][ 2 ] = _position.z;
+		m.m[ 3 ][ 3 ] = 1;
+	}
 
+	template<typename T>
+	inline bool Transform<T>::updateLocalMatrix()
+	{
+		syncOrientation();
 		
-		model = Matrix::rotateZ( model, Math::radians( rotation.z ) );
-		model = Matrix::rotateY( model, Math::radians( rotation.y ) );
-		model = Matrix::rotateX( model, Math::radians( rotation.x ) );
+		if( !m_dirty &&
+			position.x == m_localPosition.x && position.y == m_localPosition.y && position.z == m_localPosition.z &&
+			scale.x    == m_localScale.x    && scale.y    == m_localScale.y    && scale.z    == m_localScale.z )
+			return false;
+
+		composeMatrix( position, m_orientation, scale, m_localMatrix );
+
+		m_localPosition = position;
+		m_localScale    = scale;
+		m_dirty = false;
+
+		return true;
+	}
 
-		model = Matrix::scale( model, scale );
+	template<typename T>
+	inline void Transform<T>::updateWorldMatrix( const Transform<T>* _parent )
+	{
+		if( _parent == nullptr )
+		{
+			m_matrix = m_localMatrix;
+			return;
+		}
 
-		if( _parent != nullptr )
-			model = model * _parent->getMatrix();
+		updateWorldMatrix( _parent->m_matrix );
+	}
 
-		m_matrix = model;
+	template<typename T>
+	inline void Transform<T>::updateWorldMatrix( const cMatrix<T, 4, 4>& _parentMatrix )
+	{
+		m_matrix = Matrix::multiply( m_localMatrix, _parentMatrix );
+	}
 
-		//for( auto& child : m_children )
-		//	child->update( this );
+	template<typename T>
+	inline void Transform<T>::update( Transform<T>* _parent )
+	{
+		updateLocalMatrix();
+		updateWorldMatrix( _parent );
 
 		for ( size_t i = 0; i < m_children.size(); i++ )
 		{
@@ -112,4 +358,14 @@ namespace wv
 		}
 	}
 
-}
\ No newline at end of file
+	template<typename T>
+	inline void Transform<T>::update( const cMatrix<T, 4, 4>& _parentMatrix )
+	{
+		updateLocalMatrix();
+		updateWorldMatrix( _parentMatrix );
+
+		for ( size_t i = 0; i < m_children.size(); i++ )
+			m_children[ i ]->update( this );
+	}
+
+}
@@ -61,7 +61,7 @@ wv::cFileSystem::~cFileSystem()
 
 wv::Memory* wv::cFileSystem::loadMemory( const std::string& _path )
 {
-#ifdef WV_PLATFORM_WINDOWS
+#ifndef WV_PLATFORM_PSVITA
 	std::ifstream in( _path, std::ios::binary );
 	if ( !in.is_open() )
 	{
@@ -83,7 +83,7 @@ wv::Memory* wv::cFileSystem::loadMemory( const std::string& _path )
 	m_mutex.unlock();
 
 	return mem;
-#elif defined( WV_PLATFORM_PSVITA )
+#else
 	char buffer[ 1024 * 4 ];
 
 	wv::Handle file = m_pLowLevel->openFile( _path.c_str(), wv::eOpenMode::WV_OPEN_MODE_READ );
@@ -102,8 +102,6 @@ wv::Memory* wv::cFileSystem::loadMemory( const std::string& _path )
 	memcpy( mem->data, buffer, size );
 
 	return mem;
-#else
-	return nullptr;
 #endif
 }
 
@@ -127,7 +125,7 @@ void wv::cFileSystem::unloadMemory( Memory* _memory )
 
 	m_mutex.unlock();
 
-	delete _memory->data;
+	delete[] _memory->data;
 	*_memory = {};
 	delete _memory;
 }
@@ -148,9 +146,29 @@ std::string wv::cFileSystem::loadString( const std::string& _path )
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
+bool wv::cFileSystem::saveMemory( const std::string& _path, const uint8_t* _data, unsigned int _size )
+{
+#ifndef WV_PLATFORM_PSVITA
+	std::ofstream out( _path, std::ios::binary | std::ios::trunc );
+	if ( !out.is_open() )
+	{
+		Debug::Print( Debug::WV_PRINT_ERROR, "Failed to save '%s'\n", _path.c_str() );
+		return false;
+	}
+
+	out.write( (const char*)_data, _size );
+	return out.good();
+#else
+	Debug::Print( Debug::WV_PRINT_ERROR, "cFileSystem::saveMemory unimplemented\n" );
+	return false;
+#endif
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
 bool wv::cFileSystem::fileExists( const std::string& _path )
 {
-#ifdef WV_PLATFORM_WINDOWS
+#ifndef WV_PLATFORM_PSVITA
 	std::ifstream f( _path );
 	return f.good();
 #else
@@ -42,6 +42,11 @@ namespace wv
 
 		std::string loadString( const std::string& _path );
 
+		/// <summary>
+		/// Writes _size bytes to _path, replacing the file if it exists
+		/// </summary>
+		bool saveMemory( const std::string& _path, const uint8_t* _data, unsigned int _size );
+
 		bool fileExists( const std::string& _path );
 		
 		std::string getFullPath( const std::string& _fileName );
@@ -1,10 +1,10 @@
 #include "ModelParser.h"
 
-#include <wv/Engine/Engine.h>
 #include <wv/Material/Material.h>
 #include <wv/Debug/Print.h>
 #include <wv/Device/GraphicsDevice.h>
 #include <wv/Primitive/Mesh.h>
+#include <wv/Primitive/MeshOptimizer.h>
 #include <wv/Math/Triangle.h>
 #include <wv/Memory/FileSystem.h>
 
@@ -39,9 +39,9 @@ std::string getAssimpMaterialTexturePath( aiMaterial* _material, aiTextureType _
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
-void processAssimpMesh( aiMesh* _assimp_mesh, const aiScene* _scene, wv::sMesh* _mesh, wv::cResourceRegistry* _pResourceRegistry, size_t _primitiveIndex )
+void processAssimpMesh( aiMesh* _assimp_mesh, const aiScene* _scene, wv::sMesh* _mesh, wv::iGraphicsDevice* _pGraphicsDevice, wv::cResourceRegistry* _pResourceRegistry, size_t _primitiveIndex, const wv::sMeshImportSettings& _settings )
 {
-	wv::iGraphicsDevice* device = wv::cEngine::get()->graphics;
+	wv::iGraphicsDevice* device = _pGraphicsDevice;
 
 	std::vector<wv::Vertex> vertices;
 	std::vector<unsigned int> indices;
@@ -83,6 +83,7 @@ void processAssimpMesh( aiMesh* _assimp_mesh, const aiScene* _scene, wv::sMesh*
 			
 		}
 
+		_mesh->bounds.expand( v.position );
 		vertices.push_back( v );
 	}
 
@@ -105,6 +106,72 @@ void processAssimpMesh( aiMesh* _assimp_mesh, const aiScene* _scene, wv::sMesh*
 			indices.push_back( face.mIndices[ j ] );
 	}
 
+	const bool triangleList = indices.size() % 3 == 0;
+
+	wv::MeshOptimizer::sVertexCacheStats statsBefore = wv::MeshOptimizer::analyzeVertexCache( indices, vertices.size() );
+
+	if ( triangleList && _settings.optimizeVertexCache )
+	{
+		std::vector<uint32_t> clusters;
+		indices = wv::MeshOptimizer::optimizeVertexCache( indices, vertices.size(), 16, &clusters );
+		
+		if ( _settings.optimizeOverdraw )
+			indices = wv::MeshOptimizer::optimizeOverdraw( indices, vertices, clusters );
+	}
+
+	// generate lods, each simplified from the previous one
+	std::vector<std::vector<uint32_t>> lodIndices = { indices };
+	std::vector<float> lodErrors = { 0.0f };
+	if ( triangleList && _settings.generateLODs )
+	{
+		const float targetErrors[ WV_MAX_PRIMITIVE_LODS - 1 ] = { 0.01f, 0.03f, 0.08f };
+
+		for ( int lod = 1; lod < WV_MAX_PRIMITIVE_LODS; lod++ )
+		{
+			const std::vector<uint32_t>& previous = lodIndices.back();
+			if ( previous.size() < 3 * 64 ) // not worth it
+				break;
+
+			float error = 0.0f;
+			std::vector<uint32_t> simplified = wv::MeshOptimizer::simplify( previous, vertices, previous.size() / 2, targetErrors[ lod - 1 ], &error );
+			
+			if ( simplified.size() > previous.size() * 9 / 10 ) // simplification stalled
+				break;
+
+			if ( _settings.optimizeVertexCache )
+				simplified = wv::MeshOptimizer::optimizeVertexCache( simplified, vertices.size() );
+
+			lodIndices.push_back( simplified );
+			lodErrors.push_back( error );
+		}
+
+		if ( lodIndices.size() > 1 )
+		{
+			std::string lodInfo;
+			for ( size_t i = 0; i < lodIndices.size(); i++ )
+				lodInfo += " " + std::to_string( lodIndices[ i ].size() / 3 );
+
+			wv::Debug::Print( wv::Debug::WV_PRINT_DEBUG, "Generated %i LODs for '%s', triangles:%s\n", (int)lodIndices.size(), _assimp_mesh->mName.C_Str(), lodInfo.c_str() );
+		}
+	}
+
+	if ( triangleList && _settings.optimizeVertexFetch )
+	{
+		// every lod only references vertices used by lod 0
+		std::vector<uint32_t> remap = wv::MeshOptimizer::optimizeVertexFetch( vertices, lodIndices[ 0 ] );
+		
+		for ( size_t lod = 1; lod < lodIndices.size(); lod++ )
+			for ( auto& index : lodIndices[ lod ] )
+				index = remap[ index ];
+	}
+
+	if ( triangleList && ( _settings.optimizeVertexCache || _settings.optimizeVertexFetch ) )
+	{
+		wv::MeshOptimizer::sVertexCacheStats statsAfter = wv::MeshOptimizer::analyzeVertexCache( lodIndices[ 0 ], vertices.size() );
+		wv::Debug::Print( wv::Debug::WV_PRINT_DEBUG, "Optimized '%s', ACMR %.3f -> %.3f, ATVR %.3f -> %.3f\n", 
+			_assimp_mesh->mName.C_Str(), statsBefore.acmr, statsAfter.acmr, statsBefore.atvr, statsAfter.atvr );
+	}
+
 	/// this reeeeeeeally needs to be reworked
 
 	wv::cMaterial* material = nullptr;
@@ -112,7 +179,7 @@ void processAssimpMesh( aiMesh* _assimp_mesh, const aiScene* _scene, wv::sMesh*
 	{
 		aiMaterial* assimpMaterial = _scene->mMaterials[ _assimp_mesh->mMaterialIndex ];
 
-		wv::cFileSystem& md = *wv::cEngine::get()->m_pFileSystem;
+		wv::cFileSystem& md = *_pResourceRegistry->getFileSystem();
 
 		std::string materialName = assimpMaterial->GetName().C_Str();
 
@@ -153,9 +220,25 @@ void processAssimpMesh( aiMesh* _assimp_mesh, const aiScene* _scene, wv::sMesh*
 		prDesc.vertices = new wv::Vertex[ vertices.size() ];
 		memcpy( prDesc.vertices, vertices.data(), sizeVertices );
 		
-		prDesc.numIndices = indices.size();
-		prDesc.indices32 = new uint32_t[ indices.size() ];
-		memcpy( prDesc.indices32, indices.data(), indices.size() * sizeof( uint32_t ) );
+		// all lods share one index buffer
+		size_t numIndices = 0;
+		for ( auto& lod : lodIndices )
+			numIndices += lod.size();
+
+		prDesc.numIndices = numIndices;
+		prDesc.indices32 = new uint32_t[ numIndices ];
+		prDesc.numLODs = (uint32_t)lodIndices.size();
+
+		size_t firstIndex = 0;
+		for ( size_t i = 0; i < lodIndices.size(); i++ )
+		{
+			prDesc.lods[ i ].firstIndex = (uint32_t)firstIndex;
+			prDesc.lods[ i ].numIndices = (uint32_t)lodIndices[ i ].size();
+			prDesc.lods[ i ].error      = lodErrors[ i ];
+
+			memcpy( prDesc.indices32 + firstIndex, lodIndices[ i ].data(), lodIndices[ i ].size() * sizeof( uint32_t ) );
+			firstIndex += lodIndices[ i ].size();
+		}
 		
 		prDesc.pMaterial = material;
 
@@ -173,7 +256,7 @@ void processAssimpMesh( aiMesh* _assimp_mesh, const aiScene* _scene, wv::sMesh*
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
-void processAssimpNode( aiNode* _node, const aiScene* _scene, wv::sMeshNode* _meshNode, wv::iGraphicsDevice* _pGraphicsDevice, wv::cResourceRegistry* _pResourceRegistry )
+void processAssimpNode( aiNode* _node, const aiScene* _scene, wv::sMeshNode* _meshNode, wv::iGraphicsDevice* _pGraphicsDevice, wv::cResourceRegistry* _pResourceRegistry, const wv::sMeshImportSettings& _settings )
 {
 	aiVector3D pos, scale, rot;
 	_node->mTransformation.Decompose( scale, rot, pos );
@@ -194,7 +277,7 @@ void processAssimpNode( aiNode* _node, const aiScene* _scene, wv::sMeshNode* _me
 		mesh->primitives.resize( _node->mNumMeshes );
 
 		aiMesh* aimesh = _scene->mMeshes[ _node->mMeshes[ i ] ];
-		processAssimpMesh( aimesh, _scene, mesh, _pResourceRegistry, i );
+		processAssimpMesh( aimesh, _scene, mesh, _pGraphicsDevice, _pResourceRegistry, i, _settings );
 		
 		_meshNode->transform.addChild( &mesh->transform );
 		_meshNode->meshes.push_back( mesh );
@@ -204,7 +287,7 @@ void processAssimpNode( aiNode* _node, const aiScene* _scene, wv::sMeshNode* _me
 	for( unsigned int i = 0; i < _node->mNumChildren; i++ )
 	{
 		wv::sMeshNode* meshNode = new wv::sMeshNode();
-		processAssimpNode( _node->mChildren[ i ], _scene, meshNode, _pGraphicsDevice, _pResourceRegistry );
+		processAssimpNode( _node->mChildren[ i ], _scene, meshNode, _pGraphicsDevice, _pResourceRegistry, _settings );
 
 		_meshNode->transform.addChild( &meshNode->transform );
 		_meshNode->children.push_back( meshNode );
@@ -216,7 +299,14 @@ void processAssimpNode( aiNode* _node, const aiScene* _scene, wv::sMeshNode* _me
 
 wv::sMeshNode* wv::Parser::load( const char* _path, wv::cResourceRegistry* _pResourceRegistry )
 {
-	cFileSystem md;
+	wv::iGraphicsDevice* device = _pResourceRegistry->getGraphicsDevice();
+	if ( device == nullptr )
+	{
+		Debug::Print( Debug::WV_PRINT_ERROR, "Cannot load mesh '%s' without a graphics device\n", _path );
+		return nullptr;
+	}
+
+	cFileSystem& md = *_pResourceRegistry->getFileSystem();
 	std::string path = std::string( _path );
 	Memory* meshMem = md.loadMemory( path );
 	
@@ -235,10 +325,8 @@ wv::sMeshNode* wv::Parser::load( const char* _path, wv::cResourceRegistry* _pRes
 		return nullptr;
 	}
 
-	wv::iGraphicsDevice* device = wv::cEngine::get()->graphics;
-	
 	wv::sMeshNode* mesh = new wv::sMeshNode();
-	processAssimpNode( scene->mRootNode, scene, mesh, device, _pResourceRegistry );
+	processAssimpNode( scene->mRootNode, scene, mesh, device, _pResourceRegistry, settings );
 	
 	return mesh;
 }
@@ -18,6 +18,18 @@ namespace wv
 	struct sMeshNode;
 	class cResourceRegistry;
 
+///////////////////////////////////////////////////////////////////////////////////////
+
+	struct sMeshImportSettings
+	{
+		bool generateLODs        = true;
+		bool optimizeVertexCache = true;
+		bool optimizeVertexFetch = true;
+		
+		// reorders cache clusters, trades a little vertex cache efficiency for less overdraw
+		bool optimizeOverdraw    = false;
+	};
+
 ///////////////////////////////////////////////////////////////////////////////////////
 
 	class Parser
@@ -30,6 +42,8 @@ namespace wv
 		
 		sMeshNode* load( const char* _path, cResourceRegistry* _pResourceRegistry );
 
+		sMeshImportSettings settings;
+
 	};
 
 
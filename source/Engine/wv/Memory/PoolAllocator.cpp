@@ -0,0 +1,169 @@
+#include "PoolAllocator.h"
+
+#include <wv/Debug/Print.h>
+
+#include <new>
+#include <algorithm>
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+static std::mutex& getPoolsMutex()
+{
+	static std::mutex mutex;
+	return mutex;
+}
+
+static std::vector<wv::cPoolAllocator*>& getPools()
+{
+	static std::vector<wv::cPoolAllocator*> pools;
+	return pools;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+wv::cPoolAllocator::cPoolAllocator( size_t _objectSize, size_t _alignment )
+{
+	// every slot has to be able to hold the free list link
+	m_alignment  = std::max( _alignment, alignof( sFreeSlot ) );
+	m_objectSize = std::max( _objectSize, sizeof( sFreeSlot ) );
+	m_objectSize = ( m_objectSize + m_alignment - 1 ) & ~( m_alignment - 1 );
+
+	std::scoped_lock lock( getPoolsMutex() );
+	getPools().push_back( this );
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+wv::cPoolAllocator::~cPoolAllocator()
+{
+	{
+		std::scoped_lock lock( getPoolsMutex() );
+		std::vector<cPoolAllocator*>& pools = getPools();
+		pools.erase( std::remove( pools.begin(), pools.end(), this ), pools.end() );
+	}
+
+	if ( m_numAllocated > 0 )
+		Debug::Print( Debug::WV_PRINT_WARN, "Pool of %zu byte objects destroyed with %u objects still allocated\n", m_objectSize, m_numAllocated );
+
+	for ( uint8_t* block : m_blocks )
+		::operator delete( block, std::align_val_t{ m_alignment } );
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void* wv::cPoolAllocator::allocate()
+{
+	std::scoped_lock lock( m_mutex );
+
+	if ( !m_pFreeList )
+	{
+		uint8_t* block = (uint8_t*)::operator new( m_objectSize * OBJECTS_PER_BLOCK, std::align_val_t{ m_alignment } );
+		m_blocks.push_back( block );
+
+		// link back to front so slots are handed out in address order
+		for ( int32_t i = OBJECTS_PER_BLOCK - 1; i >= 0; i-- )
+		{
+			sFreeSlot* slot = (sFreeSlot*)( block + i * m_objectSize );
+			slot->pNext = m_pFreeList;
+			m_pFreeList = slot;
+		}
+	}
+
+	sFreeSlot* slot = m_pFreeList;
+	m_pFreeList = slot->pNext;
+	m_numAllocated++;
+
+	return slot;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cPoolAllocator::free( void* _ptr )
+{
+	if ( !_ptr )
+		return;
+
+	std::scoped_lock lock( m_mutex );
+
+	sFreeSlot* slot = (sFreeSlot*)_ptr;
+	slot->pNext = m_pFreeList;
+	m_pFreeList = slot;
+	m_numAllocated--;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+uint32_t wv::cPoolAllocator::releaseUnused()
+{
+	std::scoped_lock lock( m_mutex );
+
+	if ( m_blocks.empty() )
+		return 0;
+
+	if ( m_numAllocated == 0 )
+	{
+		uint32_t numFreed = (uint32_t)m_blocks.size();
+		for ( uint8_t* block : m_blocks )
+			::operator delete( block, std::align_val_t{ m_alignment } );
+
+		m_blocks.clear();
+		m_pFreeList = nullptr;
+		return numFreed;
+	}
+
+	// count free slots per block, blocks are sorted so each slot can be looked up by address
+	std::sort( m_blocks.begin(), m_blocks.end() );
+	std::vector<uint32_t> freeCounts( m_blocks.size(), 0 );
+
+	auto findBlock = [ & ]( sFreeSlot* _slot ) -> size_t
+		{
+			auto it = std::upper_bound( m_blocks.begin(), m_blocks.end(), (uint8_t*)_slot );
+			return (size_t)( it - m_blocks.begin() ) - 1;
+		};
+
+	for ( sFreeSlot* slot = m_pFreeList; slot; slot = slot->pNext )
+		freeCounts[ findBlock( slot ) ]++;
+
+	// relink the free list without the slots of blocks about to be freed
+	sFreeSlot* freeList = nullptr;
+	for ( sFreeSlot* slot = m_pFreeList; slot; )
+	{
+		sFreeSlot* next = slot->pNext;
+		if ( freeCounts[ findBlock( slot ) ] != OBJECTS_PER_BLOCK )
+		{
+			slot->pNext = freeList;
+			freeList = slot;
+		}
+		slot = next;
+	}
+	m_pFreeList = freeList;
+
+	uint32_t numFreed = 0;
+	std::vector<uint8_t*> blocks;
+	for ( size_t i = 0; i < m_blocks.size(); i++ )
+	{
+		if ( freeCounts[ i ] == OBJECTS_PER_BLOCK )
+		{
+			::operator delete( m_blocks[ i ], std::align_val_t{ m_alignment } );
+			numFreed++;
+		}
+		else
+			blocks.push_back( m_blocks[ i ] );
+	}
+	m_blocks = blocks;
+
+	return numFreed;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+uint32_t wv::Pool::releaseUnused()
+{
+	std::scoped_lock lock( getPoolsMutex() );
+
+	uint32_t numFreed = 0;
+	for ( cPoolAllocator* pool : getPools() )
+		numFreed += pool->releaseUnused();
+
+	return numFreed;
+}
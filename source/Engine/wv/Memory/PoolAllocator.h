@@ -0,0 +1,136 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+#include <mutex>
+#include <type_traits>
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+namespace wv
+{
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	/// <summary>
+	/// Fixed size slab allocator. Memory is taken from the system one block of 
+	/// OBJECTS_PER_BLOCK slots at a time and freed slots are reused through an intrusive 
+	/// free list, so allocate and free never touch malloc once the pool has warmed up.
+	/// Blocks are only returned to the system by releaseUnused
+	/// </summary>
+	class cPoolAllocator
+	{
+	public:
+		static const uint32_t OBJECTS_PER_BLOCK = 64;
+
+		cPoolAllocator( size_t _objectSize, size_t _alignment );
+		~cPoolAllocator();
+
+		void* allocate();
+		void  free( void* _ptr );
+
+		/// <summary>
+		/// Frees every block that has no live objects left. Returns the number of blocks freed
+		/// </summary>
+		uint32_t releaseUnused();
+
+		size_t   getObjectSize()   { return m_objectSize; }
+		uint32_t getNumAllocated() { return m_numAllocated; }
+		uint32_t getNumBlocks()    { return (uint32_t)m_blocks.size(); }
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	private:
+
+		struct sFreeSlot
+		{
+			sFreeSlot* pNext;
+		};
+
+		std::mutex m_mutex;
+
+		size_t m_objectSize;
+		size_t m_alignment;
+		
+		std::vector<uint8_t*> m_blocks;
+		sFreeSlot* m_pFreeList = nullptr;
+		uint32_t m_numAllocated = 0;
+	};
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	namespace Pool
+	{
+		/// <summary>
+		/// Pool shared by every object of type T
+		/// </summary>
+		template<typename T>
+		cPoolAllocator& get()
+		{
+			static cPoolAllocator pool{ sizeof( T ), alignof( T ) };
+			return pool;
+		}
+
+		/// <summary>
+		/// Calls releaseUnused on every pool that has been created
+		/// </summary>
+		uint32_t releaseUnused();
+
+		template<typename T>
+		void* allocate( size_t _size )
+		{
+			// a derived class without its own pool ends up here with a different size
+			if ( _size != sizeof( T ) )
+				return ::operator new( _size );
+
+			return get<T>().allocate();
+		}
+
+		template<typename T>
+		void deallocate( void* _ptr, size_t _size )
+		{
+			if ( _size != sizeof( T ) )
+			{
+				::operator delete( _ptr );
+				return;
+			}
+
+			get<T>().free( _ptr );
+		}
+
+		/// <summary>
+		/// True for classes declared with WV_POOLED_CLASS, false for classes that only inherit it
+		/// </summary>
+		template<typename T, typename = void>
+		struct isPooled : std::false_type { };
+
+		template<typename T>
+		struct isPooled<T, std::void_t<typename T::tPooledClass>> : std::is_same<typename T::tPooledClass, T> { };
+
+		/// <summary>
+		/// Pool of T if it is pooled, nullptr otherwise. Never creates a pool for other classes
+		/// </summary>
+		template<typename T>
+		cPoolAllocator* find()
+		{
+			if constexpr ( isPooled<T>::value )
+				return &get<T>();
+			else
+				return nullptr;
+		}
+	}
+
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+/*
+ * routes new and delete of a class through Pool::get<_class>()
+ * the class has to have a virtual destructor if it is deleted through a base pointer
+ */
+#define WV_POOLED_CLASS( _class ) \
+typedef _class tPooledClass; \
+static void* operator new   ( size_t _size )             { return wv::Pool::allocate<_class>( _size ); } \
+static void  operator delete( void* _ptr, size_t _size ) { wv::Pool::deallocate<_class>( _ptr, _size ); }
@@ -4,59 +4,69 @@
 
 #if defined( WV_SUPPORT_PHYSICS ) && defined( WV_SUPPORT_JOLT_PHYSICS )
 
-wv::cBroadPhaseLayer::cBroadPhaseLayer()
+wv::cBroadPhaseLayer::cBroadPhaseLayer( const sPhysicsLayerConfig& _config )
 {
-	m_objectToBroadPhaseMapping[ Layers::STATIC ] = BroadPhaseLayers::STATIC;
-	m_objectToBroadPhaseMapping[ Layers::DYNAMIC ] = BroadPhaseLayers::DYNAMIC;
+	for ( int i = 0; i < WV_PHYSICS_LAYER_COUNT; i++ )
+		m_objectToBroadPhaseMapping[ i ] = JPH::BroadPhaseLayer( ( JPH::BroadPhaseLayer::Type )_config.broadPhaseLayer[ i ] );
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
 JPH::uint wv::cBroadPhaseLayer::GetNumBroadPhaseLayers() const
 {
-	return BroadPhaseLayers::NUM_LAYERS;
+	return WV_PHYSICS_BROADPHASE_COUNT;
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
 JPH::BroadPhaseLayer wv::cBroadPhaseLayer::GetBroadPhaseLayer( JPH::ObjectLayer inLayer ) const
 {
-	JPH_ASSERT( inLayer < Layers::NUM_LAYERS );
+	JPH_ASSERT( inLayer < WV_PHYSICS_LAYER_COUNT );
 	return m_objectToBroadPhaseMapping[ inLayer ];
 }
 
 #if defined( JPH_EXTERNAL_PROFILE ) || defined( JPH_PROFILE_ENABLED )
 const char* wv::cBroadPhaseLayer::GetBroadPhaseLayerName( JPH::BroadPhaseLayer inLayer ) const
 {
-	switch( ( JPH::BroadPhaseLayer::Type )inLayer )
+	return PhysicsLayers::getName( ( ePhysicsBroadPhaseLayer )( JPH::BroadPhaseLayer::Type )inLayer );
+}
+#endif
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cObjectVsBroadPhaseLayerFilter::setConfig( const sPhysicsLayerConfig& _config )
+{
+	for ( int layer = 0; layer < WV_PHYSICS_LAYER_COUNT; layer++ )
 	{
-	case ( JPH::BroadPhaseLayer::Type )BroadPhaseLayers::STATIC: return "NON_MOVING";
-	case ( JPH::BroadPhaseLayer::Type )BroadPhaseLayers::DYNAMIC:     return "MOVING";
-	default: JPH_ASSERT( false ); return "INVALID";
+		m_broadPhaseMask[ layer ] = 0;
+		
+		// a tree is worth visiting if any layer in it collides with this one
+		for ( int other = 0; other < WV_PHYSICS_LAYER_COUNT; other++ )
+		{
+			if ( _config.collides( (ePhysicsLayer)layer, (ePhysicsLayer)other ) )
+				m_broadPhaseMask[ layer ] |= 1u << _config.broadPhaseLayer[ other ];
+		}
 	}
 }
-#endif
+
+///////////////////////////////////////////////////////////////////////////////////////
 
 bool wv::cObjectLayerPairFilter::ShouldCollide( JPH::ObjectLayer inObject1, JPH::ObjectLayer inObject2 ) const
 {
-	switch( inObject1 )
-	{
-	case Layers::STATIC:  return inObject2 == Layers::DYNAMIC; // Static bodies only collides with dynamic bodies
-	case Layers::DYNAMIC: return true;                         // Dynamic bodies collides with everything
+	if ( inObject1 >= WV_PHYSICS_LAYER_COUNT || inObject2 >= WV_PHYSICS_LAYER_COUNT )
+		return false;
 
-	default: return false;
-	}
+	return m_config.collides( (ePhysicsLayer)inObject1, (ePhysicsLayer)inObject2 );
 }
 
+///////////////////////////////////////////////////////////////////////////////////////
+
 bool wv::cObjectVsBroadPhaseLayerFilter::ShouldCollide( JPH::ObjectLayer inLayer1, JPH::BroadPhaseLayer inLayer2 ) const
 {
-	switch( inLayer1 )
-	{
-	case Layers::STATIC:  return inLayer2 == wv::BroadPhaseLayers::DYNAMIC;
-	case Layers::DYNAMIC: return true;
+	if ( inLayer1 >= WV_PHYSICS_LAYER_COUNT )
+		return false;
 
-	default: return false;
-	}
+	return ( m_broadPhaseMask[ inLayer1 ] & ( 1u << ( JPH::BroadPhaseLayer::Type )inLayer2 ) ) != 0;
 }
 
 #endif // WV_SUPPORT_PHYSICS && WV_SUPPORT_JOLT_PHYSICS
\ No newline at end of file
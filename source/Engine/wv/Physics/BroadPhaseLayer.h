@@ -6,36 +6,20 @@
 #include <Jolt/Physics/PhysicsSettings.h>
 #include <Jolt/Physics/PhysicsSystem.h>
 
+#include <wv/Physics/PhysicsLayers.h>
+
 ///////////////////////////////////////////////////////////////////////////////////////
 
 namespace wv
 {
 
-///////////////////////////////////////////////////////////////////////////////////////
-
-	namespace Layers
-	{
-		static constexpr JPH::ObjectLayer STATIC = 0;
-		static constexpr JPH::ObjectLayer DYNAMIC = 1;
-		static constexpr JPH::ObjectLayer NUM_LAYERS = 2;
-	};
-
-///////////////////////////////////////////////////////////////////////////////////////
-
-	namespace BroadPhaseLayers
-	{
-		static constexpr JPH::BroadPhaseLayer STATIC( 0 );
-		static constexpr JPH::BroadPhaseLayer DYNAMIC( 1 );
-		static constexpr JPH::uint NUM_LAYERS( 2 );
-	};
-
 ///////////////////////////////////////////////////////////////////////////////////////
 
 	class cBroadPhaseLayer : public JPH::BroadPhaseLayerInterface
 	{
 
 	public:
-		cBroadPhaseLayer();
+		cBroadPhaseLayer( const sPhysicsLayerConfig& _config );
 
 		virtual JPH::uint GetNumBroadPhaseLayers() const override;
 		virtual JPH::BroadPhaseLayer GetBroadPhaseLayer( JPH::ObjectLayer inLayer ) const override;
@@ -47,7 +31,7 @@ namespace wv
 
 	private:
 	
-		JPH::BroadPhaseLayer m_objectToBroadPhaseMapping[ Layers::NUM_LAYERS ];
+		JPH::BroadPhaseLayer m_objectToBroadPhaseMapping[ WV_PHYSICS_LAYER_COUNT ];
 
 	};
 
@@ -56,8 +40,20 @@ namespace wv
 	class cObjectVsBroadPhaseLayerFilter : public JPH::ObjectVsBroadPhaseLayerFilter
 	{
 	public:
+		cObjectVsBroadPhaseLayerFilter( const sPhysicsLayerConfig& _config ) { setConfig( _config ); }
+
+		/// <summary>
+		/// Rebuilds the per layer broad phase masks, not safe while the simulation is stepping
+		/// </summary>
+		void setConfig( const sPhysicsLayerConfig& _config );
+
 		virtual bool ShouldCollide( JPH::ObjectLayer inLayer1, JPH::BroadPhaseLayer inLayer2 ) const override;
 
+	private:
+		
+		// bit n is set if the layer collides with anything in broad phase layer n
+		uint32_t m_broadPhaseMask[ WV_PHYSICS_LAYER_COUNT ];
+
 	};
 
 ///////////////////////////////////////////////////////////////////////////////////////
@@ -65,8 +61,16 @@ namespace wv
 	class cObjectLayerPairFilter : public JPH::ObjectLayerPairFilter
 	{
 	public:
+		cObjectLayerPairFilter( const sPhysicsLayerConfig& _config ) { setConfig( _config ); }
+
+		void setConfig( const sPhysicsLayerConfig& _config ) { m_config = _config; }
+
 		virtual bool ShouldCollide( JPH::ObjectLayer inObject1, JPH::ObjectLayer inObject2 ) const override;
 
+	private:
+
+		sPhysicsLayerConfig m_config;
+
 	};
 
 }
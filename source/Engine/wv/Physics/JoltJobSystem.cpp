@@ -0,0 +1,104 @@
+#ifdef WV_SUPPORT_JOLT_PHYSICS
+
+#include "JoltJobSystem.h"
+
+#include <wv/Thread/TaskScheduler.h>
+
+#include <thread>
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+wv::cJoltJobSystem::cJoltJobSystem( cTaskScheduler* _pTaskScheduler, JPH::uint _maxJobs, JPH::uint _maxBarriers ) :
+	JobSystemWithBarrier( _maxBarriers ),
+	m_pTaskScheduler{ _pTaskScheduler }
+{
+	m_jobs.Init( _maxJobs, _maxJobs );
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+wv::cJoltJobSystem::~cJoltJobSystem()
+{
+	// the thread waiting on a barrier often runs a job before its task does, 
+	// so tasks can still be queued after the step has returned
+	while ( m_numInFlight.load( std::memory_order_acquire ) > 0 )
+	{
+		if ( !m_pTaskScheduler->runPendingTask() )
+			std::this_thread::yield();
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+int wv::cJoltJobSystem::GetMaxConcurrency() const
+{
+	// the thread waiting on the barrier runs jobs as well
+	return m_pTaskScheduler->getNumWorkers() + 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+JPH::JobSystem::JobHandle wv::cJoltJobSystem::CreateJob( const char* inName, JPH::ColorArg inColor, const JobFunction& inJobFunction, JPH::uint32 inNumDependencies )
+{
+	JPH::uint32 index;
+	while ( true )
+	{
+		index = m_jobs.ConstructObject( inName, inColor, this, inJobFunction, inNumDependencies );
+		if ( index != JPH::FixedSizeFreeList<Job>::cInvalidObjectIndex )
+			break;
+
+		JPH_ASSERT( false, "No jobs available!" );
+		std::this_thread::yield();
+	}
+
+	Job* job = &m_jobs.Get( index );
+	
+	// the handle keeps the job alive, it may finish before this returns
+	JobHandle handle( job );
+	
+	if ( inNumDependencies == 0 )
+		QueueJob( job );
+
+	return handle;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cJoltJobSystem::QueueJob( Job* inJob )
+{
+	// released by executeJob
+	inJob->AddRef();
+	m_numInFlight.fetch_add( 1, std::memory_order_relaxed );
+	m_pTaskScheduler->submit( executeJob, inJob, WV_TASK_PRIORITY_HIGH );
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cJoltJobSystem::QueueJobs( Job** inJobs, JPH::uint inNumJobs )
+{
+	for ( JPH::uint i = 0; i < inNumJobs; i++ )
+		QueueJob( inJobs[ i ] );
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cJoltJobSystem::FreeJob( Job* inJob )
+{
+	m_jobs.DestructObject( inJob );
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cJoltJobSystem::executeJob( void* _pJob )
+{
+	Job* job = (Job*)_pJob;
+	cJoltJobSystem* jobSystem = (cJoltJobSystem*)job->GetJobSystem();
+
+	job->Execute();
+	job->Release();
+
+	// the job system may be destroyed as soon as this reaches zero
+	jobSystem->m_numInFlight.fetch_sub( 1, std::memory_order_release );
+}
+
+#endif // WV_SUPPORT_JOLT_PHYSICS
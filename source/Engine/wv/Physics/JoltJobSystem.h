@@ -0,0 +1,52 @@
+#pragma once
+
+#ifdef WV_SUPPORT_JOLT_PHYSICS
+
+#include <Jolt/Jolt.h>
+#include <Jolt/Core/JobSystemWithBarrier.h>
+#include <Jolt/Core/FixedSizeFreeList.h>
+
+#include <atomic>
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+namespace wv
+{
+	class cTaskScheduler;
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	/// <summary>
+	/// Runs Jolt jobs on the engine task scheduler instead of a thread pool of its own
+	/// </summary>
+	class cJoltJobSystem : public JPH::JobSystemWithBarrier
+	{
+	public:
+		 cJoltJobSystem( cTaskScheduler* _pTaskScheduler, JPH::uint _maxJobs, JPH::uint _maxBarriers );
+		~cJoltJobSystem();
+
+		virtual int            GetMaxConcurrency() const override;
+		virtual JobHandle      CreateJob        ( const char* inName, JPH::ColorArg inColor, const JobFunction& inJobFunction, JPH::uint32 inNumDependencies = 0 ) override;
+
+	protected:
+		virtual void QueueJob ( Job* inJob )                         override;
+		virtual void QueueJobs( Job** inJobs, JPH::uint inNumJobs ) override;
+		virtual void FreeJob  ( Job* inJob )                         override;
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	private:
+
+		static void executeJob( void* _pJob );
+
+		cTaskScheduler* m_pTaskScheduler = nullptr;
+
+		JPH::FixedSizeFreeList<Job> m_jobs;
+
+		// queued scheduler tasks that have not released their job yet
+		std::atomic<int> m_numInFlight{ 0 };
+	};
+
+}
+
+#endif // WV_SUPPORT_JOLT_PHYSICS
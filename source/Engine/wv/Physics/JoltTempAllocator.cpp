@@ -0,0 +1,28 @@
+#ifdef WV_SUPPORT_JOLT_PHYSICS
+
+#include "JoltTempAllocator.h"
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void* wv::cJoltTempAllocator::Allocate( JPH::uint inSize )
+{
+	void* address = m_allocator.Allocate( inSize );
+
+	m_usage += inSize;
+	if( m_usage > m_highWater )
+		m_highWater = m_usage;
+
+	return address;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cJoltTempAllocator::Free( void* inAddress, JPH::uint inSize )
+{
+	m_allocator.Free( inAddress, inSize );
+	m_usage -= inSize;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#endif // WV_SUPPORT_JOLT_PHYSICS
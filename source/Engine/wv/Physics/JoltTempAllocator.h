@@ -0,0 +1,52 @@
+#pragma once
+
+#ifdef WV_SUPPORT_JOLT_PHYSICS
+
+#include <Jolt/Jolt.h>
+#include <Jolt/Core/TempAllocator.h>
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+namespace wv
+{
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	/// <summary>
+	/// Jolt's stack temp allocator, keeping track of how much of it is in use
+	/// </summary>
+	class cJoltTempAllocator : public JPH::TempAllocator
+	{
+	public:
+		cJoltTempAllocator( JPH::uint _size ) : 
+			m_allocator{ _size },
+			m_size{ _size }
+		{ }
+
+		virtual void* Allocate( JPH::uint inSize )                     override;
+		virtual void  Free    ( void* inAddress, JPH::uint inSize )    override;
+
+		JPH::uint getSize()      const { return m_size; }
+		JPH::uint getUsage()     const { return m_usage; }
+		JPH::uint getHighWater() const { return m_highWater; }
+
+		/// <summary>
+		/// Starts tracking a new high-water mark from the current usage
+		/// </summary>
+		void resetHighWater() { m_highWater = m_usage; }
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	private:
+
+		// jobs allocate and free in stack order enforced by their dependencies, so no locking is needed
+		JPH::TempAllocatorImpl m_allocator;
+
+		JPH::uint m_size      = 0;
+		JPH::uint m_usage     = 0;
+		JPH::uint m_highWater = 0;
+	};
+
+}
+
+#endif // WV_SUPPORT_JOLT_PHYSICS
@@ -2,12 +2,18 @@
 
 #include <wv/Math/Vector3.h>
 #include <wv/Math/Transform.h>
+#include <wv/Memory/PoolAllocator.h>
+#include <wv/Physics/PhysicsLayers.h>
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
 namespace wv
 {
 
+///////////////////////////////////////////////////////////////////////////////////////
+
+	class cPhysicsShapeResource;
+
 ///////////////////////////////////////////////////////////////////////////////////////
 
 	enum ePhysicsShape
@@ -37,8 +43,11 @@ namespace wv
 
 	struct iPhysicsBodyDesc
 	{
+		virtual ~iPhysicsBodyDesc() { }
+
 		ePhysicsShape shape = WV_PHYSICS_NONE;
 		ePhysicsKind kind = WV_PHYSICS_STATIC;
+		ePhysicsLayer layer = WV_PHYSICS_LAYER_DEFAULT;
 		Transformf transform{};
 	};
 	
@@ -47,6 +56,8 @@ namespace wv
 	struct sPhysicsBoxDesc : public iPhysicsBodyDesc
 	{
 		sPhysicsBoxDesc() { shape = WV_PHYSICS_BOX; }
+		WV_POOLED_CLASS( sPhysicsBoxDesc );
+
 		cVector3f halfExtent{};
 	};
 
@@ -55,7 +66,23 @@ namespace wv
 	struct sPhysicsSphereDesc : public iPhysicsBodyDesc
 	{
 		sPhysicsSphereDesc() { shape = WV_PHYSICS_SPHERE; }
+		WV_POOLED_CLASS( sPhysicsSphereDesc );
+
 		float radius = 1.0f;
 	};
 
+///////////////////////////////////////////////////////////////////////////////////////
+
+	/// <summary>
+	/// Mesh or convex hull shape cooked ahead of time, the resource has to be complete
+	/// before the body is created
+	/// </summary>
+	struct sPhysicsCookedShapeDesc : public iPhysicsBodyDesc
+	{
+		sPhysicsCookedShapeDesc( ePhysicsShape _shape = WV_PHYSICS_MESH ) { shape = _shape; }
+		WV_POOLED_CLASS( sPhysicsCookedShapeDesc );
+
+		cPhysicsShapeResource* pResource = nullptr;
+	};
+
 }
\ No newline at end of file
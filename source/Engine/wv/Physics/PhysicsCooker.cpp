@@ -0,0 +1,162 @@
+#include "PhysicsCooker.h"
+
+#ifdef WV_SUPPORT_JOLT_PHYSICS
+#include <Jolt/Core/StreamWrapper.h>
+#include <Jolt/Physics/Collision/Shape/MeshShape.h>
+#include <Jolt/Physics/Collision/Shape/ConvexHullShape.h>
+#endif // WV_SUPPORT_JOLT_PHYSICS
+
+#include <wv/Primitive/Mesh.h>
+#include <wv/Math/Matrix.h>
+#include <wv/Debug/Print.h>
+
+#include <sstream>
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+static const char* s_meshSuffix = ".mesh.wcol";
+static const char* s_hullSuffix = ".hull.wcol";
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+std::string wv::PhysicsCooker::getCookedPath( const std::string& _sourcePath, ePhysicsShape _shape )
+{
+	return _sourcePath + ( _shape == WV_PHYSICS_CONVECT_HULL ? s_hullSuffix : s_meshSuffix );
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+bool wv::PhysicsCooker::parseCookedPath( const std::string& _cookedPath, std::string& _sourcePath, ePhysicsShape& _shape )
+{
+	const std::string mesh = s_meshSuffix;
+	const std::string hull = s_hullSuffix;
+
+	if( _cookedPath.size() > mesh.size() && _cookedPath.compare( _cookedPath.size() - mesh.size(), mesh.size(), mesh ) == 0 )
+	{
+		_sourcePath = _cookedPath.substr( 0, _cookedPath.size() - mesh.size() );
+		_shape = WV_PHYSICS_MESH;
+		return true;
+	}
+
+	if( _cookedPath.size() > hull.size() && _cookedPath.compare( _cookedPath.size() - hull.size(), hull.size(), hull ) == 0 )
+	{
+		_sourcePath = _cookedPath.substr( 0, _cookedPath.size() - hull.size() );
+		_shape = WV_PHYSICS_CONVECT_HULL;
+		return true;
+	}
+
+	return false;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#ifdef WV_SUPPORT_JOLT_PHYSICS
+static void gatherTriangles( wv::sMeshNode* _pNode, JPH::TriangleList& _out )
+{
+	for( wv::sMesh* mesh : _pNode->meshes )
+	{
+		const wv::cMatrix4x4f& matrix = mesh->transform.getMatrix();
+
+		for( const wv::Triangle3f& triangle : mesh->triangles )
+		{
+			const wv::cVector3f a = wv::Matrix::transformPoint( matrix, triangle.v0 );
+			const wv::cVector3f b = wv::Matrix::transformPoint( matrix, triangle.v1 );
+			const wv::cVector3f c = wv::Matrix::transformPoint( matrix, triangle.v2 );
+
+			_out.push_back( JPH::Triangle( JPH::Float3( a.x, a.y, a.z ), JPH::Float3( b.x, b.y, b.z ), JPH::Float3( c.x, c.y, c.z ) ) );
+		}
+	}
+
+	for( wv::sMeshNode* child : _pNode->children )
+		gatherTriangles( child, _out );
+}
+#endif // WV_SUPPORT_JOLT_PHYSICS
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+bool wv::PhysicsCooker::cook( sMeshNode* _pNode, ePhysicsShape _shape, std::vector<uint8_t>& _out )
+{
+#ifdef WV_SUPPORT_JOLT_PHYSICS
+	if( !_pNode )
+		return false;
+
+	// mesh matrices relative to the root node
+	_pNode->transform.update( nullptr );
+
+	JPH::TriangleList triangles;
+	gatherTriangles( _pNode, triangles );
+
+	if( triangles.empty() )
+	{
+		Debug::Print( Debug::WV_PRINT_ERROR, "Cannot cook a physics shape without triangles\n" );
+		return false;
+	}
+
+	JPH::Shape::ShapeResult result;
+	switch( _shape )
+	{
+	case WV_PHYSICS_MESH:
+	{
+		JPH::MeshShapeSettings settings( triangles );
+		result = settings.Create();
+	} break;
+
+	case WV_PHYSICS_CONVECT_HULL:
+	{
+		JPH::Array<JPH::Vec3> points;
+		points.reserve( triangles.size() * 3 );
+		for( const JPH::Triangle& triangle : triangles )
+		{
+			for( int i = 0; i < 3; i++ )
+				points.push_back( JPH::Vec3( triangle.mV[ i ] ) );
+		}
+
+		JPH::ConvexHullShapeSettings settings( points );
+		result = settings.Create();
+	} break;
+
+	default:
+		Debug::Print( Debug::WV_PRINT_ERROR, "Only mesh and convex hull shapes can be cooked\n" );
+		return false;
+	}
+
+	if( result.HasError() )
+	{
+		Debug::Print( Debug::WV_PRINT_ERROR, "Failed to cook physics shape: %s\n", result.GetError().c_str() );
+		return false;
+	}
+
+	std::stringstream stream;
+	JPH::StreamOutWrapper out( stream );
+	result.Get()->SaveBinaryState( out );
+
+	if( out.IsFailed() )
+		return false;
+
+	const std::string data = stream.str();
+	_out.assign( data.begin(), data.end() );
+	return true;
+#else
+	Debug::Print( Debug::WV_PRINT_ERROR, "Cooking physics shapes requires Jolt Physics\n" );
+	return false;
+#endif // WV_SUPPORT_JOLT_PHYSICS
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#ifdef WV_SUPPORT_JOLT_PHYSICS
+JPH::ShapeRefC wv::PhysicsCooker::restore( const uint8_t* _pData, size_t _size )
+{
+	std::stringstream stream( std::string( (const char*)_pData, _size ) );
+	JPH::StreamInWrapper in( stream );
+
+	JPH::Shape::ShapeResult result = JPH::Shape::sRestoreFromBinaryState( in );
+	if( result.HasError() )
+	{
+		Debug::Print( Debug::WV_PRINT_ERROR, "Failed to restore physics shape: %s\n", result.GetError().c_str() );
+		return nullptr;
+	}
+
+	return result.Get();
+}
+#endif // WV_SUPPORT_JOLT_PHYSICS
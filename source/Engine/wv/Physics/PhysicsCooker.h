@@ -0,0 +1,53 @@
+#pragma once
+
+#include <wv/Physics/PhysicsBodyDescriptor.h>
+
+#ifdef WV_SUPPORT_JOLT_PHYSICS
+#include <Jolt/Jolt.h>
+#include <Jolt/Physics/Collision/Shape/Shape.h>
+#endif // WV_SUPPORT_JOLT_PHYSICS
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+namespace wv
+{
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	struct sMeshNode;
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	/// <summary>
+	/// Turns imported mesh geometry into serialized Jolt shapes so nothing has to be 
+	/// triangulated or hulled when a level is loaded
+	/// </summary>
+	namespace PhysicsCooker
+	{
+		/// <summary>
+		/// res/meshes/level.dae -> res/meshes/level.dae.mesh.wcol or res/meshes/level.dae.hull.wcol
+		/// </summary>
+		std::string getCookedPath( const std::string& _sourcePath, ePhysicsShape _shape );
+		
+		/// <summary>
+		/// Inverse of getCookedPath, false if _cookedPath is not a cooked shape path
+		/// </summary>
+		bool parseCookedPath( const std::string& _cookedPath, std::string& _sourcePath, ePhysicsShape& _shape );
+
+		/// <summary>
+		/// Builds a triangle mesh or convex hull from every mesh below _pNode, in the space 
+		/// of _pNode, and writes it with SaveBinaryState
+		/// </summary>
+		bool cook( sMeshNode* _pNode, ePhysicsShape _shape, std::vector<uint8_t>& _out );
+
+	#ifdef WV_SUPPORT_JOLT_PHYSICS
+		JPH::ShapeRefC restore( const uint8_t* _pData, size_t _size );
+	#endif // WV_SUPPORT_JOLT_PHYSICS
+	}
+
+}
@@ -6,17 +6,25 @@
 
 #include <Jolt/RegisterTypes.h>
 #include <Jolt/Core/Factory.h>
-#include <Jolt/Core/TempAllocator.h>
-#include <Jolt/Core/JobSystemThreadPool.h>
 #include <Jolt/Physics/PhysicsSettings.h>
 #include <Jolt/Physics/PhysicsSystem.h>
+#include <Jolt/Physics/StateRecorderImpl.h>
 #include <Jolt/Physics/Collision/Shape/BoxShape.h>
 #include <Jolt/Physics/Collision/Shape/SphereShape.h>
+#include <Jolt/Physics/Collision/Shape/ScaledShape.h>
 #include <Jolt/Physics/Body/BodyCreationSettings.h>
 #include <Jolt/Physics/Body/BodyActivationListener.h>
+#include <Jolt/Physics/Body/BodyLockInterface.h>
+#include <Jolt/Physics/Collision/NarrowPhaseQuery.h>
+#include <Jolt/Physics/Collision/RayCast.h>
+#include <Jolt/Physics/Collision/CastResult.h>
+#include <Jolt/Physics/Collision/ShapeCast.h>
+#include <Jolt/Physics/Collision/CollideShape.h>
+#include <Jolt/Physics/Collision/CollisionCollectorImpl.h>
 
 #include <Jolt/Physics/Constraints/PulleyConstraint.h>
 #include <Jolt/Physics/Constraints/DistanceConstraint.h>
+#include <Jolt/Physics/Constraints/TwoBodyConstraint.h>
 #endif // WV_SUPPORT_JOLT_PHYSICS
 
 #include <wv/Engine/Engine.h>
@@ -25,10 +33,17 @@
 
 #include <wv/Camera/Camera.h>
 #include <wv/Physics/PhysicsListeners.h>
+#include <wv/Physics/JoltJobSystem.h>
+#include <wv/Physics/JoltTempAllocator.h>
+#include <wv/Physics/PhysicsShapeResource.h>
 
 #include <stdarg.h>
 #include <cstdarg>
 #include <iostream>
+#include <functional>
+#include <algorithm>
+#include <chrono>
+#include <mutex>
 
 #ifdef WV_SUPPORT_JOLT_PHYSICS
 JPH_SUPPRESS_WARNINGS
@@ -46,213 +61,1216 @@ static JPH::Vec3 WVtoJPH( const wv::cVector3f& _vec )
 {
 	return { _vec.x, _vec.y, _vec.z };
 }
+
+static wv::cQuaternionf JPHtoWV( const JPH::Quat& _quat )
+{
+	return { _quat.GetX(), _quat.GetY(), _quat.GetZ(), _quat.GetW() };
+}
+
+static JPH::Quat WVtoJPH( const wv::cQuaternionf& _quat )
+{
+	return JPH::Quat{ _quat.v.x, _quat.v.y, _quat.v.z, _quat.s }.Normalized();
+}
+#endif // WV_SUPPORT_JOLT_PHYSICS
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#ifdef WV_SUPPORT_JOLT_PHYSICS
+static void traceImpl( const char* _msg, ... )
+{
+	/// TODO: change to wv::Debug::Print()
+	va_list list;
+	va_start( list, _msg );
+	vprintf( _msg, list );
+	printf( "\n" );
+	va_end( list );
+}
+#ifdef JPH_ENABLE_ASSERTS
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+// Callback for asserts, connect this to your own assert handler if you have one
+static bool AssertFailedImpl( const char* inExpression, const char* inMessage, const char* inFile, JPH::uint inLine )
+{
+	// Print to the TTY
+	std::cout << inFile << ":" << inLine << ": (" << inExpression << ") " << ( inMessage != nullptr ? inMessage : "" ) << std::endl;
+
+	// Breakpoint
+	return true;
+};
+
+#endif // JPH_ENABLE_ASSERTS
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+// the allocator, factory and type registry are process wide and shared by every engine
+static std::mutex s_joltMutex;
+static uint32_t   s_numJoltUsers = 0;
+
+static void acquireJolt()
+{
+	std::unique_lock<std::mutex> lock( s_joltMutex );
+	if( s_numJoltUsers++ > 0 )
+		return;
+
+	JPH::RegisterDefaultAllocator();
+	
+	JPH::Trace = traceImpl;
+	JPH_IF_ENABLE_ASSERTS( JPH::AssertFailed = AssertFailedImpl; )
+
+	JPH::Factory::sInstance = new JPH::Factory();
+
+	JPH::RegisterTypes();
+}
+
+static void releaseJolt()
+{
+	std::unique_lock<std::mutex> lock( s_joltMutex );
+	if( --s_numJoltUsers > 0 )
+		return;
+
+	// Unregisters all types with the factory and cleans up the default material
+	JPH::UnregisterTypes();
+
+	// Destroy the factory
+	delete JPH::Factory::sInstance;
+	JPH::Factory::sInstance = nullptr;
+}
+#endif // WV_SUPPORT_JOLT_PHYSICS
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cJoltPhysicsEngine::init( cTaskScheduler* _pTaskScheduler )
+{
+	m_pTaskScheduler = _pTaskScheduler;
+
+#ifdef WV_SUPPORT_JOLT_PHYSICS
+	using namespace JPH::literals;
+
+	acquireJolt();
+
+	m_pTempAllocator = new cJoltTempAllocator( 10 * 1024 * 1024 );
+	m_pJobSystem     = new cJoltJobSystem( m_pTaskScheduler, JPH::cMaxPhysicsJobs, JPH::cMaxPhysicsBarriers );
+
+	m_pEventBuffer = new cPhysicsEventBuffer( m_pTaskScheduler );
+
+	tempContactListener = new cJoltContactListener( m_pEventBuffer );
+	tempBodyActivationListener = new cJoltBodyActivationListener( m_pEventBuffer );
+
+	createPhysicsSystem();
+
+	m_previousPoses.resize( m_maxBodies );
+	m_islandSlots.assign( m_maxBodies, -1 );
+
+
+	sPhysicsSphereDesc* ballDesc = new sPhysicsSphereDesc();
+	ballDesc->kind = WV_PHYSICS_KINEMATIC;
+	ballDesc->radius = 1.0f;
+
+#else
+	wv::Debug::Print( Debug::WV_PRINT_ERROR, "Jolt Physics is not supported on this platform\n" );
+#endif // WV_SUPPORT_JOLT_PHYSICS
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cJoltPhysicsEngine::terminate()
+{
+#ifdef WV_SUPPORT_JOLT_PHYSICS
+	waitForStep();
+
+	delete m_pJobSystem;
+	m_pJobSystem = nullptr;
+
+	// the listeners only push from within a step
+	delete m_pEventBuffer;
+	m_pEventBuffer = nullptr;
+
+	// remaining bodies go with the system, shapes shared with other engines keep their own references
+	destroyPhysicsSystem();
+	m_bodies.clear();
+
+	delete tempContactListener;
+	delete tempBodyActivationListener;
+	tempContactListener        = nullptr;
+	tempBodyActivationListener = nullptr;
+
+	delete m_pTempAllocator;
+	m_pTempAllocator = nullptr;
+
+	m_shapeCache.clear();
+	m_snapshots.clear();
+
+	releaseJolt();
+#endif // WV_SUPPORT_JOLT_PHYSICS
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#ifdef WV_SUPPORT_JOLT_PHYSICS
+
+void wv::cJoltPhysicsEngine::createPhysicsSystem()
+{
+	m_pBroadPhaseLayer               = new cBroadPhaseLayer( m_layerConfig );
+	m_pObjectVsBroadPhaseLayerFilter = new cObjectVsBroadPhaseLayerFilter( m_layerConfig );
+	m_pObjectLayerPairFilter         = new cObjectLayerPairFilter( m_layerConfig );
+
+	m_pPhysicsSystem = new JPH::PhysicsSystem();
+	m_pPhysicsSystem->Init(
+		m_maxBodies, m_numBodyMutexes, m_maxBodyPairs, m_maxContactConstraints,
+		*m_pBroadPhaseLayer, 
+		*m_pObjectVsBroadPhaseLayerFilter, 
+		*m_pObjectLayerPairFilter );
+
+	m_pPhysicsSystem->SetContactListener( tempContactListener );
+	m_pPhysicsSystem->SetBodyActivationListener( tempBodyActivationListener );
+
+	m_pBodyInterface = &m_pPhysicsSystem->GetBodyInterface();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cJoltPhysicsEngine::destroyPhysicsSystem()
+{
+	delete m_pPhysicsSystem;
+	m_pPhysicsSystem = nullptr;
+	m_pBodyInterface = nullptr;
+
+	delete m_pBroadPhaseLayer;
+	delete m_pObjectVsBroadPhaseLayerFilter;
+	delete m_pObjectLayerPairFilter;
+	m_pBroadPhaseLayer               = nullptr;
+	m_pObjectVsBroadPhaseLayerFilter = nullptr;
+	m_pObjectLayerPairFilter         = nullptr;
+}
+
+#endif // WV_SUPPORT_JOLT_PHYSICS
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cJoltPhysicsEngine::killAllPhysicsBodies()
+{
+#ifdef WV_SUPPORT_JOLT_PHYSICS
+	waitForStep();
+
+	for( auto& body : m_bodies )
+	{
+		// bodies from an unfinished batch were never added
+		if( body.second->IsInBroadPhase() )
+			m_pBodyInterface->RemoveBody( body.second->GetID() );
+		m_pBodyInterface->DestroyBody( body.second->GetID() );
+	}
+
+	m_bodies.clear();
+	m_batchActivate.clear();
+	m_batchDontActivate.clear();
+
+	// they refer to bodies that no longer exist
+	clearSnapshots();
+	
+	releaseUnusedShapes();
+#endif // WV_SUPPORT_JOLT_PHYSICS
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cJoltPhysicsEngine::destroyPhysicsBody( hPhysicsBody& _handle )
+{
+#ifdef WV_SUPPORT_JOLT_PHYSICS
+	waitForStep();
+
+	if( !m_bodies.contains( _handle.value() ) )
+	{
+		wv::Debug::Print( Debug::WV_PRINT_ERROR, "No Physics Body with Handle %i\n", _handle );
+		return;
+	}
+
+	JPH::Body* body = m_bodies.at( _handle.value() );
+	JPH::BodyID id = body->GetID();
+
+	if( body->IsInBroadPhase() )
+		m_pBodyInterface->RemoveBody( id );
+	else
+	{
+		// still waiting for its batch to end
+		std::erase( m_batchActivate, id );
+		std::erase( m_batchDontActivate, id );
+	}
+
+	m_pBodyInterface->DestroyBody( id );
+	m_bodies.erase( _handle.value() );
+	_handle.invalidate();
+#endif // WV_SUPPORT_JOLT_PHYSICS
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cJoltPhysicsEngine::update( double _deltaTime )
+{
+#ifdef WV_SUPPORT_JOLT_PHYSICS
+	// results of the previous async step become visible here
+	waitForStep();
+
+	float frameTime = wv::Math::min( _deltaTime, 0.05 );
+	
+	m_accumulator += frameTime;
+
+	int numSteps = 0;
+	while( m_accumulator >= m_timestep )
+	{
+		numSteps++;
+		m_accumulator -= m_timestep;
+	}
+
+	const float alpha = m_accumulator / m_timestep;
+	
+	if( numSteps == 0 )
+	{
+		// nothing new to show, keep blending the last published states
+		m_interpolationAlpha = alpha;
+		publishEvents();
+		return;
+	}
+
+	m_stepAlpha = alpha;
+	
+	if( m_asyncStepping )
+	{
+		// events of the step that just finished go with the transforms it published
+		publishEvents();
+
+		m_pendingSteps = numSteps;
+		m_pStepTask = m_pTaskScheduler->createTask( stepTask, this, WV_TASK_PRIORITY_NORMAL );
+		m_pTaskScheduler->submit( m_pStepTask );
+	}
+	else
+	{
+		step( numSteps );
+		waitForStep();
+		publishEvents();
+	}
+#endif // WV_SUPPORT_JOLT_PHYSICS
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cJoltPhysicsEngine::setAsyncStepping( bool _async )
+{
+#ifdef WV_SUPPORT_JOLT_PHYSICS
+	waitForStep();
+	m_asyncStepping = _async;
+#endif // WV_SUPPORT_JOLT_PHYSICS
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+uint32_t wv::cJoltPhysicsEngine::saveSnapshot()
+{
+#ifdef WV_SUPPORT_JOLT_PHYSICS
+	waitForStep();
+
+	if( m_snapshots.size() < m_snapshotCapacity )
+		m_snapshots.emplace_back();
+
+	sPhysicsSnapshot& snapshot = m_snapshots[ m_nextSnapshot ];
+	m_nextSnapshot = ( m_nextSnapshot + 1 ) % m_snapshotCapacity;
+
+	JPH::StateRecorderImpl recorder;
+	m_pPhysicsSystem->SaveState( recorder );
+
+	snapshot.step        = m_steps;
+	snapshot.accumulator = m_accumulator;
+	snapshot.numBodies   = m_bodies.size();
+	snapshot.data        = recorder.GetData();
+
+	snapshot.touchingPairs = m_pEventBuffer->getTouchingPairs();
+#endif // WV_SUPPORT_JOLT_PHYSICS
+
+	return m_steps;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+bool wv::cJoltPhysicsEngine::restoreSnapshot( uint32_t _step )
+{
+#ifdef WV_SUPPORT_JOLT_PHYSICS
+	waitForStep();
+
+	sPhysicsSnapshot* best = nullptr;
+	for( sPhysicsSnapshot& snapshot : m_snapshots )
+	{
+		if( snapshot.step <= _step && ( !best || snapshot.step > best->step ) )
+			best = &snapshot;
+	}
+
+	if( !best )
+	{
+		Debug::Print( Debug::WV_PRINT_WARN, "No physics snapshot at or before step %u\n", _step );
+		return false;
+	}
+
+	return restoreFromSnapshot( *best );
+#else
+	return false;
+#endif // WV_SUPPORT_JOLT_PHYSICS
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+bool wv::cJoltPhysicsEngine::restoreLatestSnapshot()
+{
+	if( m_snapshots.empty() )
+		return false;
+
+	// the slot before the next one to be written
+	const uint32_t latest = ( m_nextSnapshot + (uint32_t)m_snapshots.size() - 1 ) % (uint32_t)m_snapshots.size();
+
+#ifdef WV_SUPPORT_JOLT_PHYSICS
+	waitForStep();
+	return restoreFromSnapshot( m_snapshots[ latest ] );
+#else
+	return false;
+#endif // WV_SUPPORT_JOLT_PHYSICS
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cJoltPhysicsEngine::clearSnapshots()
+{
+	m_snapshots.clear();
+	m_nextSnapshot = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cJoltPhysicsEngine::setSnapshotCapacity( uint32_t _capacity )
+{
+	if( _capacity == 0 )
+		_capacity = 1;
+
+	// the ring order is lost when resized
+	clearSnapshots();
+	m_snapshotCapacity = _capacity;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#ifdef WV_SUPPORT_JOLT_PHYSICS
+struct sQueryContext
+{
+	const JPH::NarrowPhaseQuery*        pQuery            = nullptr;
+	const JPH::BodyLockInterfaceNoLock* pLockInterface    = nullptr;
+	const JPH::BroadPhaseLayerFilter*   pBroadPhaseFilter = nullptr;
+	const JPH::ObjectLayerFilter*       pObjectFilter     = nullptr;
+
+	// shape casts and overlaps only
+	const JPH::Shape* pShape   = nullptr;
+	JPH::Quat         rotation = JPH::Quat::sIdentity();
+	JPH::Vec3         scale    = JPH::Vec3::sReplicate( 1.0f );
+
+	uint32_t count    = 0;
+	uint32_t perTask  = 0;
+	void*    pBatch   = nullptr;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+static void writeCastHit( wv::sPhysicsCastResults& _results, uint32_t _index, const JPH::Body* _pBody, float _fraction, JPH::RVec3Arg _point, JPH::Vec3Arg _normal )
+{
+	// user data is ( owner user data << 32 ) | body handle
+	const JPH::uint64 userData = _pBody->GetUserData();
+
+	_results.hits     [ _index ] = 1;
+	_results.fractions[ _index ] = _fraction;
+	_results.points   [ _index ] = wv::cVector3f{ (float)_point.GetX(), (float)_point.GetY(), (float)_point.GetZ() };
+	_results.normals  [ _index ] = JPHtoWV( _normal );
+	_results.bodies   [ _index ] = wv::hPhysicsBody{ (wv::Handle)( userData & 0xFFFFFFFF ) };
+	_results.userData [ _index ] = (uint32_t)( userData >> 32 );
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+static void castRaysTask( void* _pUserData, uint32_t _task )
+{
+	sQueryContext* context = (sQueryContext*)_pUserData;
+	wv::sPhysicsRayBatch* batch = (wv::sPhysicsRayBatch*)context->pBatch;
+
+	const uint32_t first = _task * context->perTask;
+	const uint32_t last  = wv::Math::min( first + context->perTask, context->count );
+
+	for( uint32_t i = first; i < last; i++ )
+	{
+		const JPH::RRayCast ray{ WVtoJPH( batch->origins[ i ] ), WVtoJPH( batch->directions[ i ] ) };
+
+		JPH::RayCastResult result;
+		if( !context->pQuery->CastRay( ray, result, *context->pBroadPhaseFilter, *context->pObjectFilter ) )
+			continue;
+
+		const JPH::Body* body = context->pLockInterface->TryGetBody( result.mBodyID );
+		if( !body )
+			continue;
+
+		const JPH::RVec3 point = ray.GetPointOnRay( result.mFraction );
+		writeCastHit( batch->results, i, body, result.mFraction, point, body->GetWorldSpaceSurfaceNormal( result.mSubShapeID2, point ) );
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+static void castShapesTask( void* _pUserData, uint32_t _task )
+{
+	sQueryContext* context = (sQueryContext*)_pUserData;
+	wv::sPhysicsShapeCastBatch* batch = (wv::sPhysicsShapeCastBatch*)context->pBatch;
+
+	const uint32_t first = _task * context->perTask;
+	const uint32_t last  = wv::Math::min( first + context->perTask, context->count );
+
+	JPH::ShapeCastSettings settings;
+
+	for( uint32_t i = first; i < last; i++ )
+	{
+		const JPH::RMat44 start = JPH::RMat44::sRotationTranslation( context->rotation, WVtoJPH( batch->origins[ i ] ) );
+		const JPH::RShapeCast cast = JPH::RShapeCast::sFromWorldTransform( context->pShape, context->scale, start, WVtoJPH( batch->directions[ i ] ) );
+
+		JPH::ClosestHitCollisionCollector<JPH::CastShapeCollector> collector;
+		context->pQuery->CastShape( cast, settings, JPH::RVec3::sZero(), collector, *context->pBroadPhaseFilter, *context->pObjectFilter );
+		if( !collector.HadHit() )
+			continue;
+
+		const JPH::ShapeCastResult& hit = collector.mHit;
+		const JPH::Body* body = context->pLockInterface->TryGetBody( hit.mBodyID2 );
+		if( !body )
+			continue;
+
+		writeCastHit( batch->results, i, body, hit.mFraction, JPH::RVec3( hit.mContactPointOn2 ), -hit.mPenetrationAxis.NormalizedOr( JPH::Vec3::sAxisY() ) );
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+static JPH::Vec3 queryScale( wv::iPhysicsBodyDesc* _pDesc )
+{
+	// cooked shapes already come back scaled from getShape
+	if( _pDesc->shape == wv::WV_PHYSICS_MESH || _pDesc->shape == wv::WV_PHYSICS_CONVECT_HULL )
+		return JPH::Vec3::sReplicate( 1.0f );
+
+	return WVtoJPH( _pDesc->transform.scale );
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+/// <summary>
+/// Keeps every body touched once, up to a fixed number of them
+/// </summary>
+class cOverlapCollector : public JPH::CollideShapeCollector
+{
+public:
+	cOverlapCollector( JPH::BodyID* _pIDs, uint32_t _max ) :
+		m_pIDs{ _pIDs },
+		m_max { _max }
+	{ }
+
+	virtual void AddHit( const JPH::CollideShapeResult& inResult ) override
+	{
+		for( uint32_t i = 0; i < numHits; i++ )
+			if( m_pIDs[ i ] == inResult.mBodyID2 )
+				return;
+
+		m_pIDs[ numHits++ ] = inResult.mBodyID2;
+		if( numHits == m_max )
+			ForceEarlyOut();
+	}
+
+	uint32_t numHits = 0;
+
+private:
+	JPH::BodyID* m_pIDs;
+	uint32_t     m_max;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+static void overlapShapesTask( void* _pUserData, uint32_t _task )
+{
+	sQueryContext* context = (sQueryContext*)_pUserData;
+	wv::sPhysicsOverlapBatch* batch = (wv::sPhysicsOverlapBatch*)context->pBatch;
+
+	const uint32_t first = _task * context->perTask;
+	const uint32_t last  = wv::Math::min( first + context->perTask, context->count );
+
+	JPH::CollideShapeSettings settings;
+	std::vector<JPH::BodyID> ids( batch->maxHits );
+
+	for( uint32_t i = first; i < last; i++ )
+	{
+		const JPH::RMat44 transform = JPH::RMat44::sRotationTranslation( context->rotation, WVtoJPH( batch->positions[ i ] ) ).PreTranslated( context->pShape->GetCenterOfMass() );
+
+		cOverlapCollector collector( ids.data(), batch->maxHits );
+		context->pQuery->CollideShape( context->pShape, context->scale, transform, settings, JPH::RVec3::sZero(), collector, *context->pBroadPhaseFilter, *context->pObjectFilter );
+
+		uint32_t numHits = 0;
+		const size_t offset = (size_t)i * batch->maxHits;
+		for( uint32_t h = 0; h < collector.numHits; h++ )
+		{
+			const JPH::Body* body = context->pLockInterface->TryGetBody( ids[ h ] );
+			if( !body )
+				continue;
+
+			const JPH::uint64 userData = body->GetUserData();
+			batch->hitBodies  [ offset + numHits ] = wv::hPhysicsBody{ (wv::Handle)( userData & 0xFFFFFFFF ) };
+			batch->hitUserData[ offset + numHits ] = (uint32_t)( userData >> 32 );
+			numHits++;
+		}
+
+		batch->numHits[ i ] = numHits;
+	}
+}
+#endif // WV_SUPPORT_JOLT_PHYSICS
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cJoltPhysicsEngine::castRays( sPhysicsRayBatch& _batch )
+{
+	const uint32_t count = (uint32_t)_batch.size();
+	_batch.results.reset( count );
+
+#ifdef WV_SUPPORT_JOLT_PHYSICS
+	if( count == 0 )
+		return;
+
+	// queries read the bodies without locking, nothing may be stepping
+	waitForStep();
+
+	JPH::DefaultBroadPhaseLayerFilter broadPhaseFilter( *m_pObjectVsBroadPhaseLayerFilter, (JPH::ObjectLayer)_batch.layer );
+	JPH::DefaultObjectLayerFilter     objectFilter    ( *m_pObjectLayerPairFilter,         (JPH::ObjectLayer)_batch.layer );
+
+	sQueryContext context;
+	context.pQuery            = &m_pPhysicsSystem->GetNarrowPhaseQueryNoLock();
+	context.pLockInterface    = &m_pPhysicsSystem->GetBodyLockInterfaceNoLock();
+	context.pBroadPhaseFilter = &broadPhaseFilter;
+	context.pObjectFilter     = &objectFilter;
+	context.count   = count;
+	context.perTask = m_queriesPerTask;
+	context.pBatch  = &_batch;
+
+	m_pTaskScheduler->parallelFor( ( count + m_queriesPerTask - 1 ) / m_queriesPerTask, castRaysTask, &context );
+#endif // WV_SUPPORT_JOLT_PHYSICS
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cJoltPhysicsEngine::castShapes( sPhysicsShapeCastBatch& _batch )
+{
+	const uint32_t count = (uint32_t)_batch.size();
+	_batch.results.reset( count );
+
+#ifdef WV_SUPPORT_JOLT_PHYSICS
+	if( count == 0 )
+		return;
+
+	if( !_batch.pShape )
+	{
+		Debug::Print( Debug::WV_PRINT_ERROR, "Shape cast batch has no shape\n" );
+		return;
+	}
+
+	JPH::ShapeRefC shape = getShape( _batch.pShape );
+	if( shape == nullptr )
+		return;
+
+	waitForStep();
+
+	JPH::DefaultBroadPhaseLayerFilter broadPhaseFilter( *m_pObjectVsBroadPhaseLayerFilter, (JPH::ObjectLayer)_batch.layer );
+	JPH::DefaultObjectLayerFilter     objectFilter    ( *m_pObjectLayerPairFilter,         (JPH::ObjectLayer)_batch.layer );
+
+	sQueryContext context;
+	context.pQuery            = &m_pPhysicsSystem->GetNarrowPhaseQueryNoLock();
+	context.pLockInterface    = &m_pPhysicsSystem->GetBodyLockInterfaceNoLock();
+	context.pBroadPhaseFilter = &broadPhaseFilter;
+	context.pObjectFilter     = &objectFilter;
+	context.pShape   = shape;
+	context.rotation = WVtoJPH( _batch.pShape->transform.getOrientation() );
+	context.scale    = queryScale( _batch.pShape );
+	context.count    = count;
+	context.perTask  = m_queriesPerTask;
+	context.pBatch   = &_batch;
+
+	m_pTaskScheduler->parallelFor( ( count + m_queriesPerTask - 1 ) / m_queriesPerTask, castShapesTask, &context );
 #endif // WV_SUPPORT_JOLT_PHYSICS
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cJoltPhysicsEngine::overlapShapes( sPhysicsOverlapBatch& _batch )
+{
+	const uint32_t count = (uint32_t)_batch.size();
+	_batch.numHits    .assign( count, 0 );
+	_batch.hitBodies  .assign( (size_t)count * _batch.maxHits, hPhysicsBody{ 0 } );
+	_batch.hitUserData.assign( (size_t)count * _batch.maxHits, 0 );
+
+#ifdef WV_SUPPORT_JOLT_PHYSICS
+	if( count == 0 || _batch.maxHits == 0 )
+		return;
+
+	if( !_batch.pShape )
+	{
+		Debug::Print( Debug::WV_PRINT_ERROR, "Overlap batch has no shape\n" );
+		return;
+	}
+
+	JPH::ShapeRefC shape = getShape( _batch.pShape );
+	if( shape == nullptr )
+		return;
+
+	waitForStep();
+
+	JPH::DefaultBroadPhaseLayerFilter broadPhaseFilter( *m_pObjectVsBroadPhaseLayerFilter, (JPH::ObjectLayer)_batch.layer );
+	JPH::DefaultObjectLayerFilter     objectFilter    ( *m_pObjectLayerPairFilter,         (JPH::ObjectLayer)_batch.layer );
+
+	sQueryContext context;
+	context.pQuery            = &m_pPhysicsSystem->GetNarrowPhaseQueryNoLock();
+	context.pLockInterface    = &m_pPhysicsSystem->GetBodyLockInterfaceNoLock();
+	context.pBroadPhaseFilter = &broadPhaseFilter;
+	context.pObjectFilter     = &objectFilter;
+	context.pShape   = shape;
+	context.rotation = WVtoJPH( _batch.pShape->transform.getOrientation() );
+	context.scale    = queryScale( _batch.pShape );
+	context.count    = count;
+	context.perTask  = m_queriesPerTask;
+	context.pBatch   = &_batch;
+
+	m_pTaskScheduler->parallelFor( ( count + m_queriesPerTask - 1 ) / m_queriesPerTask, overlapShapesTask, &context );
+#endif // WV_SUPPORT_JOLT_PHYSICS
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+#ifdef WV_SUPPORT_JOLT_PHYSICS
+size_t wv::cJoltPhysicsEngine::sShapeKeyHash::operator()( const sShapeKey& _key ) const
+{
+	size_t hash = std::hash<int>{}( (int)_key.shape );
+	for ( int i = 0; i < 3; i++ )
+		hash ^= std::hash<float>{}( _key.params[ i ] ) + 0x9e3779b9 + ( hash << 6 ) + ( hash >> 2 );
+	
+	return hash;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+JPH::ShapeRefC wv::cJoltPhysicsEngine::getShape( iPhysicsBodyDesc* _desc )
+{
+	sShapeKey key{ _desc->shape, { 0.0f, 0.0f, 0.0f } };
+
+	switch( _desc->shape )
+	{
+	case WV_PHYSICS_BOX:
+	{
+		sPhysicsBoxDesc* desc = static_cast< sPhysicsBoxDesc* >( _desc );
+		key.params[ 0 ] = desc->halfExtent.x;
+		key.params[ 1 ] = desc->halfExtent.y;
+		key.params[ 2 ] = desc->halfExtent.z;
+	} break;
+
+	case WV_PHYSICS_SPHERE:
+	{
+		sPhysicsSphereDesc* desc = static_cast< sPhysicsSphereDesc* >( _desc );
+		key.params[ 0 ] = desc->radius;
+	} break;
+
+	case WV_PHYSICS_MESH:
+	case WV_PHYSICS_CONVECT_HULL:
+	{
+		// cooked shapes are owned by their resource, nothing to cache
+		sPhysicsCookedShapeDesc* desc = static_cast< sPhysicsCookedShapeDesc* >( _desc );
+		if( !desc->pResource || !desc->pResource->isComplete() )
+		{
+			Debug::Print( Debug::WV_PRINT_ERROR, "Cooked physics shape is not loaded\n" );
+			return nullptr;
+		}
+
+		if( desc->shape == WV_PHYSICS_MESH && desc->kind == WV_PHYSICS_DYANIMIC )
+			Debug::Print( Debug::WV_PRINT_WARN, "Mesh shapes cannot collide with other mesh shapes, use a convex hull for dynamic bodies\n" );
+
+		JPH::ShapeRefC shape = desc->pResource->getShape();
+		const cVector3f& scale = desc->transform.scale;
+		if( scale.x != 1.0f || scale.y != 1.0f || scale.z != 1.0f )
+			shape = new JPH::ScaledShape( shape, WVtoJPH( scale ) );
+
+		return shape;
+	}
+
+	default: 
+		Debug::Print( Debug::WV_PRINT_ERROR, "Physics shape unimplemented\n" ); 
+		return nullptr;
+	}
+
+	auto search = m_shapeCache.find( key );
+	if( search != m_shapeCache.end() )
+		return search->second;
+
+	JPH::ShapeRefC shape;
+	switch( _desc->shape )
+	{
+	case WV_PHYSICS_BOX:    shape = new JPH::BoxShape( JPH::Vec3{ key.params[ 0 ], key.params[ 1 ], key.params[ 2 ] } ); break;
+	case WV_PHYSICS_SPHERE: shape = new JPH::SphereShape( key.params[ 0 ] ); break;
+	default: break;
+	}
+
+	m_shapeCache[ key ] = shape;
+	return shape;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+JPH::Body* wv::cJoltPhysicsEngine::createBody( iPhysicsBodyDesc* _desc )
+{
+	JPH::ShapeRefC shape = getShape( _desc );
+	if( shape == nullptr )
+		return nullptr;
+
+	JPH::RVec3 pos = WVtoJPH( _desc->transform.position );
+	JPH::Quat  rot = WVtoJPH( _desc->transform.getOrientation() );
+	
+	JPH::EMotionType motionType = JPH::EMotionType::Static;
+	switch( _desc->kind )
+	{
+	case WV_PHYSICS_DYANIMIC:  motionType = JPH::EMotionType::Dynamic;   break;
+	case WV_PHYSICS_KINEMATIC: motionType = JPH::EMotionType::Kinematic; break;
+	}
+
+	ePhysicsLayer layer = _desc->layer;
+	if( layer == WV_PHYSICS_LAYER_DEFAULT )
+	{
+		switch( _desc->kind )
+		{
+		case WV_PHYSICS_STATIC:    layer = WV_PHYSICS_LAYER_STATIC;    break;
+		case WV_PHYSICS_KINEMATIC: layer = WV_PHYSICS_LAYER_KINEMATIC; break;
+		default:                   layer = WV_PHYSICS_LAYER_MOVING;    break;
+		}
+	}
+
+	JPH::BodyCreationSettings settings( shape, pos, rot, motionType, (JPH::ObjectLayer)layer );
+	settings.mFriction = 0.5f;
+	settings.mRestitution = 0.5f;
+	settings.mIsSensor = layer == WV_PHYSICS_LAYER_SENSOR;
+
+	JPH::Body* body = m_pBodyInterface->CreateBody( settings );
+	if( !body )
+		Debug::Print( Debug::WV_PRINT_ERROR, "Too many Rigidbodies!\n" );
+
+	return body;
+}
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
-#ifdef WV_SUPPORT_JOLT_PHYSICS
-static void traceImpl( const char* _msg, ... )
+void wv::cJoltPhysicsEngine::addBodies( JPH::BodyID* _pIDs, uint32_t _count, bool _activate )
 {
-	/// TODO: change to wv::Debug::Print()
-	va_list list;
-	va_start( list, _msg );
-	vprintf( _msg, list );
-	printf( "\n" );
-	va_end( list );
+	if( _count == 0 )
+		return;
+
+	// prepare may reorder the ids, finalize has to get them in the same order
+	JPH::BodyInterface::AddState state = m_pBodyInterface->AddBodiesPrepare( _pIDs, (int)_count );
+	m_pBodyInterface->AddBodiesFinalize( _pIDs, (int)_count, state, _activate ? JPH::EActivation::Activate : JPH::EActivation::DontActivate );
 }
-#ifdef JPH_ENABLE_ASSERTS
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
-// Callback for asserts, connect this to your own assert handler if you have one
-static bool AssertFailedImpl( const char* inExpression, const char* inMessage, const char* inFile, JPH::uint inLine )
+void wv::cJoltPhysicsEngine::step( int _numSteps )
 {
-	// Print to the TTY
-	std::cout << inFile << ":" << inLine << ": (" << inExpression << ") " << ( inMessage != nullptr ? inMessage : "" ) << std::endl;
+	// the simulation is not running and bodies are only changed from this thread, no locks needed
+	const JPH::BodyLockInterfaceNoLock& lockInterface = m_pPhysicsSystem->GetBodyLockInterfaceNoLock();
 
-	// Breakpoint
-	return true;
-};
+	sPhysicsStats& stats = m_stepStats;
+	stats = {};
+	m_pTempAllocator->resetHighWater();
 
-#endif // JPH_ENABLE_ASSERTS
-#endif // WV_SUPPORT_JOLT_PHYSICS
+	const auto start = std::chrono::steady_clock::now();
+
+	// only bodies that fall asleep during these steps are published as sleeping
+	tempBodyActivationListener->takeDeactivated( m_deactivatedIDs );
+
+	for( int i = 0; i < _numSteps; i++ )
+	{
+		m_steps++;
+
+		// the pose before the last step is what the published pose is blended from
+		if( i == _numSteps - 1 )
+		{
+			const uint32_t     numActive = m_pPhysicsSystem->GetNumActiveBodies( JPH::EBodyType::RigidBody );
+			const JPH::BodyID* activeIDs = m_pPhysicsSystem->GetActiveBodiesUnsafe( JPH::EBodyType::RigidBody );
+
+			for( uint32_t b = 0; b < numActive; b++ )
+			{
+				const JPH::Body* body = lockInterface.TryGetBody( activeIDs[ b ] );
+				if( !body )
+					continue;
+
+				const JPH::RVec3 pos = body->GetPosition();
+
+				sPreviousPose& pose = m_previousPoses[ activeIDs[ b ].GetIndex() ];
+				pose.position    = cVector3f{ (float)pos.GetX(), (float)pos.GetY(), (float)pos.GetZ() };
+				pose.orientation = JPHtoWV( body->GetRotation() );
+				pose.step        = m_steps;
+			}
+		}
+
+		// only the contacts of the last step are reported
+		tempContactListener->resetCounters();
+		m_pEventBuffer->setStep( m_steps );
+		
+		const JPH::EPhysicsUpdateError error = m_pPhysicsSystem->Update( m_timestep, 1, m_pTempAllocator, m_pJobSystem );
+		stats.bodyPairCacheFull      |= ( error & JPH::EPhysicsUpdateError::BodyPairCacheFull )      != JPH::EPhysicsUpdateError::None;
+		stats.manifoldCacheFull      |= ( error & JPH::EPhysicsUpdateError::ManifoldCacheFull )      != JPH::EPhysicsUpdateError::None;
+		stats.contactConstraintsFull |= ( error & JPH::EPhysicsUpdateError::ContactConstraintsFull ) != JPH::EPhysicsUpdateError::None;
+	}
+
+	const auto end = std::chrono::steady_clock::now();
+
+	stats.numSteps   = (uint32_t)_numSteps;
+	stats.updateTime = std::chrono::duration<double, std::milli>( end - start ).count();
+	stats.stepTime   = stats.updateTime / (double)_numSteps;
+
+	stats.numBodies       = m_pPhysicsSystem->GetNumBodies();
+	stats.numActiveBodies = m_pPhysicsSystem->GetNumActiveBodies( JPH::EBodyType::RigidBody );
+	stats.maxBodies       = m_pPhysicsSystem->GetMaxBodies();
+
+	stats.numNewContacts        = tempContactListener->getNumAdded();
+	stats.numContacts           = stats.numNewContacts + tempContactListener->getNumPersisted();
+	stats.maxBodyPairs          = m_maxBodyPairs;
+	stats.maxContactConstraints = m_maxContactConstraints;
+
+	stats.tempAllocatorHighWater = m_pTempAllocator->getHighWater();
+	stats.tempAllocatorSize      = m_pTempAllocator->getSize();
+
+	publishActiveBodies();
+}
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
-void wv::cJoltPhysicsEngine::init()
+void wv::cJoltPhysicsEngine::stepTask( void* _pUserData )
 {
-#ifdef WV_SUPPORT_JOLT_PHYSICS
-	using namespace JPH::literals;
+	cJoltPhysicsEngine* physics = (cJoltPhysicsEngine*)_pUserData;
+	physics->step( physics->m_pendingSteps );
+}
 
-	JPH::RegisterDefaultAllocator();
-	
-	JPH::Trace = traceImpl;
-	JPH_IF_ENABLE_ASSERTS( JPH::AssertFailed = AssertFailedImpl; )
+///////////////////////////////////////////////////////////////////////////////////////
 
-	JPH::Factory::sInstance = new JPH::Factory();
+void wv::cJoltPhysicsEngine::waitForStep()
+{
+	if( m_pStepTask )
+	{
+		m_pTaskScheduler->wait( m_pStepTask );
+		m_pTaskScheduler->release( m_pStepTask );
+		m_pStepTask = nullptr;
+	}
 
-	JPH::RegisterTypes();
+	if( !m_hasStepResult )
+		return;
 
-	m_pTempAllocator = new JPH::TempAllocatorImpl( 10 * 1024 * 1024 );
-	m_pJobSystem     = new JPH::JobSystemThreadPool( JPH::cMaxPhysicsJobs, JPH::cMaxPhysicsBarriers, std::thread::hardware_concurrency() - 1 );
+	std::swap( m_activeBodyTransforms, m_stepTransforms );
+	m_interpolationAlpha = m_stepAlpha;
+	m_hasStepResult = false;
 
-	m_pBroadPhaseLayer               = new cBroadPhaseLayer();
-	m_pObjectVsBroadPhaseLayerFilter = new cObjectVsBroadPhaseLayerFilter();
-	m_pObjectLayerPairFilter         = new cObjectLayerPairFilter();
+	m_stats = m_stepStats;
+	collectEvents();
+	countIslands();
+	checkCapacity();
+}
 
-	m_pPhysicsSystem = new JPH::PhysicsSystem();
-	m_pPhysicsSystem->Init(
-		m_maxBodies, m_numBodyMutexes, m_maxBodyPairs, m_maxContactConstraints,
-		*m_pBroadPhaseLayer, 
-		*m_pObjectVsBroadPhaseLayerFilter, 
-		*m_pObjectLayerPairFilter );
+///////////////////////////////////////////////////////////////////////////////////////
 
-	tempContactListener = new cJoltContactListener();
-	tempBodyActivationListener = new cJoltBodyActivationListener();
+void wv::cJoltPhysicsEngine::collectEvents()
+{
+	m_pEventBuffer->collect( m_eventRecords );
 
-	m_pPhysicsSystem->SetContactListener( tempContactListener );
-	m_pPhysicsSystem->SetBodyActivationListener( tempBodyActivationListener );
+	// ids become handles and user data here, once nothing is writing to the bodies
+	const JPH::BodyLockInterfaceNoLock& lockInterface = m_pPhysicsSystem->GetBodyLockInterfaceNoLock();
+	
+	auto resolve = [ &lockInterface ]( uint32_t _id, hPhysicsBody& _body, uint32_t& _userData )
+		{
+			const JPH::BodyID id( _id );
+			const JPH::Body* body = id.IsInvalid() ? nullptr : lockInterface.TryGetBody( id );
+			if( !body )
+				return;
+
+			const JPH::uint64 userData = body->GetUserData();
+			_body     = hPhysicsBody{ (wv::Handle)( userData & 0xFFFFFFFF ) };
+			_userData = (uint32_t)( userData >> 32 );
+		};
+
+	m_pendingEvents.reserve( m_pendingEvents.size() + m_eventRecords.size() );
+	for( const sPhysicsEventRecord& record : m_eventRecords )
+	{
+		sPhysicsEvent event;
+		event.type   = record.type;
+		event.point  = record.point;
+		event.normal = record.normal;
+		event.depth  = record.depth;
 
-	m_pBodyInterface = &m_pPhysicsSystem->GetBodyInterface();
+		resolve( record.bodyID1, event.body1, event.userData1 );
+		resolve( record.bodyID2, event.body2, event.userData2 );
 
+		m_pendingEvents.push_back( event );
+	}
+}
 
-	sPhysicsSphereDesc* ballDesc = new sPhysicsSphereDesc();
-	ballDesc->kind = WV_PHYSICS_KINEMATIC;
-	ballDesc->radius = 1.0f;
+///////////////////////////////////////////////////////////////////////////////////////
 
-#else
-	wv::Debug::Print( Debug::WV_PRINT_ERROR, "Jolt Physics is not supported on this platform\n" );
-#endif // WV_SUPPORT_JOLT_PHYSICS
+void wv::cJoltPhysicsEngine::publishEvents()
+{
+	std::swap( m_events, m_pendingEvents );
+	m_pendingEvents.clear();
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
-void wv::cJoltPhysicsEngine::terminate()
+enum eCapacityWarning
 {
-#ifdef WV_SUPPORT_JOLT_PHYSICS
-	// Unregisters all types with the factory and cleans up the default material
-	JPH::UnregisterTypes();
+	WV_CAPACITY_BODIES         = 1 << 0,
+	WV_CAPACITY_BODY_PAIRS     = 1 << 1,
+	WV_CAPACITY_CONTACTS       = 1 << 2,
+	WV_CAPACITY_TEMP_ALLOCATOR = 1 << 3,
+	WV_CAPACITY_OVERFLOW       = 1 << 4
+};
 
-	// Destroy the factory
-	delete JPH::Factory::sInstance;
-	JPH::Factory::sInstance = nullptr;
-#endif // WV_SUPPORT_JOLT_PHYSICS
+static void warnCapacity( uint32_t& _warnings, eCapacityWarning _warning, uint64_t _value, uint64_t _max, const char* _name )
+{
+	// warn past 90%, and again only after dropping below 75%
+	if( _value * 10 >= _max * 9 )
+	{
+		if( !( _warnings & _warning ) )
+			wv::Debug::Print( wv::Debug::WV_PRINT_WARN, "Physics %s at %llu of %llu\n", _name, (unsigned long long)_value, (unsigned long long)_max );
+		_warnings |= _warning;
+	}
+	else if( _value * 4 < _max * 3 )
+		_warnings &= ~_warning;
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
-void wv::cJoltPhysicsEngine::killAllPhysicsBodies()
+void wv::cJoltPhysicsEngine::checkCapacity()
 {
-#ifdef WV_SUPPORT_JOLT_PHYSICS
-	for( auto& body : m_bodies )
+	const sPhysicsStats& stats = m_stats;
+
+	warnCapacity( m_capacityWarnings, WV_CAPACITY_BODIES,         stats.numBodies,              stats.maxBodies,             "bodies" );
+	warnCapacity( m_capacityWarnings, WV_CAPACITY_BODY_PAIRS,     stats.numBodyPairs,           stats.maxBodyPairs,          "touching body pairs" );
+	warnCapacity( m_capacityWarnings, WV_CAPACITY_CONTACTS,       stats.numContacts,            stats.maxContactConstraints, "contact constraints" );
+	warnCapacity( m_capacityWarnings, WV_CAPACITY_TEMP_ALLOCATOR, stats.tempAllocatorHighWater, stats.tempAllocatorSize,     "temp allocator bytes" );
+
+	const bool overflow = stats.bodyPairCacheFull || stats.manifoldCacheFull || stats.contactConstraintsFull;
+	if( overflow && !( m_capacityWarnings & WV_CAPACITY_OVERFLOW ) )
 	{
-		m_pBodyInterface->RemoveBody ( body.second->GetID() );
-		m_pBodyInterface->DestroyBody( body.second->GetID() );
+		Debug::Print( Debug::WV_PRINT_ERROR, "Physics step ran out of room, collisions were dropped:%s%s%s\n",
+					  stats.bodyPairCacheFull      ? " body pairs"          : "",
+					  stats.manifoldCacheFull      ? " contact manifolds"   : "",
+					  stats.contactConstraintsFull ? " contact constraints" : "" );
 	}
 
-	m_bodies.clear();
-#endif // WV_SUPPORT_JOLT_PHYSICS
+	if( overflow )
+		m_capacityWarnings |= WV_CAPACITY_OVERFLOW;
+	else
+		m_capacityWarnings &= ~WV_CAPACITY_OVERFLOW;
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
-void wv::cJoltPhysicsEngine::destroyPhysicsBody( hPhysicsBody& _handle )
+static uint32_t findIsland( std::vector<uint32_t>& _parents, uint32_t _slot )
 {
-#ifdef WV_SUPPORT_JOLT_PHYSICS
-	if( !m_bodies.contains( _handle.value() ) )
+	while( _parents[ _slot ] != _slot )
 	{
-		wv::Debug::Print( Debug::WV_PRINT_ERROR, "No Physics Body with Handle %i\n", _handle );
-		return;
+		_parents[ _slot ] = _parents[ _parents[ _slot ] ];
+		_slot = _parents[ _slot ];
+	}
+	return _slot;
+}
+
+void wv::cJoltPhysicsEngine::countIslands()
+{
+	// same grouping as the island builder, which keeps its islands to itself
+	const uint32_t     numActive = m_pPhysicsSystem->GetNumActiveBodies( JPH::EBodyType::RigidBody );
+	const JPH::BodyID* activeIDs = m_pPhysicsSystem->GetActiveBodiesUnsafe( JPH::EBodyType::RigidBody );
+
+	m_islandParents.resize( numActive );
+	for( uint32_t i = 0; i < numActive; i++ )
+	{
+		m_islandSlots[ activeIDs[ i ].GetIndex() ] = (int32_t)i;
+		m_islandParents[ i ] = i;
 	}
 
-	JPH::Body* body = m_bodies.at( _handle.value() );
-	m_pBodyInterface->RemoveBody ( body->GetID() );
-	m_pBodyInterface->DestroyBody( body->GetID() );
-	m_bodies.erase( _handle.value() );
-	_handle.invalidate();
-#endif // WV_SUPPORT_JOLT_PHYSICS
+	uint32_t numIslands = numActive;
+	auto link = [ & ]( const JPH::BodyID& _body1, const JPH::BodyID& _body2 )
+		{
+			if( _body1.IsInvalid() || _body2.IsInvalid() )
+				return;
+
+			const int32_t slot1 = m_islandSlots[ _body1.GetIndex() ];
+			const int32_t slot2 = m_islandSlots[ _body2.GetIndex() ];
+			if( slot1 < 0 || slot2 < 0 )
+				return;
+
+			const uint32_t island1 = findIsland( m_islandParents, (uint32_t)slot1 );
+			const uint32_t island2 = findIsland( m_islandParents, (uint32_t)slot2 );
+			if( island1 == island2 )
+				return;
+
+			m_islandParents[ island2 ] = island1;
+			numIslands--;
+		};
+
+	for( auto& pair : m_pEventBuffer->getTouchingPairs() )
+		link( JPH::BodyID( (uint32_t)( pair.first >> 32 ) ), JPH::BodyID( (uint32_t)pair.first ) );
+
+	for( const JPH::Ref<JPH::Constraint>& constraint : m_pPhysicsSystem->GetConstraints() )
+	{
+		if( !constraint->IsActive() || constraint->GetType() != JPH::EConstraintType::TwoBodyConstraint )
+			continue;
+
+		const JPH::TwoBodyConstraint* twoBody = (const JPH::TwoBodyConstraint*)constraint.GetPtr();
+		link( twoBody->GetBody1()->GetID(), twoBody->GetBody2()->GetID() );
+	}
+
+	for( uint32_t i = 0; i < numActive; i++ )
+		m_islandSlots[ activeIDs[ i ].GetIndex() ] = -1;
+
+	m_stats.numBodyPairs = (uint32_t)m_pEventBuffer->getTouchingPairs().size();
+	m_stats.numIslands   = numIslands;
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
-void wv::cJoltPhysicsEngine::update( double _deltaTime )
+void wv::cJoltPhysicsEngine::publishActiveBodies()
 {
-#ifdef WV_SUPPORT_JOLT_PHYSICS
-	// physics update
-	float frameTime = wv::Math::min( _deltaTime, 0.05 );
-	
-	// Next step
-	m_steps++;
+	const uint32_t     numActive = m_pPhysicsSystem->GetNumActiveBodies( JPH::EBodyType::RigidBody );
+	const JPH::BodyID* activeIDs = m_pPhysicsSystem->GetActiveBodiesUnsafe( JPH::EBodyType::RigidBody );
 
-	int collisionSteps = 0;
-	
-	m_accumulator += frameTime;
-	while( m_accumulator >= m_timestep )
-	{
-		collisionSteps++;
-		m_accumulator -= m_timestep;
-	}
+	m_stepTransforms.clear();
+	publishBodies( activeIDs, numActive, true );
 
-	if( collisionSteps > 0 )
-		m_pPhysicsSystem->Update( frameTime, collisionSteps, m_pTempAllocator, m_pJobSystem );
-#endif // WV_SUPPORT_JOLT_PHYSICS
+	// bodies that fell asleep are no longer in the active list, their resting pose is published once without blending
+	tempBodyActivationListener->takeDeactivated( m_deactivatedIDs );
+	std::sort( m_deactivatedIDs.begin(), m_deactivatedIDs.end() );
+	m_deactivatedIDs.erase( std::unique( m_deactivatedIDs.begin(), m_deactivatedIDs.end() ), m_deactivatedIDs.end() );
+
+	const JPH::BodyLockInterfaceNoLock& lockInterface = m_pPhysicsSystem->GetBodyLockInterfaceNoLock();
+	m_deactivatedIDs.erase( std::remove_if( m_deactivatedIDs.begin(), m_deactivatedIDs.end(), 
+		[ &lockInterface ]( const JPH::BodyID& _id ) 
+		{ 
+			const JPH::Body* body = lockInterface.TryGetBody( _id );
+			return !body || body->IsActive();
+		} ), m_deactivatedIDs.end() );
+
+	publishBodies( m_deactivatedIDs.data(), (uint32_t)m_deactivatedIDs.size(), false );
+
+	m_hasStepResult = true;
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
-wv::hPhysicsBody wv::cJoltPhysicsEngine::createAndAddBody( iPhysicsBodyDesc* _desc, bool _activate )
+void wv::cJoltPhysicsEngine::publishBodies( const JPH::BodyID* _pIDs, uint32_t _count, bool _blend )
 {
-#ifdef WV_SUPPORT_JOLT_PHYSICS
-	JPH::Shape* shape = nullptr;
-	JPH::RVec3 pos = WVtoJPH( _desc->transform.position );
-	JPH::RVec3 rot = WVtoJPH( _desc->transform.rotation );
-	
-	switch( _desc->shape )
-	{
-	case WV_PHYSICS_BOX:
+	const JPH::BodyLockInterfaceNoLock& lockInterface = m_pPhysicsSystem->GetBodyLockInterfaceNoLock();
+
+	m_stepTransforms.reserve( m_stepTransforms.size() + _count );
+	for( uint32_t i = 0; i < _count; i++ )
 	{
-		sPhysicsBoxDesc* desc = static_cast< sPhysicsBoxDesc* >( _desc );
-		JPH::RVec3 halfExtent = WVtoJPH( desc->halfExtent );
-		shape = new JPH::BoxShape( halfExtent );
-	} break;
+		const JPH::Body* body = lockInterface.TryGetBody( _pIDs[ i ] );
+		if( !body )
+			continue;
+
+		// user data is ( owner user data << 32 ) | body handle
+		const JPH::uint64 userData = body->GetUserData();
+		const JPH::RVec3  pos = body->GetPosition();
+
+		sPhysicsBodyTransform transform;
+		transform.body        = hPhysicsBody{ (wv::Handle)( userData & 0xFFFFFFFF ) };
+		transform.userData    = (uint32_t)( userData >> 32 );
+		transform.position    = cVector3f{ (float)pos.GetX(), (float)pos.GetY(), (float)pos.GetZ() };
+		transform.orientation = JPHtoWV( body->GetRotation() );
+		
+		// bodies that woke up during the last step have nothing to blend from
+		const sPreviousPose& previous = m_previousPoses[ _pIDs[ i ].GetIndex() ];
+		if( _blend && previous.step == m_steps )
+		{
+			transform.previousPosition    = previous.position;
+			transform.previousOrientation = previous.orientation;
+		}
+		else
+		{
+			transform.previousPosition    = transform.position;
+			transform.previousOrientation = transform.orientation;
+		}
+
+		m_stepTransforms.push_back( transform );
+	}
+}
 
-	case WV_PHYSICS_SPHERE:
+///////////////////////////////////////////////////////////////////////////////////////
+
+bool wv::cJoltPhysicsEngine::restoreFromSnapshot( sPhysicsSnapshot& _snapshot )
+{
+	if( _snapshot.numBodies != m_bodies.size() )
 	{
-		sPhysicsSphereDesc* desc = static_cast< sPhysicsSphereDesc* >( _desc );
-		shape = new JPH::SphereShape( desc->radius );
-	} break;
+		Debug::Print( Debug::WV_PRINT_ERROR, "Physics snapshot has %zu bodies, the world has %zu\n", _snapshot.numBodies, m_bodies.size() );
+		return false;
+	}
 
-	default: Debug::Print( Debug::WV_PRINT_ERROR, "Physics shape unimplemented" ); break;
+	JPH::StateRecorderImpl recorder;
+	recorder.WriteBytes( _snapshot.data.data(), _snapshot.data.size() );
+
+	if( !m_pPhysicsSystem->RestoreState( recorder ) )
+	{
+		Debug::Print( Debug::WV_PRINT_ERROR, "Failed to restore physics snapshot from step %u\n", _snapshot.step );
+		return false;
 	}
 
-	if( shape == nullptr )
-		return 0;
-	
-	JPH::EMotionType motionType = JPH::EMotionType::Static;
-	switch( _desc->kind )
+	m_steps       = _snapshot.step;
+	m_accumulator = _snapshot.accumulator;
+
+	m_pEventBuffer->setTouchingPairs( _snapshot.touchingPairs );
+
+	// nothing to blend from, and stale poses could carry the same step number
+	sPreviousPose none;
+	none.step = UINT32_MAX;
+	std::fill( m_previousPoses.begin(), m_previousPoses.end(), none );
+
+	// sleeping bodies may have moved too, so every body is published once
+	std::vector<JPH::BodyID> ids;
+	ids.reserve( m_bodies.size() );
+	for( auto& body : m_bodies )
 	{
-	case WV_PHYSICS_DYANIMIC:  motionType = JPH::EMotionType::Dynamic;   break;
-	case WV_PHYSICS_KINEMATIC: motionType = JPH::EMotionType::Kinematic; break;
+		if( body.second->IsInBroadPhase() )
+			ids.push_back( body.second->GetID() );
 	}
 
-	const JPH::ObjectLayer layer = _desc->kind == WV_PHYSICS_STATIC ? wv::Layers::STATIC : wv::Layers::DYNAMIC;
+	m_stepTransforms.clear();
+	publishBodies( ids.data(), (uint32_t)ids.size(), false );
+	m_hasStepResult = true;
 
+	m_stepAlpha = m_accumulator / m_timestep;
+	waitForStep();
 
-	JPH::BodyCreationSettings settings( shape, pos, JPH::Quat::sEulerAngles( rot ), motionType, layer );
-	settings.mFriction = 0.5f;
-	settings.mRestitution = 0.5f;
+	return true;
+}
+#endif // WV_SUPPORT_JOLT_PHYSICS
+
+///////////////////////////////////////////////////////////////////////////////////////
 
-	JPH::Body*  body   = m_pBodyInterface->CreateBody( settings );
+wv::hPhysicsBody wv::cJoltPhysicsEngine::createAndAddBody( iPhysicsBodyDesc* _desc, bool _activate )
+{
+#ifdef WV_SUPPORT_JOLT_PHYSICS
+	waitForStep();
+
+	JPH::Body* body = createBody( _desc );
 	if( !body )
-	{
-		Debug::Print( Debug::WV_PRINT_ERROR, "Too many Rigidbodies!\n" );
 		return 0;
-	}
 
 	JPH::BodyID id     = body->GetID();
 	wv::Handle  handle = 0;
 
-	m_pBodyInterface->AddBody( id, _activate ? JPH::EActivation::Activate : JPH::EActivation::DontActivate );
+	if( m_batchDepth > 0 )
+		( _activate ? m_batchActivate : m_batchDontActivate ).push_back( id );
+	else
+		m_pBodyInterface->AddBody( id, _activate ? JPH::EActivation::Activate : JPH::EActivation::DontActivate );
 	
 	// setup constraint
 	/*
@@ -267,8 +1285,10 @@ wv::hPhysicsBody wv::cJoltPhysicsEngine::createAndAddBody( iPhysicsBodyDesc* _de
 	}
 	*/
 
-	do { handle = cEngine::getUniqueHandle(); } while( m_bodies.contains( handle ) );
+	// per engine and deterministic, so every world hands out the same handles for the same scene
+	do { handle = m_nextHandle++; } while( handle == 0 || m_bodies.contains( handle ) );
 
+	body->SetUserData( handle );
 	m_bodies[ handle ] = body;
 	return handle;
 #else
@@ -278,21 +1298,133 @@ wv::hPhysicsBody wv::cJoltPhysicsEngine::createAndAddBody( iPhysicsBodyDesc* _de
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
+std::vector<wv::hPhysicsBody> wv::cJoltPhysicsEngine::createAndAddBodies( const std::vector<iPhysicsBodyDesc*>& _descs, bool _activate )
+{
+	std::vector<hPhysicsBody> handles;
+	handles.reserve( _descs.size() );
+
+	beginBatch();
+	
+	for( iPhysicsBodyDesc* desc : _descs )
+		handles.push_back( createAndAddBody( desc, _activate ) );
+	
+	endBatch();
+
+	return handles;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cJoltPhysicsEngine::beginBatch()
+{
+#ifdef WV_SUPPORT_JOLT_PHYSICS
+	m_batchDepth++;
+#endif // WV_SUPPORT_JOLT_PHYSICS
+}
+
+void wv::cJoltPhysicsEngine::endBatch()
+{
+#ifdef WV_SUPPORT_JOLT_PHYSICS
+	waitForStep();
+
+	if( m_batchDepth == 0 || --m_batchDepth > 0 )
+		return;
+
+	const size_t count = m_batchActivate.size() + m_batchDontActivate.size();
+
+	addBodies( m_batchActivate.data(),     (uint32_t)m_batchActivate.size(),     true );
+	addBodies( m_batchDontActivate.data(), (uint32_t)m_batchDontActivate.size(), false );
+	
+	m_batchActivate.clear();
+	m_batchDontActivate.clear();
+
+	if( count >= m_optimizeBroadPhaseThreshold )
+		optimizeBroadPhase();
+#endif // WV_SUPPORT_JOLT_PHYSICS
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cJoltPhysicsEngine::optimizeBroadPhase()
+{
+#ifdef WV_SUPPORT_JOLT_PHYSICS
+	waitForStep();
+
+	m_pPhysicsSystem->OptimizeBroadPhase();
+#endif // WV_SUPPORT_JOLT_PHYSICS
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cJoltPhysicsEngine::releaseUnusedShapes()
+{
+#ifdef WV_SUPPORT_JOLT_PHYSICS
+	for( auto it = m_shapeCache.begin(); it != m_shapeCache.end(); )
+	{
+		// only referenced by the cache itself
+		if( it->second->GetRefCount() == 1 )
+			it = m_shapeCache.erase( it );
+		else
+			it++;
+	}
+#endif // WV_SUPPORT_JOLT_PHYSICS
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cJoltPhysicsEngine::setLayerConfig( const sPhysicsLayerConfig& _config )
+{
+#ifdef WV_SUPPORT_JOLT_PHYSICS
+	waitForStep();
+
+	if( m_pPhysicsSystem )
+	{
+		bool treesChanged = false;
+		for( int i = 0; i < WV_PHYSICS_LAYER_COUNT; i++ )
+			treesChanged |= _config.broadPhaseLayer[ i ] != m_layerConfig.broadPhaseLayer[ i ];
+
+		// a scene sets its layers before it creates any bodies, so the system can be rebuilt around the new trees
+		if( treesChanged && m_bodies.empty() )
+		{
+			m_layerConfig = _config;
+
+			destroyPhysicsSystem();
+			createPhysicsSystem();
+
+			m_pEventBuffer->setTouchingPairs( {} );
+			m_snapshots.clear();
+			return;
+		}
+
+		if( treesChanged )
+			Debug::Print( Debug::WV_PRINT_WARN, "Broad phase layers cannot change while the world has bodies\n" );
+
+		for( int i = 0; i < WV_PHYSICS_LAYER_COUNT; i++ )
+			m_layerConfig.collisionMask[ i ] = _config.collisionMask[ i ];
+
+		m_pObjectVsBroadPhaseLayerFilter->setConfig( m_layerConfig );
+		m_pObjectLayerPairFilter->setConfig( m_layerConfig );
+		return;
+	}
+#endif // WV_SUPPORT_JOLT_PHYSICS
+
+	m_layerConfig = _config;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
 wv::Transformf wv::cJoltPhysicsEngine::getBodyTransform( hPhysicsBody& _handle )
 {
 #ifdef WV_SUPPORT_JOLT_PHYSICS
+	waitForStep();
+
 	JPH::Body* body = m_bodies.at( _handle.value() );
 	
 	JPH::RVec3 pos = body->GetPosition();
-	JPH::Vec3  rot = body->GetRotation().GetEulerAngles(); /// TODO: change to quaternion
 
 	Transformf transform{};
 	transform.position = cVector3f{ pos.GetX(), pos.GetY(), pos.GetZ() };
-	transform.rotation = cVector3f{ 
-		wv::Math::degrees( rot.GetX() ), 
-		wv::Math::degrees( rot.GetY() ), 
-		wv::Math::degrees( rot.GetZ() ) 
-	};
+	transform.setOrientation( JPHtoWV( body->GetRotation() ) );
 
 	return transform;
 #else
@@ -303,6 +1435,8 @@ wv::Transformf wv::cJoltPhysicsEngine::getBodyTransform( hPhysicsBody& _handle )
 wv::cVector3f wv::cJoltPhysicsEngine::getBodyVelocity( hPhysicsBody& _handle )
 {
 #ifdef WV_SUPPORT_JOLT_PHYSICS
+	waitForStep();
+
 	JPH::Body* body = m_bodies.at( _handle.value() );
 	
 	return JPHtoWV( body->GetLinearVelocity() );
@@ -314,6 +1448,8 @@ wv::cVector3f wv::cJoltPhysicsEngine::getBodyVelocity( hPhysicsBody& _handle )
 wv::cVector3f wv::cJoltPhysicsEngine::getBodyAngularVelocity( hPhysicsBody& _handle )
 {
 #ifdef WV_SUPPORT_JOLT_PHYSICS
+	waitForStep();
+
 	JPH::Body* body = m_bodies.at( _handle.value() );
 
 	return JPHtoWV( body->GetAngularVelocity() );
@@ -325,6 +1461,8 @@ wv::cVector3f wv::cJoltPhysicsEngine::getBodyAngularVelocity( hPhysicsBody& _han
 bool wv::cJoltPhysicsEngine::isBodyActive( hPhysicsBody& _handle )
 {
 #ifdef WV_SUPPORT_JOLT_PHYSICS
+	waitForStep();
+
 	return m_bodies.at( _handle.value() )->IsActive();
 #endif
 	return false;
@@ -335,16 +1473,14 @@ bool wv::cJoltPhysicsEngine::isBodyActive( hPhysicsBody& _handle )
 void wv::cJoltPhysicsEngine::setBodyTransform( hPhysicsBody& _handle, const Transformf& _transform )
 {
 #ifdef WV_SUPPORT_JOLT_PHYSICS
+	waitForStep();
+
 	JPH::Body* body = m_bodies.at( _handle.value() );
 
 	JPH::Vec3 pos = WVtoJPH( _transform.position );
-	JPH::Vec3 rot{
-		wv::Math::radians( _transform.rotation.x ),
-		wv::Math::radians( _transform.rotation.y ),
-		wv::Math::radians( _transform.rotation.z )
-	};
+	JPH::Quat rot = WVtoJPH( _transform.getOrientation() );
 	
-	m_pBodyInterface->SetPositionAndRotation( body->GetID(), pos, JPH::Quat::sEulerAngles( rot ), JPH::EActivation::DontActivate );
+	m_pBodyInterface->SetPositionAndRotation( body->GetID(), pos, rot, JPH::EActivation::DontActivate );
 #endif // WV_SUPPORT_JOLT_PHYSICS
 }
 
@@ -353,6 +1489,8 @@ void wv::cJoltPhysicsEngine::setBodyTransform( hPhysicsBody& _handle, const Tran
 void wv::cJoltPhysicsEngine::setBodyVelocity( hPhysicsBody& _handle, const cVector3f& _velocity )
 {
 #ifdef WV_SUPPORT_JOLT_PHYSICS
+	waitForStep();
+
 	JPH::Body* body = m_bodies.at( _handle.value() );
 	JPH::Vec3 vel = WVtoJPH( _velocity );
 	
@@ -365,6 +1503,8 @@ void wv::cJoltPhysicsEngine::setBodyVelocity( hPhysicsBody& _handle, const cVect
 void wv::cJoltPhysicsEngine::setBodyAngularVelocity( hPhysicsBody& _handle, const cVector3f& _angularVelocity )
 {
 #ifdef WV_SUPPORT_JOLT_PHYSICS
+	waitForStep();
+
 	JPH::Body* body = m_bodies.at( _handle.value() );
 	JPH::Vec3 vel = WVtoJPH( _angularVelocity );
 
@@ -372,9 +1512,24 @@ void wv::cJoltPhysicsEngine::setBodyAngularVelocity( hPhysicsBody& _handle, cons
 #endif
 }
 
+void wv::cJoltPhysicsEngine::setBodyUserData( hPhysicsBody& _handle, uint32_t _userData )
+{
+#ifdef WV_SUPPORT_JOLT_PHYSICS
+	waitForStep();
+
+	JPH::Body* body = m_bodies.at( _handle.value() );
+	
+	body->SetUserData( ( (JPH::uint64)_userData << 32 ) | _handle.value() );
+#endif
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
 void wv::cJoltPhysicsEngine::setBodyActive( hPhysicsBody& _handle, bool _active )
 {
 #ifdef WV_SUPPORT_JOLT_PHYSICS
+	waitForStep();
+
 	JPH::Body* body = m_bodies.at( _handle.value() );
 	
 	if( _active )
@@ -8,21 +8,26 @@
 #include <Jolt/Jolt.h>
 #include <Jolt/Physics/Body/BodyID.h>
 #include <Jolt/Physics/Body/BodyCreationSettings.h>
+#include <Jolt/Physics/Collision/Shape/Shape.h>
 #endif // WV_SUPPORT_JOLT_PHYSICS
 
 #include <wv/Math/Transform.h>
 #include <wv/Physics/BroadPhaseLayer.h>
 #include <wv/Physics/PhysicsBodyDescriptor.h>
+#include <wv/Physics/PhysicsLayers.h>
 
 #include <wv/Physics/PhysicsTypes.h>
+#include <wv/Physics/PhysicsQuery.h>
+#include <wv/Physics/PhysicsEventBuffer.h>
+#include <wv/Thread/TaskScheduler.h>
 
 #include <unordered_map>
+#include <vector>
+#include <string>
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
 #ifdef WV_SUPPORT_JOLT_PHYSICS
-namespace JPH { class TempAllocatorImpl; }
-namespace JPH { class JobSystemThreadPool; }
 namespace JPH { class PhysicsSystem; }
 namespace JPH { class BodyInterface; }
 namespace JPH { class Body; }
@@ -35,6 +40,8 @@ namespace wv
 	#ifdef WV_SUPPORT_JOLT_PHYSICS
 	class cJoltContactListener;
 	class cJoltBodyActivationListener;
+	class cJoltJobSystem;
+	class cJoltTempAllocator;
 	#endif // WV_SUPPORT_JOLT_PHYSICS
 
 ///////////////////////////////////////////////////////////////////////////////////////
@@ -45,16 +52,94 @@ namespace wv
 		 cJoltPhysicsEngine() { }
 		~cJoltPhysicsEngine() { }
 
-		void init();
+		void init( cTaskScheduler* _pTaskScheduler );
 		void terminate();
 
 		void killAllPhysicsBodies();
 		void destroyPhysicsBody( hPhysicsBody& _handle );
 
+		/// <summary>
+		/// Runs as many fixed steps as fit in the accumulated time. With async stepping 
+		/// the steps run as a task while the frame is rendered, and their results
+		/// show up on the next update
+		/// </summary>
 		void update( double _deltaTime );
 
+		void setAsyncStepping( bool _async );
+		bool isAsyncStepping() { return m_asyncStepping; }
+
+		/// <summary>
+		/// How far into the next fixed step the frame is, in [0, 1). 
+		/// Blend the published previous and current poses by this
+		/// </summary>
+		float getInterpolationAlpha() { return m_interpolationAlpha; }
+		float getTimestep()           { return m_timestep; }
+
 		hPhysicsBody createAndAddBody( iPhysicsBodyDesc* _desc, bool _activate );
 		
+		/// <summary>
+		/// Creates every body first and adds them to the broad phase in one go
+		/// </summary>
+		std::vector<hPhysicsBody> createAndAddBodies( const std::vector<iPhysicsBodyDesc*>& _descs, bool _activate );
+
+		/// <summary>
+		/// Bodies created between beginBatch and endBatch are only added to the 
+		/// simulation by endBatch, which adds them all at once. Handles are valid 
+		/// right away but the bodies do not simulate until the batch ends
+		/// </summary>
+		void beginBatch();
+		void endBatch();
+
+		/// <summary>
+		/// Rebuilds the broad phase tree, worth doing after adding many bodies at once
+		/// </summary>
+		void optimizeBroadPhase();
+
+		/// <summary>
+		/// Drops cached shapes that no body uses anymore
+		/// </summary>
+		void releaseUnusedShapes();
+
+		/// <summary>
+		/// The collision matrix applies right away. Broad phase layers rebuild the
+		/// physics system, so they can only change while there are no bodies
+		/// </summary>
+		void setLayerConfig( const sPhysicsLayerConfig& _config );
+		const sPhysicsLayerConfig& getLayerConfig() { return m_layerConfig; }
+
+		/// <summary>
+		/// Records the whole simulation state into the snapshot ring, overwriting the 
+		/// oldest snapshot once it is full. Returns the step the snapshot was taken at
+		/// </summary>
+		uint32_t saveSnapshot();
+
+		/// <summary>
+		/// Restores the newest snapshot taken at or before _step. The same bodies have to 
+		/// exist as when it was saved, bodies are never created or destroyed by a restore.
+		/// Stepping on from a restored snapshot reproduces the original simulation
+		/// </summary>
+		bool restoreSnapshot( uint32_t _step );
+		bool restoreLatestSnapshot();
+
+		void clearSnapshots();
+		void setSnapshotCapacity( uint32_t _capacity );
+		
+		uint32_t getNumSnapshots() { return (uint32_t)m_snapshots.size(); }
+		uint32_t getStep()         { return m_steps; }
+
+		/// <summary>
+		/// Every query of the batch runs in parallel on the task scheduler, the call returns
+		/// once all results are written. A running async step is waited for first
+		/// </summary>
+		void castRays     ( sPhysicsRayBatch&       _batch );
+		void castShapes   ( sPhysicsShapeCastBatch& _batch );
+		void overlapShapes( sPhysicsOverlapBatch&   _batch );
+
+		/// <summary>
+		/// Counters from the last update that stepped the simulation
+		/// </summary>
+		const sPhysicsStats& getStats() { return m_stats; }
+
 		Transformf getBodyTransform      ( hPhysicsBody& _handle );
 		cVector3f   getBodyVelocity       ( hPhysicsBody& _handle );
 		cVector3f   getBodyAngularVelocity( hPhysicsBody& _handle );
@@ -67,6 +152,21 @@ namespace wv
 
 		void setBodyActive( hPhysicsBody& _handle, bool _active );
 
+		void setBodyUserData( hPhysicsBody& _handle, uint32_t _userData );
+
+		/// <summary>
+		/// Every body that was active during the last fixed step, in no particular order, and
+		/// every body that fell asleep during the update with its previous pose equal to its current.
+		/// Replaced every update that steps the simulation, kept as is otherwise
+		/// </summary>
+		const std::vector<sPhysicsBodyTransform>& getActiveBodyTransforms() { return m_activeBodyTransforms; }
+
+		/// <summary>
+		/// Contact and activation events of the steps whose transforms were last published,
+		/// replaced every update
+		/// </summary>
+		const std::vector<sPhysicsEvent>& getEvents() { return m_events; }
+
 ///////////////////////////////////////////////////////////////////////////////////////
 
 	private:
@@ -74,14 +174,59 @@ namespace wv
 		const unsigned int m_numBodyMutexes        = 0;
 		const unsigned int m_maxBodyPairs          = 65536;
 		const unsigned int m_maxContactConstraints = 10240;
+		
+		// batches at least this large rebuild the broad phase when added
+		const unsigned int m_optimizeBroadPhaseThreshold = 128;
+
+		// scene queries handed to each task of a batch
+		const unsigned int m_queriesPerTask = 32;
 
 		const float  m_timestep    = 1.0f / 120.0f;
 		float        m_accumulator = 0.0f;
 		unsigned int m_steps       = 0;
 
+		float m_interpolationAlpha = 0.0f;
+		bool  m_asyncStepping      = false;
+
+		cTaskScheduler* m_pTaskScheduler = nullptr;
+
+		sPhysicsLayerConfig m_layerConfig{};
+
+		std::vector<sPhysicsBodyTransform> m_activeBodyTransforms;
+
+		std::vector<sPhysicsEvent> m_events;
+		
+		// collected when a step finishes, moved to m_events by the next update
+		std::vector<sPhysicsEvent> m_pendingEvents;
+
+		sPhysicsStats m_stats{};
+		
+		// written by the step alongside m_stepTransforms
+		sPhysicsStats m_stepStats{};
+
+		// limits that were already warned about, warned again once usage drops back
+		uint32_t m_capacityWarnings = 0;
+
+		struct sPhysicsSnapshot
+		{
+			uint32_t    step        = 0;
+			float       accumulator = 0.0f;
+			size_t      numBodies   = 0;
+			std::string data;
+
+			// the contact cache in data goes with these, or restored contacts are counted wrong
+			std::unordered_map<uint64_t, uint32_t> touchingPairs;
+		};
+
+		// ring of the last m_snapshotCapacity snapshots, m_nextSnapshot is the oldest once full
+		std::vector<sPhysicsSnapshot> m_snapshots;
+		uint32_t m_snapshotCapacity = 16;
+		uint32_t m_nextSnapshot     = 0;
+
 	#ifdef WV_SUPPORT_JOLT_PHYSICS
-		JPH::TempAllocatorImpl*   m_pTempAllocator = nullptr;
-		JPH::JobSystemThreadPool* m_pJobSystem     = nullptr;
+		cJoltTempAllocator*       m_pTempAllocator = nullptr;
+		cJoltJobSystem*           m_pJobSystem     = nullptr;
+		cPhysicsEventBuffer*      m_pEventBuffer   = nullptr;
 		JPH::PhysicsSystem*       m_pPhysicsSystem = nullptr;
 		JPH::BodyInterface*       m_pBodyInterface = nullptr;
 
@@ -92,7 +237,79 @@ namespace wv
 		cJoltContactListener*        tempContactListener        = nullptr;
 		cJoltBodyActivationListener* tempBodyActivationListener = nullptr;
 
+		// scratch for collectEvents, kept to reuse its capacity
+		std::vector<sPhysicsEventRecord> m_eventRecords;
+
 		std::unordered_map<wv::Handle, JPH::Body*> m_bodies;
+		wv::Handle m_nextHandle = 1;
+
+		struct sShapeKey
+		{
+			ePhysicsShape shape;
+			float params[ 3 ];
+
+			bool operator==( const sShapeKey& _other ) const 
+			{ 
+				return shape == _other.shape && 
+					params[ 0 ] == _other.params[ 0 ] && 
+					params[ 1 ] == _other.params[ 1 ] && 
+					params[ 2 ] == _other.params[ 2 ];
+			}
+		};
+
+		struct sShapeKeyHash
+		{
+			size_t operator()( const sShapeKey& _key ) const;
+		};
+
+		JPH::ShapeRefC getShape( iPhysicsBodyDesc* _desc );
+		JPH::Body*     createBody( iPhysicsBodyDesc* _desc );
+		void           addBodies( JPH::BodyID* _pIDs, uint32_t _count, bool _activate );
+		void           publishActiveBodies();
+		void           publishBodies( const JPH::BodyID* _pIDs, uint32_t _count, bool _blend );
+		void           checkCapacity();
+		void           countIslands();
+		void           collectEvents();
+		void           publishEvents();
+		bool           restoreFromSnapshot( sPhysicsSnapshot& _snapshot );
+		void           createPhysicsSystem();
+		void           destroyPhysicsSystem();
+		
+		void step( int _numSteps );
+		void waitForStep();
+
+		struct sPreviousPose
+		{
+			cVector3f    position{};
+			cQuaternionf orientation{};
+			uint32_t     step = 0;
+		};
+
+		// indexed by body id, written before the last step of every update
+		std::vector<sPreviousPose> m_previousPoses;
+
+		// union-find over the active bodies for countIslands, slots are indexed by body id and -1 when unused
+		std::vector<int32_t>  m_islandSlots;
+		std::vector<uint32_t> m_islandParents;
+
+		// bodies that went to sleep during the step, published once with their resting pose
+		std::vector<JPH::BodyID> m_deactivatedIDs;
+
+		// written by the step, swapped into m_activeBodyTransforms once it is done
+		static void stepTask( void* _pUserData );
+
+		cTaskScheduler::sTask* m_pStepTask = nullptr;
+		int m_pendingSteps = 0;
+		std::vector<sPhysicsBodyTransform> m_stepTransforms;
+		float m_stepAlpha     = 0.0f;
+		bool  m_hasStepResult = false;
+
+		// shapes are immutable, so bodies with the same parameters share one
+		std::unordered_map<sShapeKey, JPH::ShapeRefC, sShapeKeyHash> m_shapeCache;
+
+		uint32_t m_batchDepth = 0;
+		std::vector<JPH::BodyID> m_batchActivate;
+		std::vector<JPH::BodyID> m_batchDontActivate;
 	#endif // WV_SUPPORT_JOLT_PHYSICS
 
 	};
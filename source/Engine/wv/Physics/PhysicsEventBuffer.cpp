@@ -0,0 +1,252 @@
+#include "PhysicsEventBuffer.h"
+
+#include <wv/Thread/TaskScheduler.h>
+
+#include <algorithm>
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+wv::cPhysicsEventBuffer::cPhysicsEventBuffer( cTaskScheduler* _pTaskScheduler ) :
+	m_pTaskScheduler{ _pTaskScheduler }
+{
+	const int numBuffers = 1 + ( _pTaskScheduler ? _pTaskScheduler->getNumWorkers() : 0 );
+	for ( int i = 0; i < numBuffers; i++ )
+		m_buffers.push_back( new sThreadBuffer() );
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+wv::cPhysicsEventBuffer::~cPhysicsEventBuffer()
+{
+	for ( sThreadBuffer* buffer : m_buffers )
+		delete buffer;
+	m_buffers.clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cPhysicsEventBuffer::push( sPhysicsEventRecord& _record )
+{
+	_record.step = m_step;
+
+	const int worker = m_pTaskScheduler ? m_pTaskScheduler->getWorkerIndex() : -1;
+	if ( worker >= 0 )
+	{
+		m_buffers[ worker + 1 ]->records.push_back( _record );
+		return;
+	}
+
+	// the thread waiting on the step may run its jobs, and bodies can be activated from outside it
+	while ( m_sharedLock.test_and_set( std::memory_order_acquire ) ) { }
+	m_buffers[ 0 ]->records.push_back( _record );
+	m_sharedLock.clear( std::memory_order_release );
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+uint64_t wv::cPhysicsEventBuffer::pairKey( uint32_t _bodyID1, uint32_t _bodyID2 )
+{
+	const uint32_t lo = std::min( _bodyID1, _bodyID2 );
+	const uint32_t hi = std::max( _bodyID1, _bodyID2 );
+	return ( (uint64_t)lo << 32 ) | hi;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+static bool isContact( wv::ePhysicsEventType _type )
+{
+	return _type != wv::WV_PHYSICS_EVENT_BODY_ACTIVATED && _type != wv::WV_PHYSICS_EVENT_BODY_DEACTIVATED;
+}
+
+static uint64_t mergeKey( const wv::sPhysicsEventRecord& _record )
+{
+	if ( !isContact( _record.type ) )
+		return _record.bodyID1;
+
+	return wv::cPhysicsEventBuffer::pairKey( _record.bodyID1, _record.bodyID2 );
+}
+
+static uint64_t subShapeKey( const wv::sPhysicsEventRecord& _record )
+{
+	// same order as the pair key, so both body orders match
+	if ( _record.bodyID1 <= _record.bodyID2 )
+		return ( (uint64_t)_record.subShapeID1 << 32 ) | _record.subShapeID2;
+	return ( (uint64_t)_record.subShapeID2 << 32 ) | _record.subShapeID1;
+}
+
+static bool recordLess( const wv::sPhysicsEventRecord& _a, const wv::sPhysicsEventRecord& _b )
+{
+	if ( _a.step != _b.step )
+		return _a.step < _b.step;
+
+	const bool contactA = isContact( _a.type );
+	const bool contactB = isContact( _b.type );
+	if ( contactA != contactB )
+		return contactA;
+
+	const uint64_t keyA = mergeKey( _a );
+	const uint64_t keyB = mergeKey( _b );
+	if ( keyA != keyB )
+		return keyA < keyB;
+
+	const uint64_t subA = subShapeKey( _a );
+	const uint64_t subB = subShapeKey( _b );
+	if ( subA != subB )
+		return subA < subB;
+
+	return _a.type < _b.type;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cPhysicsEventBuffer::countContacts( const sPhysicsEventRecord* _pFirst, const sPhysicsEventRecord* _pEnd, std::vector<sPhysicsEventRecord>& _out )
+{
+	// every contact of one body pair in one step, each sub-shape pair shows up at most once
+	const uint64_t key = mergeKey( *_pFirst );
+
+	uint32_t numAdded   = 0;
+	uint32_t numRemoved = 0;
+	const sPhysicsEventRecord* added     = nullptr;
+	const sPhysicsEventRecord* persisted = nullptr;
+	for ( const sPhysicsEventRecord* record = _pFirst; record != _pEnd; record++ )
+	{
+		switch ( record->type )
+		{
+		case WV_PHYSICS_EVENT_CONTACT_ADDED:     numAdded++;   if ( !added )     added     = record; break;
+		case WV_PHYSICS_EVENT_CONTACT_PERSISTED:               if ( !persisted ) persisted = record; break;
+		case WV_PHYSICS_EVENT_CONTACT_REMOVED:   numRemoved++; break;
+		default: break;
+		}
+	}
+
+	auto touching = m_touchingPairs.find( key );
+	const uint32_t before = touching == m_touchingPairs.end() ? 0 : touching->second;
+	
+	// a remove for a contact that was never added has nothing to take away
+	const uint32_t after = before + numAdded > numRemoved ? before + numAdded - numRemoved : 0;
+
+	if ( after == 0 )
+	{
+		if ( touching != m_touchingPairs.end() )
+			m_touchingPairs.erase( touching );
+	}
+	else if ( touching != m_touchingPairs.end() )
+		touching->second = after;
+	else
+		m_touchingPairs.emplace( key, after );
+
+	if ( before == 0 && after > 0 )
+	{
+		_out.push_back( *added );
+	}
+	else if ( before > 0 && after == 0 )
+	{
+		sPhysicsEventRecord record = *_pFirst;
+		record.type = WV_PHYSICS_EVENT_CONTACT_REMOVED;
+		_out.push_back( record );
+	}
+	else if ( after > 0 )
+	{
+		// still touching, through the same sub-shapes or new ones
+		const sPhysicsEventRecord* latest = persisted ? persisted : added;
+		sPhysicsEventRecord record = latest ? *latest : *_pFirst;
+		record.type = WV_PHYSICS_EVENT_CONTACT_PERSISTED;
+		_out.push_back( record );
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cPhysicsEventBuffer::collect( std::vector<sPhysicsEventRecord>& _out )
+{
+	_out.clear();
+	m_activations.clear();
+	m_contactSteps.clear();
+	m_pairs.clear();
+
+	m_records.clear();
+	for ( sThreadBuffer* buffer : m_buffers )
+	{
+		m_records.insert( m_records.end(), buffer->records.begin(), buffer->records.end() );
+		buffer->records.clear();
+	}
+
+	std::sort( m_records.begin(), m_records.end(), recordLess );
+
+	for ( size_t i = 0; i < m_records.size(); )
+	{
+		const sPhysicsEventRecord& first = m_records[ i ];
+
+		size_t end = i + 1;
+		while ( end < m_records.size() && m_records[ end ].step == first.step && 
+				isContact( m_records[ end ].type ) == isContact( first.type ) && mergeKey( m_records[ end ] ) == mergeKey( first ) )
+			end++;
+
+		if ( isContact( first.type ) )
+		{
+			countContacts( &m_records[ i ], m_records.data() + end, m_contactSteps );
+		}
+		else
+		{
+			// the latest activation state of a body wins, records come in step order
+			const sPhysicsEventRecord& record = m_records[ end - 1 ];
+			auto result = m_activations.try_emplace( record.bodyID1, _out.size() );
+			if ( result.second )
+				_out.push_back( record );
+			else
+				_out[ result.first->second ] = record;
+		}
+
+		i = end;
+	}
+
+	// one transition per pair and step, in step order. An add means the pair was not touching
+	// before that step, a remove means it is not touching after it
+	for ( size_t i = 0; i < m_contactSteps.size(); i++ )
+	{
+		const sPhysicsEventRecord& record = m_contactSteps[ i ];
+		auto result = m_pairs.try_emplace( mergeKey( record ), sPairTransitions{} );
+		sPairTransitions& pair = result.first->second;
+		if ( result.second )
+			pair.touchingBefore = record.type != WV_PHYSICS_EVENT_CONTACT_ADDED;
+
+		if ( record.type == WV_PHYSICS_EVENT_CONTACT_ADDED )
+		{
+			if ( pair.firstAdded == SIZE_MAX )
+				pair.firstAdded = i;
+			pair.lastAdded = i;
+		}
+		pair.last = i;
+	}
+
+	// what is dispatched follows the pair from where the update started to where the last step left it
+	for ( auto& [ key, pair ] : m_pairs )
+	{
+		const sPhysicsEventRecord& last = m_contactSteps[ pair.last ];
+		const bool touchingAfter = last.type != WV_PHYSICS_EVENT_CONTACT_REMOVED;
+
+		if ( !pair.touchingBefore && touchingAfter )
+		{
+			_out.push_back( m_contactSteps[ pair.lastAdded ] );
+		}
+		else if ( pair.touchingBefore && !touchingAfter )
+		{
+			_out.push_back( last );
+		}
+		else if ( pair.touchingBefore && touchingAfter )
+		{
+			sPhysicsEventRecord record = last;
+			record.type = WV_PHYSICS_EVENT_CONTACT_PERSISTED;
+			_out.push_back( record );
+		}
+		else
+		{
+			// touched and separated within the update, handlers still see both
+			_out.push_back( m_contactSteps[ pair.firstAdded ] );
+			_out.push_back( last );
+		}
+	}
+
+	std::stable_sort( _out.begin(), _out.end(), 
+		[]( const sPhysicsEventRecord& _a, const sPhysicsEventRecord& _b ) { return _a.step < _b.step; } );
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <wv/Physics/PhysicsTypes.h>
+
+#include <stdint.h>
+
+#include <vector>
+#include <atomic>
+#include <unordered_map>
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+namespace wv
+{
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	class cTaskScheduler;
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	/// <summary>
+	/// An event as recorded during the step, bodies are still physics engine body ids
+	/// </summary>
+	struct sPhysicsEventRecord
+	{
+		ePhysicsEventType type = WV_PHYSICS_EVENT_CONTACT_ADDED;
+		uint32_t step    = 0;
+		uint32_t bodyID1 = 0;
+		uint32_t bodyID2 = 0;
+
+		// which parts of a compound or mesh shape touch, a body pair can have many contacts
+		uint32_t subShapeID1 = 0;
+		uint32_t subShapeID2 = 0;
+
+		cVector3f point { 0.0f, 0.0f, 0.0f };
+		cVector3f normal{ 0.0f, 0.0f, 0.0f };
+		float     depth = 0.0f;
+	};
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	/// <summary>
+	/// Collects physics callbacks from the step without locking. Every scheduler worker 
+	/// writes to a buffer of its own, other threads share one behind a spinlock
+	/// </summary>
+	class cPhysicsEventBuffer
+	{
+	public:
+		 cPhysicsEventBuffer( cTaskScheduler* _pTaskScheduler );
+		~cPhysicsEventBuffer();
+
+		/// <summary>
+		/// Step number stamped on every record, set before the step runs
+		/// </summary>
+		void setStep( uint32_t _step ) { m_step = _step; }
+
+		void push( sPhysicsEventRecord& _record );
+
+		/// <summary>
+		/// Moves every record into _out ordered by step, and empties the buffers. 
+		/// Sub-shape contacts are counted per body pair, a pair is added when its first
+		/// contact starts and removed when its last one ends, however many come and go
+		/// in between. A pair gets one event from its touching state before the first step
+		/// and after the last: added, removed or persisted, or an add followed by a remove
+		/// if it touched and separated in between. Only the last activation change of a
+		/// body is kept. Nothing may push while this runs
+		/// </summary>
+		void collect( std::vector<sPhysicsEventRecord>& _out );
+
+		/// <summary>
+		/// Number of touching sub-shape contacts of every touching body pair, keyed by pairKey
+		/// </summary>
+		const std::unordered_map<uint64_t, uint32_t>& getTouchingPairs() { return m_touchingPairs; }
+		void setTouchingPairs( const std::unordered_map<uint64_t, uint32_t>& _pairs ) { m_touchingPairs = _pairs; }
+
+		/// <summary>
+		/// Either body order gives the same key, the lower id is in the high bits
+		/// </summary>
+		static uint64_t pairKey( uint32_t _bodyID1, uint32_t _bodyID2 );
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	private:
+
+		// kept a cache line apart so workers never write next to each other
+		struct alignas( 64 ) sThreadBuffer
+		{
+			std::vector<sPhysicsEventRecord> records;
+		};
+
+		cTaskScheduler* m_pTaskScheduler = nullptr;
+
+		// worker n writes to buffer n + 1, buffer 0 is shared by every other thread
+		std::vector<sThreadBuffer*> m_buffers;
+		std::atomic_flag m_sharedLock = ATOMIC_FLAG_INIT;
+
+		uint32_t m_step = 0;
+
+		void countContacts( const sPhysicsEventRecord* _pFirst, const sPhysicsEventRecord* _pEnd, std::vector<sPhysicsEventRecord>& _out );
+
+		// every record of the update in a fixed order, so the result does not depend on which thread pushed what
+		std::vector<sPhysicsEventRecord> m_records;
+
+		// kept across updates, a pair is only in here while it is touching
+		std::unordered_map<uint64_t, uint32_t> m_touchingPairs;
+
+		struct sPairTransitions
+		{
+			bool touchingBefore = false;
+			size_t firstAdded = SIZE_MAX;
+			size_t lastAdded  = SIZE_MAX;
+			size_t last       = 0;
+		};
+
+		// per step transitions of every body pair, and where each pair's are in it
+		std::vector<sPhysicsEventRecord> m_contactSteps;
+		std::unordered_map<uint64_t, sPairTransitions> m_pairs;
+
+		// index in the collected records of the activation event kept for a body
+		std::unordered_map<uint64_t, size_t> m_activations;
+	};
+
+}
@@ -0,0 +1,149 @@
+#include "PhysicsLayers.h"
+
+#include <wv/Debug/Print.h>
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+static const char* s_layerNames[] = {
+	"moving",
+	"static",
+	"debris",
+	"sensor",
+	"kinematic"
+};
+
+static const char* s_broadPhaseLayerNames[] = {
+	"static",
+	"moving",
+	"debris",
+	"sensor"
+};
+
+static_assert( sizeof( s_layerNames )           / sizeof( s_layerNames[ 0 ] )           == wv::WV_PHYSICS_LAYER_COUNT );
+static_assert( sizeof( s_broadPhaseLayerNames ) / sizeof( s_broadPhaseLayerNames[ 0 ] ) == wv::WV_PHYSICS_BROADPHASE_COUNT );
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+wv::sPhysicsLayerConfig::sPhysicsLayerConfig()
+{
+	broadPhaseLayer[ WV_PHYSICS_LAYER_MOVING ]    = WV_PHYSICS_BROADPHASE_MOVING;
+	broadPhaseLayer[ WV_PHYSICS_LAYER_STATIC ]    = WV_PHYSICS_BROADPHASE_STATIC;
+	broadPhaseLayer[ WV_PHYSICS_LAYER_DEBRIS ]    = WV_PHYSICS_BROADPHASE_DEBRIS;
+	broadPhaseLayer[ WV_PHYSICS_LAYER_SENSOR ]    = WV_PHYSICS_BROADPHASE_SENSOR;
+	broadPhaseLayer[ WV_PHYSICS_LAYER_KINEMATIC ] = WV_PHYSICS_BROADPHASE_MOVING;
+
+	const uint32_t moving    = 1u << WV_PHYSICS_LAYER_MOVING;
+	const uint32_t stat      = 1u << WV_PHYSICS_LAYER_STATIC;
+	const uint32_t debris    = 1u << WV_PHYSICS_LAYER_DEBRIS;
+	const uint32_t sensor    = 1u << WV_PHYSICS_LAYER_SENSOR;
+	const uint32_t kinematic = 1u << WV_PHYSICS_LAYER_KINEMATIC;
+
+	// debris never tests against other debris or sensors
+	collisionMask[ WV_PHYSICS_LAYER_MOVING ]    = moving | stat | debris | sensor | kinematic;
+	collisionMask[ WV_PHYSICS_LAYER_STATIC ]    = moving | debris;
+	collisionMask[ WV_PHYSICS_LAYER_DEBRIS ]    = moving | stat | kinematic;
+	collisionMask[ WV_PHYSICS_LAYER_SENSOR ]    = moving | kinematic;
+	collisionMask[ WV_PHYSICS_LAYER_KINEMATIC ] = moving | debris | sensor;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::sPhysicsLayerConfig::setCollidesWith( ePhysicsLayer _layer, ePhysicsLayer _other, bool _collides )
+{
+	if ( _collides )
+		collisionMask[ _layer ] |= 1u << _other;
+	else
+		collisionMask[ _layer ] &= ~( 1u << _other );
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+const char* wv::PhysicsLayers::getName( ePhysicsLayer _layer )
+{
+	if ( _layer >= WV_PHYSICS_LAYER_COUNT )
+		return "default";
+
+	return s_layerNames[ _layer ];
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+const char* wv::PhysicsLayers::getName( ePhysicsBroadPhaseLayer _layer )
+{
+	if ( _layer >= WV_PHYSICS_BROADPHASE_COUNT )
+		return "invalid";
+
+	return s_broadPhaseLayerNames[ _layer ];
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+bool wv::PhysicsLayers::fromName( const std::string& _name, ePhysicsLayer& _out )
+{
+	for ( int i = 0; i < WV_PHYSICS_LAYER_COUNT; i++ )
+	{
+		if ( _name != s_layerNames[ i ] )
+			continue;
+
+		_out = (ePhysicsLayer)i;
+		return true;
+	}
+
+	return false;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+bool wv::PhysicsLayers::fromName( const std::string& _name, ePhysicsBroadPhaseLayer& _out )
+{
+	for ( int i = 0; i < WV_PHYSICS_BROADPHASE_COUNT; i++ )
+	{
+		if ( _name != s_broadPhaseLayerNames[ i ] )
+			continue;
+
+		_out = (ePhysicsBroadPhaseLayer)i;
+		return true;
+	}
+
+	return false;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::PhysicsLayers::parse( const json11::Json& _json, sPhysicsLayerConfig& _config )
+{
+	for ( auto& entry : _json.object_items() )
+	{
+		ePhysicsLayer layer;
+		if ( !fromName( entry.first, layer ) )
+		{
+			Debug::Print( Debug::WV_PRINT_WARN, "Unknown physics layer '%s'\n", entry.first.c_str() );
+			continue;
+		}
+
+		const json11::Json& layerJson = entry.second;
+
+		if ( layerJson[ "broadphase" ].is_string() )
+		{
+			ePhysicsBroadPhaseLayer broadPhaseLayer;
+			if ( fromName( layerJson[ "broadphase" ].string_value(), broadPhaseLayer ) )
+				_config.broadPhaseLayer[ layer ] = broadPhaseLayer;
+			else
+				Debug::Print( Debug::WV_PRINT_WARN, "Unknown broad phase layer '%s'\n", layerJson[ "broadphase" ].string_value().c_str() );
+		}
+
+		if ( layerJson[ "collidesWith" ].is_array() )
+		{
+			_config.collisionMask[ layer ] = 0;
+
+			for ( auto& other : layerJson[ "collidesWith" ].array_items() )
+			{
+				ePhysicsLayer otherLayer;
+				if ( fromName( other.string_value(), otherLayer ) )
+					_config.setCollidesWith( layer, otherLayer, true );
+				else
+					Debug::Print( Debug::WV_PRINT_WARN, "Unknown physics layer '%s'\n", other.string_value().c_str() );
+			}
+		}
+	}
+}
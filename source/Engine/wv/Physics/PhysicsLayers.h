@@ -0,0 +1,83 @@
+#pragma once
+
+#include <wv/Auxiliary/json/json11.hpp>
+
+#include <stdint.h>
+
+#include <string>
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+namespace wv
+{
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	enum ePhysicsLayer
+	{
+		WV_PHYSICS_LAYER_MOVING,
+		WV_PHYSICS_LAYER_STATIC,
+		WV_PHYSICS_LAYER_DEBRIS,
+		WV_PHYSICS_LAYER_SENSOR,
+		WV_PHYSICS_LAYER_KINEMATIC,
+
+		WV_PHYSICS_LAYER_COUNT,
+
+		// static, moving or kinematic depending on the body kind
+		WV_PHYSICS_LAYER_DEFAULT = WV_PHYSICS_LAYER_COUNT
+	};
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	enum ePhysicsBroadPhaseLayer
+	{
+		WV_PHYSICS_BROADPHASE_STATIC,
+		WV_PHYSICS_BROADPHASE_MOVING,
+		WV_PHYSICS_BROADPHASE_DEBRIS,
+		WV_PHYSICS_BROADPHASE_SENSOR,
+
+		WV_PHYSICS_BROADPHASE_COUNT
+	};
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	/// <summary>
+	/// Which broad phase tree every layer lives in and which layers collide.
+	/// A pair of layers collides only if both of them list the other
+	/// </summary>
+	struct sPhysicsLayerConfig
+	{
+		sPhysicsLayerConfig();
+
+		void setCollidesWith( ePhysicsLayer _layer, ePhysicsLayer _other, bool _collides );
+		
+		bool collides( ePhysicsLayer _a, ePhysicsLayer _b ) const 
+		{ 
+			return ( collisionMask[ _a ] & ( 1u << _b ) ) && ( collisionMask[ _b ] & ( 1u << _a ) );
+		}
+
+		// the physics system is rebuilt when these change, which needs a world without bodies
+		ePhysicsBroadPhaseLayer broadPhaseLayer[ WV_PHYSICS_LAYER_COUNT ];
+		
+		// bit n is set if the layer wants to collide with layer n
+		uint32_t collisionMask[ WV_PHYSICS_LAYER_COUNT ];
+	};
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	namespace PhysicsLayers
+	{
+		const char* getName( ePhysicsLayer _layer );
+		const char* getName( ePhysicsBroadPhaseLayer _layer );
+
+		bool fromName( const std::string& _name, ePhysicsLayer& _out );
+		bool fromName( const std::string& _name, ePhysicsBroadPhaseLayer& _out );
+
+		/// <summary>
+		/// Overrides the layers present in _json, keeps the rest of _config as is.
+		/// { "debris": { "broadphase": "debris", "collidesWith": [ "static", "moving" ] } }
+		/// </summary>
+		void parse( const json11::Json& _json, sPhysicsLayerConfig& _config );
+	}
+
+}
@@ -3,6 +3,44 @@
 #include "PhysicsListeners.h"
 
 #include <wv/Debug/Print.h>
+#include <wv/Physics/PhysicsEventBuffer.h>
+
+#include <Jolt/Physics/Body/Body.h>
+#include <Jolt/Physics/Collision/ContactListener.h>
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+static void pushContact( wv::cPhysicsEventBuffer* _pEventBuffer, wv::ePhysicsEventType _type, const JPH::Body& _body1, const JPH::Body& _body2, const JPH::ContactManifold& _manifold )
+{
+	wv::sPhysicsEventRecord record;
+	record.type        = _type;
+	record.bodyID1     = _body1.GetID().GetIndexAndSequenceNumber();
+	record.bodyID2     = _body2.GetID().GetIndexAndSequenceNumber();
+	record.subShapeID1 = _manifold.mSubShapeID1.GetValue();
+	record.subShapeID2 = _manifold.mSubShapeID2.GetValue();
+	record.normal      = { _manifold.mWorldSpaceNormal.GetX(), _manifold.mWorldSpaceNormal.GetY(), _manifold.mWorldSpaceNormal.GetZ() };
+	record.depth       = _manifold.mPenetrationDepth;
+
+	if( !_manifold.mRelativeContactPointsOn1.empty() )
+	{
+		const JPH::RVec3 point = _manifold.GetWorldSpaceContactPointOn1( 0 );
+		record.point = { (float)point.GetX(), (float)point.GetY(), (float)point.GetZ() };
+	}
+
+	_pEventBuffer->push( record );
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+static void pushBody( wv::cPhysicsEventBuffer* _pEventBuffer, wv::ePhysicsEventType _type, const JPH::BodyID& _body1, const JPH::BodyID& _body2 )
+{
+	wv::sPhysicsEventRecord record;
+	record.type    = _type;
+	record.bodyID1 = _body1.GetIndexAndSequenceNumber();
+	record.bodyID2 = _body2.GetIndexAndSequenceNumber();
+
+	_pEventBuffer->push( record );
+}
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
@@ -17,6 +55,10 @@ JPH::ValidateResult wv::cJoltContactListener::OnContactValidate( const JPH::Body
 void wv::cJoltContactListener::OnContactAdded( const JPH::Body& inBody1, const JPH::Body& inBody2, const JPH::ContactManifold& inManifold, JPH::ContactSettings& ioSettings )
 {
 	// Debug::Print( Debug::WV_PRINT_DEBUG, "Physics contact was added\n" );
+	m_numAdded.fetch_add( 1, std::memory_order_relaxed );
+
+	if( m_pEventBuffer )
+		pushContact( m_pEventBuffer, WV_PHYSICS_EVENT_CONTACT_ADDED, inBody1, inBody2, inManifold );
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////
@@ -24,6 +66,10 @@ void wv::cJoltContactListener::OnContactAdded( const JPH::Body& inBody1, const J
 void wv::cJoltContactListener::OnContactPersisted( const JPH::Body& inBody1, const JPH::Body& inBody2, const JPH::ContactManifold& inManifold, JPH::ContactSettings& ioSettings )
 {
 	// Debug::Print( Debug::WV_PRINT_DEBUG, "Physics contact was persisted\n" );
+	m_numPersisted.fetch_add( 1, std::memory_order_relaxed );
+
+	if( m_pEventBuffer )
+		pushContact( m_pEventBuffer, WV_PHYSICS_EVENT_CONTACT_PERSISTED, inBody1, inBody2, inManifold );
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////
@@ -31,6 +77,27 @@ void wv::cJoltContactListener::OnContactPersisted( const JPH::Body& inBody1, con
 void wv::cJoltContactListener::OnContactRemoved( const JPH::SubShapeIDPair& inSubShapePair )
 {
 	// Debug::Print( Debug::WV_PRINT_DEBUG, "Physics contact was removed\n" );
+
+	// the bodies may be locked or gone here, they are looked up once the step is done
+	if( !m_pEventBuffer )
+		return;
+
+	wv::sPhysicsEventRecord record;
+	record.type        = WV_PHYSICS_EVENT_CONTACT_REMOVED;
+	record.bodyID1     = inSubShapePair.GetBody1ID().GetIndexAndSequenceNumber();
+	record.bodyID2     = inSubShapePair.GetBody2ID().GetIndexAndSequenceNumber();
+	record.subShapeID1 = inSubShapePair.GetSubShapeID1().GetValue();
+	record.subShapeID2 = inSubShapePair.GetSubShapeID2().GetValue();
+
+	m_pEventBuffer->push( record );
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cJoltContactListener::resetCounters()
+{
+	m_numAdded.store( 0, std::memory_order_relaxed );
+	m_numPersisted.store( 0, std::memory_order_relaxed );
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////
@@ -38,6 +105,9 @@ void wv::cJoltContactListener::OnContactRemoved( const JPH::SubShapeIDPair& inSu
 void wv::cJoltBodyActivationListener::OnBodyActivated( const JPH::BodyID& inBodyID, JPH::uint64 inBodyUserData )
 {
 	// Debug::Print( Debug::WV_PRINT_DEBUG, "Physics body was activated\n" );
+
+	if( m_pEventBuffer )
+		pushBody( m_pEventBuffer, WV_PHYSICS_EVENT_BODY_ACTIVATED, inBodyID, JPH::BodyID() );
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////
@@ -45,6 +115,24 @@ void wv::cJoltBodyActivationListener::OnBodyActivated( const JPH::BodyID& inBody
 void wv::cJoltBodyActivationListener::OnBodyDeactivated( const JPH::BodyID& inBodyID, JPH::uint64 inBodyUserData )
 {
 	// Debug::Print( Debug::WV_PRINT_DEBUG, "Physics body went to sleep\n" );
+
+	if( m_pEventBuffer )
+		pushBody( m_pEventBuffer, WV_PHYSICS_EVENT_BODY_DEACTIVATED, inBodyID, JPH::BodyID() );
+
+	while( m_deactivatedLock.test_and_set( std::memory_order_acquire ) ) { }
+	m_deactivated.push_back( inBodyID );
+	m_deactivatedLock.clear( std::memory_order_release );
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cJoltBodyActivationListener::takeDeactivated( std::vector<JPH::BodyID>& _out )
+{
+	_out.clear();
+
+	while( m_deactivatedLock.test_and_set( std::memory_order_acquire ) ) { }
+	std::swap( _out, m_deactivated );
+	m_deactivatedLock.clear( std::memory_order_release );
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////
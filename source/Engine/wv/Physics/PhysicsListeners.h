@@ -6,6 +6,11 @@
 #include <Jolt/Physics/Collision/ContactListener.h>
 #include <Jolt/Physics/Body/BodyActivationListener.h>
 
+#include <stdint.h>
+
+#include <atomic>
+#include <vector>
+
 ///////////////////////////////////////////////////////////////////////////////////////
 
 namespace wv
@@ -13,14 +18,36 @@ namespace wv
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
+	class cPhysicsEventBuffer;
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	/// <summary>
+	/// Records contacts into the event buffer, called from every thread running the step
+	/// </summary>
 	class cJoltContactListener : public JPH::ContactListener
 	{
 	public:
+		cJoltContactListener( cPhysicsEventBuffer* _pEventBuffer ) : m_pEventBuffer{ _pEventBuffer } { }
+
 		virtual JPH::ValidateResult OnContactValidate ( const JPH::Body& inBody1, const JPH::Body& inBody2, JPH::RVec3Arg inBaseOffset, const JPH::CollideShapeResult& inCollisionResult ) override;
 		virtual void                OnContactAdded    ( const JPH::Body& inBody1, const JPH::Body& inBody2, const JPH::ContactManifold& inManifold, JPH::ContactSettings& ioSettings )     override;
 		virtual void                OnContactPersisted( const JPH::Body& inBody1, const JPH::Body& inBody2, const JPH::ContactManifold& inManifold, JPH::ContactSettings& ioSettings )     override;
 		virtual void                OnContactRemoved  ( const JPH::SubShapeIDPair& inSubShapePair )                                                                                        override;
 
+		void resetCounters();
+
+		uint32_t getNumAdded()     { return m_numAdded.load( std::memory_order_relaxed ); }
+		uint32_t getNumPersisted() { return m_numPersisted.load( std::memory_order_relaxed ); }
+
+	private:
+
+		cPhysicsEventBuffer* m_pEventBuffer = nullptr;
+
+		// callbacks come from every job thread
+		std::atomic<uint32_t> m_numAdded    { 0 };
+		std::atomic<uint32_t> m_numPersisted{ 0 };
+
 	};
 
 ///////////////////////////////////////////////////////////////////////////////////////
@@ -28,9 +55,25 @@ namespace wv
 	class cJoltBodyActivationListener : public JPH::BodyActivationListener
 	{
 	public:
+		cJoltBodyActivationListener( cPhysicsEventBuffer* _pEventBuffer ) : m_pEventBuffer{ _pEventBuffer } { }
+
 		virtual void OnBodyActivated  ( const JPH::BodyID& inBodyID, JPH::uint64 inBodyUserData ) override;
 		virtual void OnBodyDeactivated( const JPH::BodyID& inBodyID, JPH::uint64 inBodyUserData ) override;
 
+		/// <summary>
+		/// Swaps out every body that went to sleep since the last call, a body can be 
+		/// in there more than once and may have woken up again since
+		/// </summary>
+		void takeDeactivated( std::vector<JPH::BodyID>& _out );
+
+	private:
+
+		cPhysicsEventBuffer* m_pEventBuffer = nullptr;
+
+		// callbacks come from every job thread
+		std::vector<JPH::BodyID> m_deactivated;
+		std::atomic_flag m_deactivatedLock = ATOMIC_FLAG_INIT;
+
 	};
 
 }
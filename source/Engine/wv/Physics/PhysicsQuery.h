@@ -0,0 +1,107 @@
+#pragma once
+
+#include <wv/Math/Vector3.h>
+#include <wv/Physics/PhysicsTypes.h>
+#include <wv/Physics/PhysicsLayers.h>
+
+#include <stdint.h>
+
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+namespace wv
+{
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	struct iPhysicsBodyDesc;
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	/// <summary>
+	/// Closest hit of every ray or shape cast in a batch, entry i belongs to query i.
+	/// Entries of queries that missed are left at their defaults
+	/// </summary>
+	struct sPhysicsCastResults
+	{
+		std::vector<uint8_t>      hits;
+		std::vector<float>        fractions; // along the direction, [0, 1]
+		std::vector<cVector3f>    points;
+		std::vector<cVector3f>    normals;
+		std::vector<hPhysicsBody> bodies;
+		std::vector<uint32_t>     userData;
+
+		void reset( size_t _count )
+		{
+			hits     .assign( _count, 0 );
+			fractions.assign( _count, 1.0f );
+			points   .assign( _count, cVector3f{ 0.0f, 0.0f, 0.0f } );
+			normals  .assign( _count, cVector3f{ 0.0f, 0.0f, 0.0f } );
+			bodies   .assign( _count, hPhysicsBody{ 0 } );
+			userData .assign( _count, 0 );
+		}
+	};
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	struct sPhysicsRayBatch
+	{
+		// hits whatever this layer collides with
+		ePhysicsLayer layer = WV_PHYSICS_LAYER_MOVING;
+
+		// the length of a direction is the length of its ray
+		std::vector<cVector3f> origins;
+		std::vector<cVector3f> directions;
+
+		sPhysicsCastResults results;
+
+		size_t size() { return origins.size(); }
+		void   add  ( const cVector3f& _origin, const cVector3f& _direction ) { origins.push_back( _origin ); directions.push_back( _direction ); }
+		void   clear() { origins.clear(); directions.clear(); }
+	};
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	struct sPhysicsShapeCastBatch
+	{
+		ePhysicsLayer layer = WV_PHYSICS_LAYER_MOVING;
+
+		// shared by every cast, the orientation and scale come from its transform
+		iPhysicsBodyDesc* pShape = nullptr;
+
+		std::vector<cVector3f> origins;
+		std::vector<cVector3f> directions;
+
+		sPhysicsCastResults results;
+
+		size_t size() { return origins.size(); }
+		void   add  ( const cVector3f& _origin, const cVector3f& _direction ) { origins.push_back( _origin ); directions.push_back( _direction ); }
+		void   clear() { origins.clear(); directions.clear(); }
+	};
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	struct sPhysicsOverlapBatch
+	{
+		ePhysicsLayer layer = WV_PHYSICS_LAYER_MOVING;
+
+		// shared by every query, the orientation and scale come from its transform
+		iPhysicsBodyDesc* pShape = nullptr;
+
+		// bodies past this are dropped
+		uint32_t maxHits = 16;
+
+		std::vector<cVector3f> positions;
+
+		// query i owns hitBodies[ i * maxHits ] to hitBodies[ i * maxHits + numHits[ i ] - 1 ]
+		std::vector<uint32_t>     numHits;
+		std::vector<hPhysicsBody> hitBodies;
+		std::vector<uint32_t>     hitUserData;
+
+		size_t size() { return positions.size(); }
+		void   add  ( const cVector3f& _position ) { positions.push_back( _position ); }
+		void   clear() { positions.clear(); }
+	};
+
+}
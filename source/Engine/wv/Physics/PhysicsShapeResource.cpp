@@ -0,0 +1,110 @@
+#include "PhysicsShapeResource.h"
+
+#include <wv/Physics/PhysicsCooker.h>
+#include <wv/Memory/FileSystem.h>
+#include <wv/Memory/ModelParser.h>
+#include <wv/Primitive/Mesh.h>
+#include <wv/Resource/ResourceRegistry.h>
+#include <wv/Debug/Print.h>
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cPhysicsShapeResource::load( cFileSystem* _pFileSystem, iGraphicsDevice* _pGraphicsDevice )
+{
+#ifdef WV_SUPPORT_JOLT_PHYSICS
+	std::vector<uint8_t> data;
+
+	// the registry leaves the path empty if the file does not exist
+	if( m_path != "" )
+	{
+		Memory* mem = _pFileSystem->loadMemory( m_path );
+		if( mem )
+		{
+			data.assign( mem->data, mem->data + mem->size );
+			_pFileSystem->unloadMemory( mem );
+		}
+	}
+
+	if( data.empty() && !cookFromSource( _pFileSystem, data ) )
+	{
+		Debug::Print( Debug::WV_PRINT_ERROR, "Failed to load physics shape '%s'\n", m_name.c_str() );
+		m_failed = true;
+		return;
+	}
+
+	m_shape = PhysicsCooker::restore( data.data(), data.size() );
+	if( m_shape == nullptr )
+	{
+		// restore has already said why
+		m_failed = true;
+		return;
+	}
+
+	setComplete( true );
+#else
+	Debug::Print( Debug::WV_PRINT_ERROR, "Physics shapes require Jolt Physics\n" );
+	m_failed = true;
+#endif // WV_SUPPORT_JOLT_PHYSICS
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cPhysicsShapeResource::unload( cFileSystem* _pFileSystem, iGraphicsDevice* _pGraphicsDevice )
+{
+#ifdef WV_SUPPORT_JOLT_PHYSICS
+	// bodies using the shape keep their own reference
+	m_shape = nullptr;
+#endif // WV_SUPPORT_JOLT_PHYSICS
+	setComplete( false );
+	m_failed = false;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+bool wv::cPhysicsShapeResource::cookFromSource( cFileSystem* _pFileSystem, std::vector<uint8_t>& _out )
+{
+#ifdef WV_DEBUG
+	std::string   source;
+	ePhysicsShape shape;
+	if( !PhysicsCooker::parseCookedPath( m_name, source, shape ) )
+		return false;
+
+	std::string sourcePath = _pFileSystem->getFullPath( source );
+	if( sourcePath == "" )
+	{
+		Debug::Print( Debug::WV_PRINT_ERROR, "Source mesh '%s' not found\n", source.c_str() );
+		return false;
+	}
+
+	// the parser needs a graphics device, a headless server only loads cooked shapes
+	if( !m_pResourceRegistry || !m_pResourceRegistry->getGraphicsDevice() )
+	{
+		Debug::Print( Debug::WV_PRINT_ERROR, "'%s' is not cooked and cannot be cooked without a graphics device\n", m_name.c_str() );
+		return false;
+	}
+
+	Debug::Print( Debug::WV_PRINT_WARN, "'%s' is not cooked, cooking it from '%s'\n", m_name.c_str(), sourcePath.c_str() );
+
+	// only the triangles are used
+	wv::Parser parser;
+	parser.settings.generateLODs        = false;
+	parser.settings.optimizeVertexCache = false;
+	parser.settings.optimizeVertexFetch = false;
+	
+	sMeshNode* node = parser.load( sourcePath.c_str(), m_pResourceRegistry );
+	if( !node )
+		return false;
+
+	const bool cooked = PhysicsCooker::cook( node, shape, _out );
+	unloadMeshNode( node, m_pResourceRegistry->getGraphicsDevice() );
+
+	if( !cooked )
+		return false;
+
+	// saved for the next run, and to be shipped instead of the source
+	_pFileSystem->saveMemory( PhysicsCooker::getCookedPath( sourcePath, shape ), _out.data(), (unsigned int)_out.size() );
+	return true;
+#else
+	return false;
+#endif // WV_DEBUG
+}
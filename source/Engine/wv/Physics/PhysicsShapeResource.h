@@ -0,0 +1,70 @@
+#pragma once
+
+#include <wv/Resource/Resource.h>
+
+#ifdef WV_SUPPORT_JOLT_PHYSICS
+#include <Jolt/Jolt.h>
+#include <Jolt/Physics/Collision/Shape/Shape.h>
+#endif // WV_SUPPORT_JOLT_PHYSICS
+
+#include <stdint.h>
+
+#include <vector>
+#include <atomic>
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+namespace wv
+{
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	class cResourceRegistry;
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	/// <summary>
+	/// A cooked mesh or convex hull shape, named by PhysicsCooker::getCookedPath.
+	/// Debug builds cook a missing shape from its source mesh and save it next to it
+	/// </summary>
+	class cPhysicsShapeResource : public iResource
+	{
+	public:
+		cPhysicsShapeResource( const std::string& _name, const std::string& _path ) :
+			iResource( _name, _path )
+		{ }
+
+		void load  ( cFileSystem* _pFileSystem, iGraphicsDevice* _pGraphicsDevice ) override;
+		void unload( cFileSystem* _pFileSystem, iGraphicsDevice* _pGraphicsDevice ) override;
+
+	#ifdef WV_SUPPORT_JOLT_PHYSICS
+		JPH::ShapeRefC getShape() { return m_shape; }
+	#endif // WV_SUPPORT_JOLT_PHYSICS
+
+		/// <summary>
+		/// Set if the shape could neither be read nor cooked. It never completes in that case
+		/// </summary>
+		bool hasFailed() { return m_failed.load(); }
+
+		/// <summary>
+		/// Set by the registry that loads the shape, before the load is queued
+		/// </summary>
+		void setResourceRegistry( cResourceRegistry* _pResourceRegistry ) { m_pResourceRegistry = _pResourceRegistry; }
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	private:
+
+		bool cookFromSource( cFileSystem* _pFileSystem, std::vector<uint8_t>& _out );
+
+	#ifdef WV_SUPPORT_JOLT_PHYSICS
+		JPH::ShapeRefC m_shape;
+	#endif // WV_SUPPORT_JOLT_PHYSICS
+
+		cResourceRegistry* m_pResourceRegistry = nullptr;
+
+		// written by the loader task, read on the main thread
+		std::atomic<bool> m_failed{ false };
+	};
+
+}
@@ -1,7 +1,10 @@
 #pragma once
 
 #include <wv/Types.h>
+#include <wv/Math/Vector3.h>
+#include <wv/Math/Quaternion.h>
 
+#include <stdint.h>
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
@@ -10,5 +13,94 @@ namespace wv
 	
 	DEFINE_UNIQUE_HANDLE( PhysicsBody );
 
-}
+///////////////////////////////////////////////////////////////////////////////////////
+
+	/// <summary>
+	/// Pose of a body that moved during the last physics update
+	/// </summary>
+	struct sPhysicsBodyTransform
+	{
+		hPhysicsBody body{ 0 };
+		
+		// set through setBodyUserData, lets the owner find its slot without a lookup
+		uint32_t userData = 0;
+
+		cVector3f    position{};
+		cQuaternionf orientation{};
+
+		// pose one fixed step earlier, blend towards position/orientation by the interpolation alpha
+		cVector3f    previousPosition{};
+		cQuaternionf previousOrientation{};
+	};
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	/// <summary>
+	/// Counters from the last physics update that ran at least one step
+	/// </summary>
+	struct sPhysicsStats
+	{
+		uint32_t numSteps   = 0;
+		double   updateTime = 0.0; // milliseconds, every step of the update
+		double   stepTime   = 0.0; // milliseconds, average of one step
+
+		uint32_t numBodies       = 0;
+		uint32_t numActiveBodies = 0;
+		uint32_t maxBodies       = 0;
+
+		// contact manifolds of the last step, each is one contact constraint between a touching body pair
+		uint32_t numContacts           = 0;
+		uint32_t numNewContacts        = 0;
+		uint32_t maxBodyPairs          = 0;
+		uint32_t maxContactConstraints = 0;
+
+		// body pairs with at least one contact after the last step
+		uint32_t numBodyPairs = 0;
+
+		// groups of active bodies linked by contacts or constraints, each group is solved on its own
+		uint32_t numIslands = 0;
+
+		// bytes
+		uint32_t tempAllocatorHighWater = 0;
+		uint32_t tempAllocatorSize      = 0;
+
+		// set when the step had to drop pairs or contacts
+		bool bodyPairCacheFull      = false;
+		bool manifoldCacheFull      = false;
+		bool contactConstraintsFull = false;
+	};
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	enum ePhysicsEventType
+	{
+		WV_PHYSICS_EVENT_CONTACT_ADDED,
+		WV_PHYSICS_EVENT_CONTACT_PERSISTED,
+		WV_PHYSICS_EVENT_CONTACT_REMOVED,
+		WV_PHYSICS_EVENT_BODY_ACTIVATED,
+		WV_PHYSICS_EVENT_BODY_DEACTIVATED
+	};
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	/// <summary>
+	/// Contact or activation change from the last physics update. 
+	/// A body pair reports at most one of each contact event per update
+	/// </summary>
+	struct sPhysicsEvent
+	{
+		ePhysicsEventType type = WV_PHYSICS_EVENT_CONTACT_ADDED;
+
+		// body2 is left invalid for activation events, either is invalid if the body no longer exists
+		hPhysicsBody body1{ 0 };
+		hPhysicsBody body2{ 0 };
+		uint32_t userData1 = 0;
+		uint32_t userData2 = 0;
+
+		// not set for removed contacts, the normal points from body1 towards body2
+		cVector3f point { 0.0f, 0.0f, 0.0f };
+		cVector3f normal{ 0.0f, 0.0f, 0.0f };
+		float     depth = 0.0f;
+	};
 
+}
\ No newline at end of file
@@ -4,6 +4,10 @@
 #include <wv/Engine/Engine.h>
 #include <wv/Device/GraphicsDevice.h>
 #include <wv/Resource/ResourceRegistry.h>
+#include <wv/Graphics/OcclusionCuller.h>
+#include <wv/Camera/Camera.h>
+
+#include <math.h>
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
@@ -23,18 +27,15 @@ void wv::sMeshInstance::destroy()
 
 void wv::cMeshResource::load( cFileSystem* _pFileSystem, iGraphicsDevice* _pGraphicsDevice )
 {
-	cEngine* app = cEngine::get();
-
 	wv::Parser parser;
-	m_pMeshNode = parser.load( m_path.c_str(), app->m_pResourceRegistry );
+	m_pMeshNode = parser.load( m_path.c_str(), m_pResourceRegistry );
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
-static void unloadMesh( wv::sMesh* _mesh )
+static void unloadMesh( wv::sMesh* _mesh, wv::iGraphicsDevice* _pGraphicsDevice )
 {
-	wv::iGraphicsDevice* pGraphicsDevice = wv::cEngine::get()->graphics;
-	wv::cCommandBuffer& cmdBuffer = pGraphicsDevice->getCommandBuffer();
+	wv::cCommandBuffer& cmdBuffer = _pGraphicsDevice->getCommandBuffer();
 	
 	for ( auto& primitive : _mesh->primitives )
 		cmdBuffer.push( wv::WV_GPUTASK_DESTROY_PRIMITIVE, &primitive );
@@ -47,23 +48,27 @@ static void unloadMesh( wv::sMesh* _mesh )
 
 	cmdBuffer.callbacker = _mesh;
 
-	pGraphicsDevice->submitCommandBuffer( cmdBuffer );
+	_pGraphicsDevice->submitCommandBuffer( cmdBuffer );
 }
 
-static void unloadMeshNode( wv::sMeshNode* _node )
+void wv::unloadMeshNode( sMeshNode* _node, iGraphicsDevice* _pGraphicsDevice )
 {
 	for ( auto& mesh : _node->meshes )
-		unloadMesh( mesh );
+		unloadMesh( mesh, _pGraphicsDevice );
 	
 	for ( auto& child : _node->children )
-		unloadMeshNode( child );
+		unloadMeshNode( child, _pGraphicsDevice );
 	
 	delete _node;
 }
 
 void wv::cMeshResource::unload( cFileSystem* _pFileSystem, iGraphicsDevice* _pGraphicsDevice )
 {
-	unloadMeshNode( m_pMeshNode );
+	if ( m_pMeshNode == nullptr )
+		return;
+
+	unloadMeshNode( m_pMeshNode, _pGraphicsDevice );
+	m_pMeshNode = nullptr;
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////
@@ -78,8 +83,7 @@ wv::sMeshInstance wv::cMeshResource::createInstance()
 
 void wv::cMeshResource::destroyInstance( sMeshInstance& _instance )
 {
-	cEngine* app = cEngine::get();
-	app->m_pResourceRegistry->unload( _instance.pResource );
+	m_pResourceRegistry->unload( _instance.pResource );
 
 	_instance.pResource = nullptr;
 }
@@ -88,12 +92,111 @@ void wv::cMeshResource::destroyInstance( sMeshInstance& _instance )
 
 void wv::cMeshResource::addToDrawQueue( sMeshInstance& _instance )
 {
-	m_drawQueue.push_back( _instance.transform );
+	m_drawQueue.push_back( { &_instance.transform.getMatrix(), &_instance.lod, _instance.occluder } );
+}
+
+void wv::cMeshResource::addToDrawQueue( const cMatrix4x4f* _pMatrix, uint32_t* _pLod, bool _occluder )
+{
+	m_drawQueue.push_back( { _pMatrix, _pLod, _occluder } );
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+static void addNodeOccluders( wv::cOcclusionCuller* _pCuller, wv::sMeshNode* _node )
+{
+	for ( auto& mesh : _node->meshes )
+		_pCuller->addOccluder( mesh );
+
+	for ( auto& child : _node->children )
+		addNodeOccluders( _pCuller, child );
+}
+
+void wv::cMeshResource::addOccluders( cOcclusionCuller* _pCuller )
+{
+	if ( m_pMeshNode == nullptr )
+		return;
+
+	for ( auto& item : m_drawQueue )
+	{
+		if ( !item.occluder )
+			continue;
+
+		m_pMeshNode->transform.update( *item.pMatrix );
+		addNodeOccluders( _pCuller, m_pMeshNode );
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+static void drawNodeCulled( wv::iGraphicsDevice* _pGraphicsDevice, wv::cOcclusionCuller* _pCuller, wv::sMeshNode* _node, uint32_t _lod )
+{
+	for ( auto& mesh : _node->meshes )
+	{
+		if ( _pCuller->isVisible( mesh->bounds, mesh->transform.getMatrix() ) )
+			_pGraphicsDevice->draw( mesh, _lod );
+	}
+
+	for ( auto& child : _node->children )
+		drawNodeCulled( _pGraphicsDevice, _pCuller, child, _lod );
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
-void wv::cMeshResource::drawInstances( iGraphicsDevice* _pGraphicsDevice )
+// projected bounding sphere radius relative to half the screen height
+static float getNodeScreenSize( wv::sMeshNode* _node, const wv::cVector3f& _cameraPosition, float _tanHalfFov )
+{
+	float size = 0.0f;
+
+	for ( auto& mesh : _node->meshes )
+	{
+		if ( !mesh->bounds.isValid() )
+			continue;
+
+		const wv::cMatrix4x4f& m = mesh->transform.getMatrix();
+		wv::cVector3f c = mesh->bounds.getCenter();
+		wv::cVector3f center{
+			c.x * m.m[ 0 ][ 0 ] + c.y * m.m[ 1 ][ 0 ] + c.z * m.m[ 2 ][ 0 ] + m.m[ 3 ][ 0 ],
+			c.x * m.m[ 0 ][ 1 ] + c.y * m.m[ 1 ][ 1 ] + c.z * m.m[ 2 ][ 1 ] + m.m[ 3 ][ 1 ],
+			c.x * m.m[ 0 ][ 2 ] + c.y * m.m[ 1 ][ 2 ] + c.z * m.m[ 2 ][ 2 ] + m.m[ 3 ][ 2 ]
+		};
+
+		float scale = 0.0f;
+		for ( int i = 0; i < 3; i++ )
+			scale = fmaxf( scale, sqrtf( m.m[ i ][ 0 ] * m.m[ i ][ 0 ] + m.m[ i ][ 1 ] * m.m[ i ][ 1 ] + m.m[ i ][ 2 ] * m.m[ i ][ 2 ] ) );
+
+		float radius   = mesh->bounds.getExtents().length() * scale;
+		float distance = ( center - _cameraPosition ).length();
+		
+		if ( distance <= radius )
+			return 1e30f;
+
+		size = fmaxf( size, radius / ( distance * _tanHalfFov ) );
+	}
+
+	for ( auto& child : _node->children )
+		size = fmaxf( size, getNodeScreenSize( child, _cameraPosition, _tanHalfFov ) );
+
+	return size;
+}
+
+static uint32_t selectLOD( uint32_t _current, float _screenSize )
+{
+	// screen size below which lod n + 1 is used
+	const float thresholds[ WV_MAX_PRIMITIVE_LODS - 1 ] = { 0.4f, 0.2f, 0.1f };
+	const float hysteresis = 0.15f;
+
+	uint32_t lod = _current < WV_MAX_PRIMITIVE_LODS ? _current : WV_MAX_PRIMITIVE_LODS - 1;
+
+	while ( lod < WV_MAX_PRIMITIVE_LODS - 1 && _screenSize < thresholds[ lod ] * ( 1.0f - hysteresis ) )
+		lod++;
+
+	while ( lod > 0 && _screenSize > thresholds[ lod - 1 ] * ( 1.0f + hysteresis ) )
+		lod--;
+
+	return lod;
+}
+
+void wv::cMeshResource::drawInstances( iGraphicsDevice* _pGraphicsDevice, cOcclusionCuller* _pCuller )
 {
 	if ( m_pMeshNode == nullptr )
 	{
@@ -101,10 +204,29 @@ void wv::cMeshResource::drawInstances( iGraphicsDevice* _pGraphicsDevice )
 		return;
 	}
 
-	for ( auto& transform : m_drawQueue )
+	iCamera* camera = cEngine::get()->currentCamera;
+	
+	cVector3f cameraPosition{};
+	float tanHalfFov = 0.0f;
+	if ( camera && camera->getType() == iCamera::WV_CAMERA_TYPE_PERSPECTIVE )
 	{
-		m_pMeshNode->transform.update( &transform );
-		_pGraphicsDevice->drawNode( m_pMeshNode );
+		// world position, the local one is wrong for a parented camera
+		const cMatrix4x4f& cameraMatrix = camera->getTransform().getMatrix();
+		cameraPosition = { cameraMatrix.m[ 3 ][ 0 ], cameraMatrix.m[ 3 ][ 1 ], cameraMatrix.m[ 3 ][ 2 ] };
+		tanHalfFov = tanf( Math::radians( camera->fov ) * 0.5f );
+	}
+
+	for ( auto& item : m_drawQueue )
+	{
+		m_pMeshNode->transform.update( *item.pMatrix );
+
+		if ( tanHalfFov > 0.0f )
+			*item.pLod = selectLOD( *item.pLod, getNodeScreenSize( m_pMeshNode, cameraPosition, tanHalfFov ) );
+
+		if ( _pCuller )
+			drawNodeCulled( _pGraphicsDevice, _pCuller, m_pMeshNode, *item.pLod );
+		else
+			_pGraphicsDevice->drawNode( m_pMeshNode, *item.pLod );
 	}
 
 	m_drawQueue.clear();
@@ -2,6 +2,7 @@
 
 #include <wv/Math/Transform.h>
 #include <wv/Math/Triangle.h>
+#include <wv/Math/BoundingBox.h>
 #include <wv/Primitive/Primitive.h>
 #include <wv/Types.h>
 
@@ -24,6 +25,7 @@ namespace wv
 		Transformf transform;
 		std::vector<Primitive*> primitives;
 		std::vector<Triangle3f> triangles;
+		cBoundingBoxf bounds;
 	};
 
 	struct sMeshNode
@@ -34,9 +36,16 @@ namespace wv
 		std::vector<sMeshNode*> children;
 	};
 
+	/// <summary>
+	/// Destroys the primitives of every mesh below _node on _pGraphicsDevice and deletes it
+	/// </summary>
+	void unloadMeshNode( sMeshNode* _node, iGraphicsDevice* _pGraphicsDevice );
+
 ///////////////////////////////////////////////////////////////////////////////////////
 
 	class cMeshResource;
+	class cOcclusionCuller;
+	class cResourceRegistry;
 
 	struct sMeshInstance
 	{
@@ -47,6 +56,22 @@ namespace wv
 
 		Transformf transform;
 		cMeshResource* pResource;
+
+		// rasterized into the occlusion buffer before anything is drawn
+		bool occluder = false;
+
+		// lod selected last frame, used for hysteresis
+		uint32_t lod = 0;
+	};
+
+	/// <summary>
+	/// One queued draw, points into the owner so it has to stay alive until drawInstances
+	/// </summary>
+	struct sMeshDrawItem
+	{
+		const cMatrix4x4f* pMatrix;
+		uint32_t* pLod;
+		bool occluder;
 	};
 
 ///////////////////////////////////////////////////////////////////////////////////////
@@ -64,18 +89,26 @@ namespace wv
 		sMeshInstance createInstance();
 		void destroyInstance( sMeshInstance& _instance );
 
-		std::vector<Transformf>& getDrawQueue() { return m_drawQueue; }
+		std::vector<sMeshDrawItem>& getDrawQueue() { return m_drawQueue; }
 		
 		void addToDrawQueue( sMeshInstance& _instance );
+		void addToDrawQueue( const cMatrix4x4f* _pMatrix, uint32_t* _pLod, bool _occluder );
+
+		void addOccluders( cOcclusionCuller* _pCuller );
+		void drawInstances( iGraphicsDevice* _pGraphicsDevice, cOcclusionCuller* _pCuller = nullptr );
 
-		void drawInstances( iGraphicsDevice* _pGraphicsDevice );
+		/// <summary>
+		/// Set by the registry that loads the mesh, before the load is queued
+		/// </summary>
+		void setResourceRegistry( cResourceRegistry* _pResourceRegistry ) { m_pResourceRegistry = _pResourceRegistry; }
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
 	private:
 		sMeshNode* m_pMeshNode = nullptr;
+		cResourceRegistry* m_pResourceRegistry = nullptr;
 
-		std::vector<Transformf> m_drawQueue; /// sMeshInstanceData ?
+		std::vector<sMeshDrawItem> m_drawQueue;
 	};
 
 
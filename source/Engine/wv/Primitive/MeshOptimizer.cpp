@@ -0,0 +1,627 @@
+#include "MeshOptimizer.h"
+
+#include <wv/Math/BoundingBox.h>
+
+#include <unordered_map>
+#include <algorithm>
+#include <string.h>
+#include <math.h>
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+struct sPositionKey
+{
+	float x, y, z;
+
+	bool operator==( const sPositionKey& _o ) const { return x == _o.x && y == _o.y && z == _o.z; }
+};
+
+struct sPositionKeyHash
+{
+	size_t operator()( const sPositionKey& _key ) const
+	{
+		uint32_t h[ 3 ];
+		memcpy( h, &_key, sizeof( h ) );
+		return ( (size_t)h[ 0 ] * 73856093u ) ^ ( (size_t)h[ 1 ] * 19349663u ) ^ ( (size_t)h[ 2 ] * 83492791u );
+	}
+};
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+struct sQuadric
+{
+	// upper triangle of the symmetric 4x4 plane matrix
+	double a2 = 0, ab = 0, ac = 0, ad = 0;
+	double b2 = 0, bc = 0, bd = 0;
+	double c2 = 0, cd = 0;
+	double d2 = 0;
+	double weight = 0;
+
+	void addPlane( double _a, double _b, double _c, double _d, double _weight )
+	{
+		a2 += _a * _a * _weight; ab += _a * _b * _weight; ac += _a * _c * _weight; ad += _a * _d * _weight;
+		b2 += _b * _b * _weight; bc += _b * _c * _weight; bd += _b * _d * _weight;
+		c2 += _c * _c * _weight; cd += _c * _d * _weight;
+		d2 += _d * _d * _weight;
+		weight += _weight;
+	}
+
+	void add( const sQuadric& _o )
+	{
+		a2 += _o.a2; ab += _o.ab; ac += _o.ac; ad += _o.ad;
+		b2 += _o.b2; bc += _o.bc; bd += _o.bd;
+		c2 += _o.c2; cd += _o.cd;
+		d2 += _o.d2;
+		weight += _o.weight;
+	}
+
+	// weighted mean squared distance to the accumulated planes
+	double error( const wv::cVector3f& _p ) const
+	{
+		double x = _p.x, y = _p.y, z = _p.z;
+		double e = a2 * x * x + 2.0 * ab * x * y + 2.0 * ac * x * z + 2.0 * ad * x
+			     + b2 * y * y + 2.0 * bc * y * z + 2.0 * bd * y
+			     + c2 * z * z + 2.0 * cd * z
+			     + d2;
+
+		if ( weight <= 0.0 )
+			return 0.0;
+
+		return e > 0.0 ? e / weight : 0.0;
+	}
+};
+
+struct sCollapse
+{
+	uint32_t from;
+	uint32_t to;
+	double cost;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+static uint64_t edgeKey( uint32_t _a, uint32_t _b )
+{
+	return _a < _b ? ( (uint64_t)_a << 32 ) | _b : ( (uint64_t)_b << 32 ) | _a;
+}
+
+static bool collapseFlipsTriangle( const std::vector<wv::Vertex>& _vertices, const uint32_t* _triangle, uint32_t _from, uint32_t _to )
+{
+	wv::cVector3f p[ 3 ];
+	wv::cVector3f q[ 3 ];
+
+	for ( int i = 0; i < 3; i++ )
+	{
+		p[ i ] = _vertices[ _triangle[ i ] ].position;
+		q[ i ] = _triangle[ i ] == _from ? _vertices[ _to ].position : p[ i ];
+	}
+
+	wv::cVector3f n0 = ( p[ 1 ] - p[ 0 ] ).cross( p[ 2 ] - p[ 0 ] );
+	wv::cVector3f n1 = ( q[ 1 ] - q[ 0 ] ).cross( q[ 2 ] - q[ 0 ] );
+
+	// reject flipped and heavily rotated triangles
+	float d = n0.dot( n1 );
+	return d <= 0.25f * n0.length() * n1.length();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+std::vector<uint32_t> wv::MeshOptimizer::simplify( const std::vector<uint32_t>& _indices, const std::vector<Vertex>& _vertices, size_t _targetIndexCount, float _targetError, float* _pResultError )
+{
+	std::vector<uint32_t> indices = _indices;
+	const size_t numVertices = _vertices.size();
+
+	if ( _pResultError )
+		*_pResultError = 0.0f;
+
+	if ( indices.size() <= _targetIndexCount || numVertices == 0 || indices.size() % 3 != 0 )
+		return indices;
+
+	cBoundingBoxf bounds;
+	for ( auto& vertex : _vertices )
+		bounds.expand( vertex.position );
+
+	cVector3f size = bounds.max - bounds.min;
+	float scale = std::max( size.x, std::max( size.y, size.z ) );
+	if ( scale <= 0.0f )
+		return indices;
+
+	const double maxError = (double)_targetError * scale;
+	const double maxCost  = maxError * maxError;
+
+	// weld vertices that only differ in attributes, collapses work on the welded positions
+	std::vector<uint32_t> positionIds( numVertices );
+	uint32_t numPositions = 0;
+	{
+		std::unordered_map<sPositionKey, uint32_t, sPositionKeyHash> lookup;
+		for ( size_t i = 0; i < numVertices; i++ )
+		{
+			const cVector3f& p = _vertices[ i ].position;
+			auto inserted = lookup.insert( { sPositionKey{ p.x, p.y, p.z }, numPositions } );
+			if ( inserted.second )
+				numPositions++;
+
+			positionIds[ i ] = inserted.first->second;
+		}
+	}
+
+	// every vertex of a position, the copies on either side of a seam move together
+	std::vector<uint32_t> copyOffsets( numPositions + 1, 0 );
+	std::vector<uint32_t> copies( numVertices );
+	{
+		for ( size_t i = 0; i < numVertices; i++ )
+			copyOffsets[ positionIds[ i ] + 1 ]++;
+
+		for ( uint32_t i = 0; i < numPositions; i++ )
+			copyOffsets[ i + 1 ] += copyOffsets[ i ];
+
+		std::vector<uint32_t> fill( copyOffsets.begin(), copyOffsets.end() - 1 );
+		for ( size_t i = 0; i < numVertices; i++ )
+			copies[ fill[ positionIds[ i ] ]++ ] = (uint32_t)i;
+	}
+
+	// only positions on an open edge of the surface are locked, attribute seams are not
+	std::vector<uint8_t> isLocked( numPositions, 0 );
+	{
+		std::unordered_map<uint64_t, uint32_t> edgeUsers;
+		for ( size_t i = 0; i < indices.size(); i += 3 )
+			for ( int e = 0; e < 3; e++ )
+				edgeUsers[ edgeKey( positionIds[ indices[ i + e ] ], positionIds[ indices[ i + ( e + 1 ) % 3 ] ] ) ]++;
+
+		for ( auto& edge : edgeUsers )
+		{
+			if ( edge.second != 1 )
+				continue;
+
+			isLocked[ edge.first >> 32 ] = 1;
+			isLocked[ edge.first & 0xFFFFFFFF ] = 1;
+		}
+	}
+
+	std::vector<sQuadric> quadrics( numPositions );
+	for ( size_t i = 0; i < indices.size(); i += 3 )
+	{
+		const cVector3f& p0 = _vertices[ indices[ i + 0 ] ].position;
+		const cVector3f& p1 = _vertices[ indices[ i + 1 ] ].position;
+		const cVector3f& p2 = _vertices[ indices[ i + 2 ] ].position;
+
+		cVector3f n = ( p1 - p0 ).cross( p2 - p0 );
+		float length = n.length();
+		if ( length <= 0.0f )
+			continue;
+
+		n /= length;
+		double d = -n.dot( p0 );
+		double area = length * 0.5;
+
+		for ( int v = 0; v < 3; v++ )
+			quadrics[ positionIds[ indices[ i + v ] ] ].addPlane( n.x, n.y, n.z, d, area );
+	}
+
+	std::vector<uint32_t> remap( numVertices );
+	for ( size_t i = 0; i < numVertices; i++ )
+		remap[ i ] = (uint32_t)i;
+
+	std::vector<uint32_t> triangleOffsets;
+	std::vector<uint32_t> triangleList;
+	std::vector<sCollapse> collapses;
+	std::vector<uint8_t> touched;
+	std::vector<uint32_t> targets;
+	
+	double resultCost = 0.0;
+
+	// the copy of _to that _vertex shares an edge with, ~0u if there is none
+	auto findTarget = [ & ]( uint32_t _vertex, uint32_t _to )
+		{
+			uint32_t target = ~0u;
+			for ( uint32_t t = triangleOffsets[ _vertex ]; t < triangleOffsets[ _vertex + 1 ]; t++ )
+				for ( int k = 0; k < 3; k++ )
+				{
+					uint32_t corner = indices[ triangleList[ t ] * 3 + k ];
+					if ( positionIds[ corner ] == _to && corner < target )
+						target = corner;
+				}
+			return target;
+		};
+
+	// a position can only move along an edge every one of its used copies has,
+	// so each copy lands on the copy of the same side and the seam stays split
+	auto findTargets = [ & ]( uint32_t _from, uint32_t _to, std::vector<uint32_t>* _pTargets )
+		{
+			if ( _pTargets )
+				_pTargets->clear();
+
+			for ( uint32_t c = copyOffsets[ _from ]; c < copyOffsets[ _from + 1 ]; c++ )
+			{
+				uint32_t vertex = copies[ c ];
+				if ( triangleOffsets[ vertex ] == triangleOffsets[ vertex + 1 ] )
+					continue;
+
+				uint32_t target = findTarget( vertex, _to );
+				if ( target == ~0u )
+					return false;
+
+				if ( _pTargets )
+				{
+					_pTargets->push_back( vertex );
+					_pTargets->push_back( target );
+				}
+			}
+			return true;
+		};
+
+	while ( indices.size() > _targetIndexCount )
+	{
+		// vertex to triangle adjacency
+		triangleOffsets.assign( numVertices + 1, 0 );
+		for ( auto& index : indices )
+			triangleOffsets[ index + 1 ]++;
+		
+		for ( size_t i = 0; i < numVertices; i++ )
+			triangleOffsets[ i + 1 ] += triangleOffsets[ i ];
+
+		triangleList.resize( indices.size() );
+		{
+			std::vector<uint32_t> fill( triangleOffsets.begin(), triangleOffsets.end() - 1 );
+			for ( size_t i = 0; i < indices.size(); i++ )
+				triangleList[ fill[ indices[ i ] ]++ ] = (uint32_t)( i / 3 );
+		}
+
+		// every edge is seen once from the triangle where it runs from the lower position
+		collapses.clear();
+		for ( size_t i = 0; i < indices.size(); i += 3 )
+		{
+			for ( int e = 0; e < 3; e++ )
+			{
+				uint32_t a = positionIds[ indices[ i + e ] ];
+				uint32_t b = positionIds[ indices[ i + ( e + 1 ) % 3 ] ];
+				if ( a >= b )
+					continue;
+				
+				sQuadric q = quadrics[ a ];
+				q.add( quadrics[ b ] );
+
+				bool canAB = !isLocked[ a ] && findTargets( a, b, nullptr );
+				bool canBA = !isLocked[ b ] && findTargets( b, a, nullptr );
+				
+				double costAB = canAB ? q.error( _vertices[ indices[ i + ( e + 1 ) % 3 ] ].position ) : 0.0;
+				double costBA = canBA ? q.error( _vertices[ indices[ i + e ] ].position ) : 0.0;
+
+				if ( canAB && ( !canBA || costAB <= costBA ) )
+					collapses.push_back( { a, b, costAB } );
+				else if ( canBA )
+					collapses.push_back( { b, a, costBA } );
+			}
+		}
+
+		if ( collapses.empty() )
+			break;
+
+		std::sort( collapses.begin(), collapses.end(), []( const sCollapse& _a, const sCollapse& _b ) { return _a.cost < _b.cost; } );
+
+		// each collapse removes roughly two triangles
+		size_t maxCollapses = ( indices.size() - _targetIndexCount ) / 6 + 1;
+		size_t numCollapsed = 0;
+
+		touched.assign( numPositions, 0 );
+
+		for ( auto& collapse : collapses )
+		{
+			if ( numCollapsed >= maxCollapses || collapse.cost > maxCost )
+				break;
+
+			if ( touched[ collapse.from ] || touched[ collapse.to ] )
+				continue;
+
+			findTargets( collapse.from, collapse.to, &targets );
+
+			bool flips = false;
+			for ( size_t m = 0; m < targets.size() && !flips; m += 2 )
+			{
+				uint32_t from = targets[ m ];
+				for ( uint32_t t = triangleOffsets[ from ]; t < triangleOffsets[ from + 1 ] && !flips; t++ )
+				{
+					const uint32_t* triangle = &indices[ triangleList[ t ] * 3 ];
+					if ( positionIds[ triangle[ 0 ] ] == collapse.to || positionIds[ triangle[ 1 ] ] == collapse.to || positionIds[ triangle[ 2 ] ] == collapse.to )
+						continue; // becomes degenerate
+
+					flips = collapseFlipsTriangle( _vertices, triangle, from, targets[ m + 1 ] );
+				}
+			}
+
+			if ( flips )
+				continue;
+
+			for ( size_t m = 0; m < targets.size(); m += 2 )
+				remap[ targets[ m ] ] = targets[ m + 1 ];
+
+			quadrics[ collapse.to ].add( quadrics[ collapse.from ] );
+			resultCost = std::max( resultCost, collapse.cost );
+
+			uint32_t ends[ 2 ] = { collapse.from, collapse.to };
+			for ( uint32_t position : ends )
+				for ( uint32_t c = copyOffsets[ position ]; c < copyOffsets[ position + 1 ]; c++ )
+					for ( uint32_t t = triangleOffsets[ copies[ c ] ]; t < triangleOffsets[ copies[ c ] + 1 ]; t++ )
+						for ( int k = 0; k < 3; k++ )
+							touched[ positionIds[ indices[ triangleList[ t ] * 3 + k ] ] ] = 1;
+
+			numCollapsed++;
+		}
+
+		if ( numCollapsed == 0 )
+			break;
+
+		// triangles that lost an edge may still have two copies of one position
+		size_t write = 0;
+		for ( size_t i = 0; i < indices.size(); i += 3 )
+		{
+			uint32_t a = remap[ indices[ i + 0 ] ];
+			uint32_t b = remap[ indices[ i + 1 ] ];
+			uint32_t c = remap[ indices[ i + 2 ] ];
+
+			if ( positionIds[ a ] == positionIds[ b ] || positionIds[ b ] == positionIds[ c ] || positionIds[ c ] == positionIds[ a ] )
+				continue;
+
+			indices[ write++ ] = a;
+			indices[ write++ ] = b;
+			indices[ write++ ] = c;
+		}
+		indices.resize( write );
+	}
+
+	if ( _pResultError )
+		*_pResultError = (float)( sqrt( resultCost ) / scale );
+
+	return indices;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+wv::MeshOptimizer::sVertexCacheStats wv::MeshOptimizer::analyzeVertexCache( const std::vector<uint32_t>& _indices, size_t _numVertices, uint32_t _cacheSize )
+{
+	sVertexCacheStats stats;
+	if ( _indices.size() < 3 || _numVertices == 0 )
+		return stats;
+
+	// a vertex is in the fifo if it was added less than _cacheSize insertions ago
+	std::vector<uint32_t> cacheTime( _numVertices, 0 );
+	std::vector<uint8_t>  referenced( _numVertices, 0 );
+	uint32_t time = _cacheSize + 1;
+	
+	size_t numMisses = 0;
+	size_t numUnique = 0;
+
+	for ( auto& index : _indices )
+	{
+		if ( time - cacheTime[ index ] > _cacheSize )
+		{
+			cacheTime[ index ] = time++;
+			numMisses++;
+		}
+
+		if ( !referenced[ index ] )
+		{
+			referenced[ index ] = 1;
+			numUnique++;
+		}
+	}
+
+	stats.acmr = (float)numMisses / (float)( _indices.size() / 3 );
+	stats.atvr = (float)numMisses / (float)numUnique;
+	return stats;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+std::vector<uint32_t> wv::MeshOptimizer::optimizeVertexCache( const std::vector<uint32_t>& _indices, size_t _numVertices, uint32_t _cacheSize, std::vector<uint32_t>* _pClusters )
+{
+	// Sander, Nehab, Barczak - Fast Triangle Reordering for Vertex Locality and Reduced Overdraw
+	const size_t numTriangles = _indices.size() / 3;
+	
+	std::vector<uint32_t> result;
+	result.reserve( numTriangles * 3 );
+
+	if ( _pClusters )
+		_pClusters->clear();
+
+	if ( numTriangles == 0 || _numVertices == 0 )
+		return result;
+
+	// vertex to triangle adjacency
+	std::vector<uint32_t> adjacencyOffsets( _numVertices + 1, 0 );
+	for ( size_t i = 0; i < numTriangles * 3; i++ )
+		adjacencyOffsets[ _indices[ i ] + 1 ]++;
+
+	for ( size_t i = 0; i < _numVertices; i++ )
+		adjacencyOffsets[ i + 1 ] += adjacencyOffsets[ i ];
+
+	std::vector<uint32_t> adjacency( numTriangles * 3 );
+	{
+		std::vector<uint32_t> fill( adjacencyOffsets.begin(), adjacencyOffsets.end() - 1 );
+		for ( size_t i = 0; i < numTriangles * 3; i++ )
+			adjacency[ fill[ _indices[ i ] ]++ ] = (uint32_t)( i / 3 );
+	}
+
+	std::vector<uint32_t> liveTriangles( _numVertices );
+	for ( size_t i = 0; i < _numVertices; i++ )
+		liveTriangles[ i ] = adjacencyOffsets[ i + 1 ] - adjacencyOffsets[ i ];
+
+	std::vector<uint32_t> cacheTime( _numVertices, 0 );
+	std::vector<uint8_t>  emitted( numTriangles, 0 );
+	std::vector<uint32_t> deadEnd;
+	std::vector<uint32_t> candidates;
+
+	uint32_t time   = _cacheSize + 1;
+	size_t   cursor = 0;
+	int64_t  fanningVertex = 0;
+
+	if ( _pClusters )
+		_pClusters->push_back( 0 );
+
+	while ( fanningVertex >= 0 )
+	{
+		candidates.clear();
+
+		for ( uint32_t a = adjacencyOffsets[ fanningVertex ]; a < adjacencyOffsets[ fanningVertex + 1 ]; a++ )
+		{
+			uint32_t triangle = adjacency[ a ];
+			if ( emitted[ triangle ] )
+				continue;
+
+			for ( int k = 0; k < 3; k++ )
+			{
+				uint32_t v = _indices[ triangle * 3 + k ];
+				result.push_back( v );
+				deadEnd.push_back( v );
+				candidates.push_back( v );
+				liveTriangles[ v ]--;
+
+				if ( time - cacheTime[ v ] > _cacheSize )
+					cacheTime[ v ] = time++;
+			}
+
+			emitted[ triangle ] = 1;
+		}
+
+		// pick the candidate that will still be in the cache after its remaining triangles are emitted
+		int64_t next = -1;
+		int64_t bestPriority = -1;
+		for ( auto& v : candidates )
+		{
+			if ( liveTriangles[ v ] == 0 )
+				continue;
+
+			int64_t priority = 0;
+			if ( time - cacheTime[ v ] + 2 * liveTriangles[ v ] <= _cacheSize )
+				priority = time - cacheTime[ v ];
+
+			if ( priority > bestPriority )
+			{
+				bestPriority = priority;
+				next = v;
+			}
+		}
+
+		if ( next == -1 )
+		{
+			// dead end, restart from a recently used vertex or the next unprocessed one
+			while ( !deadEnd.empty() && next == -1 )
+			{
+				uint32_t v = deadEnd.back();
+				deadEnd.pop_back();
+				if ( liveTriangles[ v ] > 0 )
+					next = v;
+			}
+
+			while ( next == -1 && cursor < _numVertices )
+			{
+				if ( liveTriangles[ cursor ] > 0 )
+					next = (int64_t)cursor;
+				cursor++;
+			}
+
+			if ( next != -1 && _pClusters && result.size() / 3 < numTriangles )
+				_pClusters->push_back( (uint32_t)( result.size() / 3 ) );
+		}
+
+		fanningVertex = next;
+	}
+
+	return result;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+std::vector<uint32_t> wv::MeshOptimizer::optimizeOverdraw( const std::vector<uint32_t>& _indices, const std::vector<Vertex>& _vertices, const std::vector<uint32_t>& _clusters )
+{
+	const size_t numTriangles = _indices.size() / 3;
+	if ( _clusters.size() < 2 || numTriangles == 0 )
+		return _indices;
+
+	struct sCluster
+	{
+		uint32_t firstTriangle;
+		uint32_t numTriangles;
+		float sortKey;
+	};
+
+	std::vector<sCluster> clusters;
+	std::vector<cVector3f> centroids;
+	std::vector<cVector3f> normals;
+	
+	cVector3f meshCentroid{ 0.0f, 0.0f, 0.0f };
+	float meshArea = 0.0f;
+
+	for ( size_t c = 0; c < _clusters.size(); c++ )
+	{
+		uint32_t first = _clusters[ c ];
+		uint32_t last  = c + 1 < _clusters.size() ? _clusters[ c + 1 ] : (uint32_t)numTriangles;
+
+		cVector3f centroid{ 0.0f, 0.0f, 0.0f };
+		cVector3f normal  { 0.0f, 0.0f, 0.0f };
+		float area = 0.0f;
+
+		for ( uint32_t t = first; t < last; t++ )
+		{
+			const cVector3f& p0 = _vertices[ _indices[ t * 3 + 0 ] ].position;
+			const cVector3f& p1 = _vertices[ _indices[ t * 3 + 1 ] ].position;
+			const cVector3f& p2 = _vertices[ _indices[ t * 3 + 2 ] ].position;
+
+			cVector3f n = ( p1 - p0 ).cross( p2 - p0 );
+			float a = n.length() * 0.5f;
+
+			centroid += ( p0 + p1 + p2 ) * ( a / 3.0f );
+			normal   += n;
+			area     += a;
+		}
+
+		meshCentroid += centroid;
+		meshArea     += area;
+
+		centroids.push_back( area > 0.0f ? centroid / area : centroid );
+		normals.push_back( normal );
+		clusters.push_back( { first, last - first, 0.0f } );
+	}
+
+	if ( meshArea > 0.0f )
+		meshCentroid /= meshArea;
+
+	// clusters facing away from the center are the likely occluders
+	for ( size_t c = 0; c < clusters.size(); c++ )
+	{
+		float length = normals[ c ].length();
+		clusters[ c ].sortKey = length > 0.0f ? ( centroids[ c ] - meshCentroid ).dot( normals[ c ] / length ) : 0.0f;
+	}
+
+	std::stable_sort( clusters.begin(), clusters.end(), []( const sCluster& _a, const sCluster& _b ) { return _a.sortKey > _b.sortKey; } );
+
+	std::vector<uint32_t> result;
+	result.reserve( _indices.size() );
+	for ( auto& cluster : clusters )
+		result.insert( result.end(), _indices.begin() + cluster.firstTriangle * 3, _indices.begin() + ( cluster.firstTriangle + cluster.numTriangles ) * 3 );
+
+	return result;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+std::vector<uint32_t> wv::MeshOptimizer::optimizeVertexFetch( std::vector<Vertex>& _vertices, std::vector<uint32_t>& _indices )
+{
+	std::vector<uint32_t> remap( _vertices.size(), ~0u );
+	std::vector<Vertex> vertices;
+	vertices.reserve( _vertices.size() );
+
+	for ( auto& index : _indices )
+	{
+		if ( remap[ index ] == ~0u )
+		{
+			remap[ index ] = (uint32_t)vertices.size();
+			vertices.push_back( _vertices[ index ] );
+		}
+
+		index = remap[ index ];
+	}
+
+	_vertices.swap( vertices );
+	return remap;
+}
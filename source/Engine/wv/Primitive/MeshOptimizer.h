@@ -0,0 +1,61 @@
+#pragma once
+
+#include <wv/Primitive/Primitive.h>
+
+#include <stdint.h>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+namespace wv
+{
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	namespace MeshOptimizer
+	{
+
+		struct sVertexCacheStats
+		{
+			float acmr = 0.0f; // average cache miss ratio, transformed vertices per triangle
+			float atvr = 0.0f; // average transform to vertex ratio, 1.0 being optimal
+		};
+
+		/// <summary>
+		/// Simulates a FIFO post-transform vertex cache
+		/// </summary>
+		sVertexCacheStats analyzeVertexCache( const std::vector<uint32_t>& _indices, size_t _numVertices, uint32_t _cacheSize = 16 );
+
+		/// <summary>
+		/// Tipsify triangle reordering for post-transform vertex cache locality.
+		/// If _pClusters is set it receives the first triangle of every cluster, 
+		/// where the traversal had to restart, for use with optimizeOverdraw
+		/// </summary>
+		std::vector<uint32_t> optimizeVertexCache( const std::vector<uint32_t>& _indices, size_t _numVertices, uint32_t _cacheSize = 16, std::vector<uint32_t>* _pClusters = nullptr );
+
+		/// <summary>
+		/// Sorts the clusters from optimizeVertexCache so outwards facing clusters are drawn first.
+		/// Triangle order within a cluster is kept, so vertex cache locality is mostly preserved
+		/// </summary>
+		std::vector<uint32_t> optimizeOverdraw( const std::vector<uint32_t>& _indices, const std::vector<Vertex>& _vertices, const std::vector<uint32_t>& _clusters );
+
+		/// <summary>
+		/// Reorders vertices in the order they are first referenced and rewrites the indices.
+		/// Unreferenced vertices are removed. Returns the old to new vertex remap, ~0u for removed vertices
+		/// </summary>
+		std::vector<uint32_t> optimizeVertexFetch( std::vector<Vertex>& _vertices, std::vector<uint32_t>& _indices );
+
+		/// <summary>
+		/// Quadric edge collapse simplification. Only the index buffer is rewritten, 
+		/// vertices are collapsed onto existing vertices so the vertex buffer can be shared between LODs.
+		/// Border vertices are never moved. Vertices sharing a position move together, along edges of the seam
+		/// between them, so split normals and uvs stay split.
+		/// </summary>
+		/// <param name="_targetIndexCount">number of indices to stop at</param>
+		/// <param name="_targetError">maximum error, relative to the mesh extents</param>
+		/// <param name="_pResultError">relative error of the returned index buffer</param>
+		std::vector<uint32_t> simplify( const std::vector<uint32_t>& _indices, const std::vector<Vertex>& _vertices, size_t _targetIndexCount, float _targetError, float* _pResultError = nullptr );
+
+	}
+
+}
@@ -48,7 +48,16 @@ namespace wv
 
 	enum PrimitiveBufferMode
 	{
-		WV_PRIMITIVE_TYPE_STATIC
+		WV_PRIMITIVE_TYPE_STATIC,
+		WV_PRIMITIVE_TYPE_DYNAMIC // vertices are streamed with iGraphicsDevice::updatePrimitive
+	};
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	enum PrimitiveTopology
+	{
+		WV_PRIMITIVE_TOPOLOGY_TRIANGLES,
+		WV_PRIMITIVE_TOPOLOGY_LINES
 	};
 
 ///////////////////////////////////////////////////////////////////////////////////////
@@ -59,11 +68,23 @@ namespace wv
 		WV_PRIMITIVE_DRAW_TYPE_INDICES
 	};
 
+///////////////////////////////////////////////////////////////////////////////////////
+
+	#define WV_MAX_PRIMITIVE_LODS 4
+
+	struct sPrimitiveLOD
+	{
+		uint32_t firstIndex = 0;
+		uint32_t numIndices = 0;
+		float    error      = 0.0f; // relative to the mesh extents
+	};
+
 ///////////////////////////////////////////////////////////////////////////////////////
 
 	struct PrimitiveDesc
 	{
-		PrimitiveBufferMode type   = WV_PRIMITIVE_TYPE_STATIC;
+		PrimitiveBufferMode type     = WV_PRIMITIVE_TYPE_STATIC;
+		PrimitiveTopology   topology = WV_PRIMITIVE_TOPOLOGY_TRIANGLES;
 		sVertexLayout       layout;
 
 		void*    vertices     = nullptr;
@@ -73,6 +94,10 @@ namespace wv
 		uint32_t* indices32  = nullptr;
 		uint32_t  numIndices = 0;
 
+		// index ranges into the index buffer, lod 0 being the full mesh
+		sPrimitiveLOD lods[ WV_MAX_PRIMITIVE_LODS ];
+		uint32_t      numLODs = 0;
+
 		cMaterial* pMaterial = nullptr;
 	};
 
@@ -88,10 +113,14 @@ namespace wv
 		cGPUBuffer* indexBuffer;
 
 		PrimitiveBufferMode mode = WV_PRIMITIVE_TYPE_STATIC;
+		PrimitiveTopology topology = WV_PRIMITIVE_TOPOLOGY_TRIANGLES;
 		PrimitiveDrawType drawType = WV_PRIMITIVE_DRAW_TYPE_VERTICES;
 		
 		cMaterial* material = nullptr;
 
+		sPrimitiveLOD lods[ WV_MAX_PRIMITIVE_LODS ];
+		uint32_t      numLODs = 0;
+
 		std::vector<Vertex> vertices;
 		std::vector<unsigned int> indices;
 
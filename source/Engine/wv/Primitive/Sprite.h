@@ -1,31 +1,26 @@
 #pragma once
 
 #include <wv/Math/Transform.h>
+#include <wv/Primitive/SpriteBatch.h>
 
 namespace wv
 {
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
-	class sMesh;
-	class cMaterial;
+	class Texture;
 	class iGraphicsDevice;
 
-///////////////////////////////////////////////////////////////////////////////////////
-
-	namespace Internal
-	{
-		static sMesh* S_SPRITE_QUAD = nullptr;
-	}
-
 ///////////////////////////////////////////////////////////////////////////////////////
 
 	struct SpriteDesc
 	{
-		sMesh* mesh = nullptr;
-		cMaterial* material = nullptr;
+		Texture* pTexture = nullptr;
+		sSpriteRegion region;
 		cVector3f position{};
 		cVector3f size{ 64.0f, 64.0f, 1.0f };
+		cColor color = Color::White;
+		int layer = 0;
 	};
 
 ///////////////////////////////////////////////////////////////////////////////////////
@@ -39,9 +34,21 @@ namespace wv
 
 		static Sprite* create( SpriteDesc* _desc );
 
+		/// <summary>
+		/// Position and scale are in pixels, rotation.z in degrees
+		/// </summary>
 		Transformf& getTransform() { return m_transform; }
+		
+		/// <summary>
+		/// Queues the sprite in the engine sprite batch
+		/// </summary>
 		void draw( iGraphicsDevice* _device );
-		cMaterial* getMaterial() { return m_material; }
+
+		void setRegion( const sSpriteRegion& _region ) { m_region = _region; }
+		void setColor ( const cColor& _color )         { m_color = _color; }
+		void setLayer ( int _layer )                   { m_layer = _layer; }
+
+		Texture* getTexture() { return m_pTexture; }
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
@@ -49,11 +56,12 @@ namespace wv
 
 		Sprite() { };
 
-		static void createQuad();
+		Texture* m_pTexture = nullptr;
+		sSpriteRegion m_region;
+		cColor m_color = Color::White;
+		int m_layer = 0;
 
-		cMaterial* m_material = nullptr;
 		Transformf m_transform;
-		sMesh* m_mesh = nullptr;
 
 	};
 
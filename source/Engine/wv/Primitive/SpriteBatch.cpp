@@ -0,0 +1,215 @@
+#include "SpriteBatch.h"
+
+#include <wv/Device/GraphicsDevice.h>
+#include <wv/Primitive/Primitive.h>
+#include <wv/Shader/ShaderProgram.h>
+#include <wv/Graphics/GPUBuffer.h>
+#include <wv/Texture/Texture.h>
+#include <wv/Math/Math.h>
+
+#include <algorithm>
+#include <math.h>
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+// capacity the vertex buffer starts out with, it grows as needed
+#define WV_SPRITE_BATCH_INITIAL_SPRITES 1024
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+int wv::cSpriteAtlas::addRegion( int _x, int _y, int _width, int _height )
+{
+	m_rects.push_back( { _x, _y, _width, _height } );
+	return (int)m_rects.size() - 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cSpriteAtlas::addGrid( int _cellWidth, int _cellHeight, int _numColumns, int _numRows )
+{
+	for ( int y = 0; y < _numRows; y++ )
+		for ( int x = 0; x < _numColumns; x++ )
+			addRegion( x * _cellWidth, y * _cellHeight, _cellWidth, _cellHeight );
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+wv::sSpriteRegion wv::cSpriteAtlas::getRegion( int _index )
+{
+	sSpriteRegion region;
+	if ( !m_pTexture || _index < 0 || _index >= (int)m_rects.size() )
+		return region;
+
+	float width  = (float)m_pTexture->getWidth();
+	float height = (float)m_pTexture->getHeight();
+	if ( width <= 0.0f || height <= 0.0f )
+		return region;
+
+	const sRect& rect = m_rects[ _index ];
+	region.uvMin = { (float)rect.x / width, (float)rect.y / height };
+	region.uvMax = { (float)( rect.x + rect.width ) / width, (float)( rect.y + rect.height ) / height };
+
+	return region;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cSpriteBatch::create( cFileSystem* _pFileSystem, iGraphicsDevice* _pGraphicsDevice )
+{
+	m_pPipeline = new cProgramPipeline( "sprite_batch" );
+	m_pPipeline->load( _pFileSystem, _pGraphicsDevice );
+
+	wv::sVertexAttribute elements[] = {
+		{ "a_Pos",       2, wv::WV_FLOAT,         false, sizeof( float ) * 2 },  // vec2f pos
+		{ "a_TexCoord0", 2, wv::WV_FLOAT,         false, sizeof( float ) * 2 },  // vec2f texcoord0
+		{ "a_Color",     4, wv::WV_UNSIGNED_BYTE, true,  sizeof( uint8_t ) * 4 } // rgba8 col
+	};
+
+	wv::sVertexLayout layout;
+	layout.elements = elements;
+	layout.numElements = 3;
+
+	PrimitiveDesc desc;
+	desc.type = WV_PRIMITIVE_TYPE_DYNAMIC;
+	desc.layout = layout;
+	desc.sizeVertices = WV_SPRITE_BATCH_INITIAL_SPRITES * 6 * sizeof( sVertex );
+
+	m_pPrimitive = _pGraphicsDevice->createPrimitive( &desc );
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cSpriteBatch::destroy( iGraphicsDevice* _pGraphicsDevice )
+{
+	if ( m_pPrimitive )
+	{
+		_pGraphicsDevice->destroyPrimitive( m_pPrimitive );
+		m_pPrimitive = nullptr;
+	}
+
+	if ( m_pPipeline )
+	{
+		m_pPipeline->unload( nullptr, _pGraphicsDevice );
+		delete m_pPipeline;
+		m_pPipeline = nullptr;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cSpriteBatch::addSprite( const sSpriteInstance& _sprite )
+{
+	std::scoped_lock lock{ m_mutex };
+	m_sprites.push_back( _sprite );
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cSpriteBatch::addSprite( cSpriteAtlas* _pAtlas, int _region, const Vector2f& _position, const Vector2f& _size, int _layer, const cColor& _color )
+{
+	sSpriteInstance sprite;
+	sprite.pTexture = _pAtlas->getTexture();
+	sprite.region = _pAtlas->getRegion( _region );
+	sprite.position = _position;
+	sprite.size = _size;
+	sprite.layer = _layer;
+	sprite.color = _color;
+
+	addSprite( sprite );
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cSpriteBatch::draw( iGraphicsDevice* _pGraphicsDevice, int _viewportWidth, int _viewportHeight )
+{
+	{
+		std::scoped_lock lock{ m_mutex };
+		m_drawSprites.swap( m_sprites );
+		m_sprites.clear();
+	}
+
+	m_numSprites = (int)m_drawSprites.size();
+	m_numDrawCalls = 0;
+
+	if ( m_drawSprites.empty() || !m_pPrimitive || !m_pPipeline || !m_pPipeline->m_pPipeline )
+		return;
+
+	m_keys.resize( m_drawSprites.size() );
+	for ( uint32_t i = 0; i < (uint32_t)m_drawSprites.size(); i++ )
+		m_keys[ i ] = { m_drawSprites[ i ].layer, m_drawSprites[ i ].pTexture, i };
+
+	std::sort( m_keys.begin(), m_keys.end(), 
+		[]( const sSortKey& _a, const sSortKey& _b )
+		{
+			if ( _a.layer != _b.layer )       return _a.layer < _b.layer;
+			if ( _a.pTexture != _b.pTexture ) return _a.pTexture < _b.pTexture;
+			return _a.index < _b.index;
+		} );
+
+	// write every sprite up front, batches are ranges of this
+	m_vertices.resize( m_keys.size() * 6 );
+	for ( size_t i = 0; i < m_keys.size(); i++ )
+	{
+		const sSpriteInstance& sprite = m_drawSprites[ m_keys[ i ].index ];
+
+		float c = 1.0f;
+		float s = 0.0f;
+		if ( sprite.rotation != 0.0f )
+		{
+			c = cosf( Math::radians( sprite.rotation ) );
+			s = sinf( Math::radians( sprite.rotation ) );
+		}
+
+		const float corners[ 4 ][ 2 ] = { { 0.0f, 0.0f }, { 0.0f, 1.0f }, { 1.0f, 1.0f }, { 1.0f, 0.0f } };
+		sVertex quad[ 4 ];
+		for ( int v = 0; v < 4; v++ )
+		{
+			float x = ( corners[ v ][ 0 ] - sprite.pivot.x ) * sprite.size.x;
+			float y = ( corners[ v ][ 1 ] - sprite.pivot.y ) * sprite.size.y;
+
+			quad[ v ].position[ 0 ] = sprite.position.x + x * c - y * s;
+			quad[ v ].position[ 1 ] = sprite.position.y + x * s + y * c;
+			quad[ v ].texCoord[ 0 ] = corners[ v ][ 0 ] == 0.0f ? sprite.region.uvMin.x : sprite.region.uvMax.x;
+			quad[ v ].texCoord[ 1 ] = corners[ v ][ 1 ] == 0.0f ? sprite.region.uvMin.y : sprite.region.uvMax.y;
+			quad[ v ].color[ 0 ] = sprite.color.r;
+			quad[ v ].color[ 1 ] = sprite.color.g;
+			quad[ v ].color[ 2 ] = sprite.color.b;
+			quad[ v ].color[ 3 ] = sprite.color.a;
+		}
+
+		sVertex* out = &m_vertices[ i * 6 ];
+		out[ 0 ] = quad[ 0 ]; out[ 1 ] = quad[ 1 ]; out[ 2 ] = quad[ 2 ];
+		out[ 3 ] = quad[ 0 ]; out[ 4 ] = quad[ 2 ]; out[ 5 ] = quad[ 3 ];
+	}
+
+	float viewport[ 4 ] = { (float)_viewportWidth, (float)_viewportHeight, 0.0f, 0.0f };
+	cGPUBuffer* uniformBlock = m_pPipeline->getShaderBuffer( "UbSpriteData" );
+	if ( uniformBlock )
+		uniformBlock->buffer( &viewport );
+
+	_pGraphicsDevice->setDepthTest( false );
+	_pGraphicsDevice->setAlphaBlending( true );
+	m_pPipeline->use( _pGraphicsDevice );
+
+	// every batch is streamed at once, then drawn from its own range of the buffer
+	_pGraphicsDevice->updatePrimitive( m_pPrimitive, m_vertices.data(), (uint32_t)( m_vertices.size() * sizeof( sVertex ) ) );
+
+	size_t first = 0;
+	while ( first < m_keys.size() )
+	{
+		size_t last = first + 1;
+		while ( last < m_keys.size() && m_keys[ last ].layer == m_keys[ first ].layer && m_keys[ last ].pTexture == m_keys[ first ].pTexture )
+			last++;
+
+		if ( m_keys[ first ].pTexture )
+			_pGraphicsDevice->bindTextureToSlot( m_keys[ first ].pTexture, 0 );
+
+		_pGraphicsDevice->drawPrimitiveRange( m_pPrimitive, (uint32_t)( first * 6 ), (uint32_t)( ( last - first ) * 6 ) );
+		m_numDrawCalls++;
+
+		first = last;
+	}
+
+	_pGraphicsDevice->setAlphaBlending( false );
+	_pGraphicsDevice->setDepthTest( true );
+}
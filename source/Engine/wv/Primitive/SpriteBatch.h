@@ -0,0 +1,133 @@
+#pragma once
+
+#include <wv/Math/Vector2.h>
+#include <wv/Math/Vector3.h>
+#include <wv/Misc/Color.h>
+
+#include <stdint.h>
+#include <mutex>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+namespace wv
+{
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	class Texture;
+	class Primitive;
+	class iGraphicsDevice;
+	class cProgramPipeline;
+	class cFileSystem;
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	struct sSpriteRegion
+	{
+		Vector2f uvMin{ 0.0f, 0.0f };
+		Vector2f uvMax{ 1.0f, 1.0f };
+	};
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	/// <summary>
+	/// Pixel rectangles into a texture. UVs are resolved on lookup since 
+	/// the texture size isn't known until it has loaded
+	/// </summary>
+	class cSpriteAtlas
+	{
+	public:
+		cSpriteAtlas( Texture* _pTexture ) : m_pTexture{ _pTexture } { }
+
+		int  addRegion( int _x, int _y, int _width, int _height );
+		void addGrid( int _cellWidth, int _cellHeight, int _numColumns, int _numRows );
+
+		sSpriteRegion getRegion( int _index );
+		int getNumRegions() { return (int)m_rects.size(); }
+
+		Texture* getTexture() { return m_pTexture; }
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	private:
+
+		struct sRect { int x, y, width, height; };
+
+		Texture* m_pTexture = nullptr;
+		std::vector<sRect> m_rects;
+	};
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	struct sSpriteInstance
+	{
+		Texture* pTexture = nullptr;
+		sSpriteRegion region;
+
+		// pixels, top left of the viewport being the origin
+		Vector2f position{ 0.0f, 0.0f };
+		Vector2f size{ 64.0f, 64.0f };
+		Vector2f pivot{ 0.0f, 0.0f }; // normalized, rotation and placement origin
+		float rotation = 0.0f;        // degrees
+
+		cColor color = Color::White;
+		int layer = 0;
+	};
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	/// <summary>
+	/// Collects sprites for a frame and draws them sorted by layer and texture,
+	/// one draw call for every run of sprites sharing both
+	/// </summary>
+	class cSpriteBatch
+	{
+	public:
+		
+		void create( cFileSystem* _pFileSystem, iGraphicsDevice* _pGraphicsDevice );
+		void destroy( iGraphicsDevice* _pGraphicsDevice );
+
+		/// <summary>
+		/// Thread safe
+		/// </summary>
+		void addSprite( const sSpriteInstance& _sprite );
+		void addSprite( cSpriteAtlas* _pAtlas, int _region, const Vector2f& _position, const Vector2f& _size, int _layer = 0, const cColor& _color = Color::White );
+
+		void draw( iGraphicsDevice* _pGraphicsDevice, int _viewportWidth, int _viewportHeight );
+
+		int getNumDrawCalls() { return m_numDrawCalls; }
+		int getNumSprites()   { return m_numSprites; }
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	private:
+
+		struct sVertex
+		{
+			float position[ 2 ];
+			float texCoord[ 2 ];
+			uint8_t color[ 4 ];
+		};
+
+		struct sSortKey
+		{
+			int layer;
+			Texture* pTexture;
+			uint32_t index; // keeps submission order within a batch
+		};
+
+		Primitive* m_pPrimitive = nullptr;
+		cProgramPipeline* m_pPipeline = nullptr;
+
+		std::mutex m_mutex;
+		std::vector<sSpriteInstance> m_sprites;
+		std::vector<sSpriteInstance> m_drawSprites;
+		std::vector<sSortKey> m_keys;
+		std::vector<sVertex> m_vertices;
+
+		int m_numDrawCalls = 0;
+		int m_numSprites = 0;
+	};
+
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <wv/Memory/Function.h>
+#include <wv/Memory/PoolAllocator.h>
 #include <wv/Reflection/ReflectionRegistry.h>
 #include <wv/Debug/Print.h>
 
@@ -66,7 +67,7 @@ namespace wv
 			static cReflectedClass<T> classReflection{ _name };
 			classReflection.m_createInstance.bind( cReflectionRegistry::get_createInstance<T>() );
 			classReflection.m_parseInstance.bind( cReflectionRegistry::get_parseInstance<T>() );
-			cReflectionRegistry::reflectClass( _name, static_cast< iClassOperator* >( &classReflection ) );
+			cReflectionRegistry::reflectClass( _name, static_cast< iClassOperator* >( &classReflection ), Pool::find<T>() );
 			
 		#ifdef WV_DEBUG
 			if( classReflection.m_createInstance.m_fptr ) printf( "    ::createInstance\n" );
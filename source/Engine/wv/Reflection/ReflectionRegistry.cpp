@@ -5,7 +5,7 @@
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
-int wv::cReflectionRegistry::reflectClass( const std::string& _name, iClassOperator* _operator )
+int wv::cReflectionRegistry::reflectClass( const std::string& _name, iClassOperator* _operator, cPoolAllocator* _pPool )
 {
 	wv::Debug::Print( wv::Debug::WV_PRINT_DEBUG, "Reflecting '%s'\n", _name.c_str() );
 
@@ -14,6 +14,7 @@ int wv::cReflectionRegistry::reflectClass( const std::string& _name, iClassOpera
 	sClassReflection c;
 	c.name = _name;
 	c.pOperator = _operator;
+	c.pPool = _pPool;
 	classes[ _name ] = c;
 	
 	return classes.size();
@@ -53,6 +54,24 @@ void* wv::cReflectionRegistry::parseInstance( const std::string& _name, sParseDa
 	return op.pOperator->parseInstance( _data );
 }
 
+///////////////////////////////////////////////////////////////////////////////////////
+
+wv::cPoolAllocator* wv::cReflectionRegistry::getPool( const std::string& _name )
+{
+	tReflectedClassesMap& classes = wv::cReflectionRegistry::getClasses();
+
+	auto search = classes.find( _name );
+	if( search == classes.end() )
+	{
+		Debug::Print( Debug::WV_PRINT_ERROR, "Class '%s' does not exist or hasn't been reflected\n", _name.c_str() );
+		return nullptr;
+	}
+
+	return search->second.pPool;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
 wv::tReflectedClassesMap& wv::cReflectionRegistry::getClasses()
 {
 	static tReflectedClassesMap classes{};
@@ -18,6 +18,7 @@ namespace wv
 ///////////////////////////////////////////////////////////////////////////////////////
 
 	class iClassOperator;
+	class cPoolAllocator;
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
@@ -25,6 +26,7 @@ namespace wv
 	{
 		std::string name = "";
 		iClassOperator* pOperator = nullptr;
+		cPoolAllocator* pPool     = nullptr;
 	};
 
 ///////////////////////////////////////////////////////////////////////////////////////
@@ -78,11 +80,17 @@ namespace wv
 		}
 
 	public:
-		static int reflectClass( const std::string& _name, iClassOperator* _operator );
+		static int reflectClass( const std::string& _name, iClassOperator* _operator, cPoolAllocator* _pPool = nullptr );
 
 		static void* createInstance( const std::string& _name );
 		static void* parseInstance ( const std::string& _name, sParseData& _data );
 
+		/// <summary>
+		/// Pool that instances of a reflected class are allocated from, 
+		/// nullptr if the class is not pooled
+		/// </summary>
+		static cPoolAllocator* getPool( const std::string& _name );
+
 		template<typename C> 
 		static typename wv::Function<C*>::fptr_t get_createInstance( void ) { 
 			return get_createInstance_impl<C>( 0 ); 
@@ -4,10 +4,29 @@
 #include <wv/Debug/Print.h>
 #include <wv/Resource/Resource.h>
 #include <wv/Primitive/Mesh.h>
+#include <wv/Physics/PhysicsShapeResource.h>
+#include <wv/Graphics/OcclusionCuller.h>
 #include <vector>
 
+template<>
+void wv::cResourceRegistry::handleResourceType<wv::cMeshResource>( cMeshResource* _res )
+{
+	_res->setResourceRegistry( this );
+	m_meshes.push_back( _res );
+}
+
+template<>
+void wv::cResourceRegistry::handleResourceType<wv::cPhysicsShapeResource>( cPhysicsShapeResource* _res )
+{
+	// the shape may have to be cooked, which parses its source mesh through this registry
+	_res->setResourceRegistry( this );
+}
+
 wv::cResourceRegistry::~cResourceRegistry()
 {
+	// nothing may still be loading into the resources unloaded below
+	m_resourceLoader.shutdown();
+
 	wv::Debug::Print( wv::Debug::WV_PRINT_ERROR, "Resource Registry has %i unloaded resources\n", (int)m_resources.size() );
 
 	std::vector<std::string> markedForDelete;
@@ -36,22 +55,72 @@ void wv::cResourceRegistry::initializeEmbeded()
 	load<cMaterial>( "DebugTextureMaterial.wmat" );
 }
 
-void wv::cResourceRegistry::drawMeshInstances()
+void wv::cResourceRegistry::drawMeshInstances( cOcclusionCuller* _pCuller )
 {
+	if ( _pCuller )
+	{
+		for ( auto& meshRes : m_meshes )
+			meshRes->addOccluders( _pCuller );
+		
+		_pCuller->rasterizeOccluders();
+	}
+
 	for ( auto& meshRes : m_meshes )
-		meshRes->drawInstances( m_pGraphicsDevice );
+		meshRes->drawInstances( m_pGraphicsDevice, _pCuller );
+}
+
+void wv::cResourceRegistry::beginBatch()
+{
+	if ( isBatchOwner() )
+	{
+		m_batchDepth++;
+		return;
+	}
+
+	m_mutex.lock();
+	m_batchDepth = 1;
+	m_batchThread.store( std::this_thread::get_id() );
+}
+
+void wv::cResourceRegistry::endBatch()
+{
+	if ( !isBatchOwner() )
+		return;
+
+	if ( --m_batchDepth > 0 )
+		return;
+
+	m_batchThread.store( std::thread::id{} );
+	m_mutex.unlock();
+}
+
+void wv::cResourceRegistry::lock()
+{
+	// already held by the batch on this thread
+	if ( isBatchOwner() )
+		return;
+
+	m_mutex.lock();
+}
+
+void wv::cResourceRegistry::unlock()
+{
+	if ( isBatchOwner() )
+		return;
+
+	m_mutex.unlock();
 }
 
 wv::iResource* wv::cResourceRegistry::getLoadedResource( const std::string& _name )
 {
 	wv::iResource* res = nullptr;
-	m_mutex.lock();
+	lock();
 
 	auto search = m_resources.find( _name );
 	if ( search != m_resources.end() )
-		res = m_resources[ _name ];
+		res = search->second;
 	
-	m_mutex.unlock();
+	unlock();
 	
 	return res;
 }
@@ -64,9 +133,9 @@ void wv::cResourceRegistry::addResource( iResource* _resource )
 		wv::Debug::Print( wv::Debug::WV_PRINT_ERROR, "Resource of name '%s' already exists\n", name.c_str() );
 		return;
 	}
-	m_mutex.lock();
+	lock();
 	m_resources[ name ] = _resource;
-	m_mutex.unlock();
+	unlock();
 }
 
 void wv::cResourceRegistry::findAndUnloadResource( iResource* _resource )
@@ -83,12 +152,12 @@ void wv::cResourceRegistry::findAndUnloadResource( iResource* _resource )
 
 void wv::cResourceRegistry::unloadResource( const std::string& _name )
 {
-	m_mutex.lock();
+	lock();
 	auto search = m_resources.find( _name );
 	if ( search == m_resources.end() )
 	{
 		wv::Debug::Print( wv::Debug::WV_PRINT_ERROR, "Cannot unload shader '%s'. It does not exist\n", _name.c_str() );
-		m_mutex.unlock();
+		unlock();
 		return;
 	}
 
@@ -99,5 +168,5 @@ void wv::cResourceRegistry::unloadResource( const std::string& _name )
 		delete m_resources[ _name ];
 		m_resources.erase( _name );
 	}
-	m_mutex.unlock();
+	unlock();
 }
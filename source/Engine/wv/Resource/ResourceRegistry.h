@@ -9,20 +9,25 @@
 #include <string>
 #include <unordered_map>
 #include <mutex>
+#include <thread>
+#include <atomic>
 
 namespace wv
 {
 	class iResource;
 	class iGraphicsDevice;
 	class cMeshResource;
+	class cPhysicsShapeResource;
+	class cOcclusionCuller;
+	class cTaskScheduler;
 
 	class cResourceRegistry
 	{
 	public:
-		cResourceRegistry( cFileSystem* _pFileSystem, iGraphicsDevice* _pGraphicsDevice ):
+		cResourceRegistry( cFileSystem* _pFileSystem, iGraphicsDevice* _pGraphicsDevice, cTaskScheduler* _pTaskScheduler ):
 			m_pFileSystem{ _pFileSystem },
 			m_pGraphicsDevice{ _pGraphicsDevice },
-			m_resourceLoader{_pFileSystem, _pGraphicsDevice }
+			m_resourceLoader{_pFileSystem, _pGraphicsDevice, _pTaskScheduler }
 		{
 			
 		}
@@ -63,18 +68,35 @@ namespace wv
 		}
 		
 		// should this be moved?
-		void drawMeshInstances();
+		void drawMeshInstances( cOcclusionCuller* _pCuller = nullptr );
 
 		iResource* getLoadedResource( const std::string& _name );
 
 		bool isWorking() { return m_resourceLoader.isWorking(); }
 
+		/// <summary>
+		/// nullptr for a headless registry, which only loads resources that need no GPU
+		/// </summary>
+		iGraphicsDevice* getGraphicsDevice() { return m_pGraphicsDevice; }
+		cFileSystem* getFileSystem() { return m_pFileSystem; }
+
+		/// <summary>
+		/// Holds the registry lock until endBatch so a batch of loads on this thread 
+		/// only locks once. Other threads block on lookups until the batch ends
+		/// </summary>
+		void beginBatch();
+		void endBatch();
+
 	protected:
 
 		template<typename T> 
 		void handleResourceType( T* _res );
 
 		void addResource( iResource* _resource );
+
+		void lock();
+		void unlock();
+		bool isBatchOwner() { return m_batchThread.load() == std::this_thread::get_id(); }
 		 
 		void findAndUnloadResource( iResource* _resource );
 		void unloadResource( const std::string& _name );
@@ -86,6 +108,10 @@ namespace wv
 
 		std::unordered_map<std::string, iResource*> m_resources;
 		std::mutex m_mutex;
+		
+		// only the owning thread ever sees its own id here, the depth is only touched by it
+		std::atomic<std::thread::id> m_batchThread{};
+		uint32_t m_batchDepth = 0;
 
 		std::vector<cMeshResource*> m_meshes;
 	};
@@ -97,9 +123,9 @@ namespace wv
 	}
 
 	template<>
-	inline void cResourceRegistry::handleResourceType<wv::cMeshResource>( cMeshResource* _res )
-	{
-		m_meshes.push_back( _res );
-	}
+	void cResourceRegistry::handleResourceType<wv::cMeshResource>( cMeshResource* _res );
+
+	template<>
+	void cResourceRegistry::handleResourceType<wv::cPhysicsShapeResource>( cPhysicsShapeResource* _res );
 
 }
\ No newline at end of file
@@ -3,65 +3,25 @@
 #include <wv/Resource/Resource.h>
 #include <wv/Memory/FileSystem.h>
 #include <wv/Device/GraphicsDevice.h>
+#include <wv/Thread/TaskScheduler.h>
 
-#include <chrono>
+#include <thread>
 
-void threadedLoad( wv::cFileSystem* _pFileSystem, wv::iGraphicsDevice* _pGraphicsDevice, wv::sLoaderInformation* _loaderInfo, wv::sLoadWorker* _worker )
+void wv::cResourceLoader::loadTask( void* _pUserData )
 {
-	wv::iResource* currentlyLoading = nullptr;
+	cResourceLoader* loader = (cResourceLoader*)_pUserData;
 
-	while( _worker->alive )
-	{
-		_loaderInfo->loadQueueMutex.lock();
-		if ( !_loaderInfo->loadQueue.empty() )
-		{
-			currentlyLoading = _loaderInfo->loadQueue.front();
-			_loaderInfo->loadQueue.pop();
-			_worker->state = wv::WV_WORKER_WORKING;
-		}
-		else
-		{
-			_worker->state = wv::WV_WORKER_IDLE;
-		}
-		_loaderInfo->loadQueueMutex.unlock();
-
-		switch ( _worker->state )
-		{
-
-		case wv::WV_WORKER_IDLE:
-			
-			/// TODO: wv::time
-		#ifdef WV_PLATFORM_WINDOWS
-			std::this_thread::sleep_for( std::chrono::milliseconds( 100 ) ); break;
-		#elif WV_PLATFORM_PSVITA
-			xtime t;
-			t.sec = 0.1;
-			_Thrd_sleep( &t );
-		#endif
-		
-		case wv::WV_WORKER_WORKING:
-		{
-			currentlyLoading->load( _pFileSystem, _pGraphicsDevice );
-			_loaderInfo->createQueueMutex.lock();
-			
-			_loaderInfo->createQueue.push( currentlyLoading );
+	// one task is submitted per queued resource, so there is always one here
+	loader->m_info.loadQueueMutex.lock();
+	iResource* resource = loader->m_info.loadQueue.front();
+	loader->m_info.loadQueue.pop();
+	loader->m_info.loadQueueMutex.unlock();
 
-			currentlyLoading = nullptr;
-			_loaderInfo->createQueueMutex.unlock();
-		} break;
-
-		}
-	}
-}
+	if ( !loader->m_shutdown.load() )
+		resource->load( loader->m_pFileSystem, loader->m_pGraphicsDevice );
 
-void wv::cResourceLoader::createWorkers( int _count )
-{
-	for ( int i = 0; i < _count; i++ )
-	{
-		sLoadWorker* worker = new sLoadWorker();
-		worker->thread = std::thread( threadedLoad, m_pFileSystem, m_pGraphicsDevice, &m_info, worker );
-		m_workers.push_back( worker );
-	}
+	// last access, the loader may be destroyed as soon as this reaches zero
+	loader->m_numLoading--;
 }
 
 void wv::cResourceLoader::addLoad( iResource* _resource )
@@ -72,25 +32,31 @@ void wv::cResourceLoader::addLoad( iResource* _resource )
 		return;
 	}
 
+	// counted before the check, so shutdown either sees this load or this sees shutdown
+	m_numLoading++;
+
+	if ( m_shutdown.load() )
+	{
+		m_numLoading--;
+		wv::Debug::Print( Debug::WV_PRINT_WARN, "Resource loader is shut down, %s is not loaded\n", _resource->getName().c_str() );
+		return;
+	}
+
 	m_info.loadQueueMutex.lock();
 	m_info.loadQueue.push( _resource );
 	m_info.loadQueueMutex.unlock();
+
+	m_pTaskScheduler->submit( loadTask, this, WV_TASK_PRIORITY_LOW );
 }
 
-bool wv::cResourceLoader::isWorking()
+void wv::cResourceLoader::shutdown()
 {
-	m_info.loadQueueMutex.lock();
-	m_info.createQueueMutex.lock();
-	
-	bool loading = !m_info.loadQueue.empty();
-	bool creating = !m_info.createQueue.empty();
-
-	bool workingThread = false;
-	for ( auto& worker : m_workers )
-		workingThread = worker->state == WV_WORKER_WORKING;
-	
-	m_info.loadQueueMutex.unlock();
-	m_info.createQueueMutex.unlock();
+	m_shutdown = true;
 
-	return loading || creating || workingThread;
+	// queued tasks still point at this loader, they run here if no worker has taken them
+	while ( m_numLoading.load() > 0 )
+	{
+		if ( !m_pTaskScheduler->runPendingTask() )
+			std::this_thread::yield();
+	}
 }
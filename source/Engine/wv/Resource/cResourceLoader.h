@@ -1,61 +1,64 @@
 #pragma once
 
 #include <vector>
-#include <thread>
 #include <mutex>
 #include <queue>
+#include <atomic>
 
 namespace wv
 {
 	class iResource;
 	class cFileSystem;
 	class iGraphicsDevice;
-
-	enum eLoadWorkerState
-	{
-		WV_WORKER_IDLE,
-		WV_WORKER_WORKING
-	};
-
-	struct sLoadWorker
-	{
-		std::thread thread;
-		eLoadWorkerState state = WV_WORKER_IDLE;
-		bool alive = true;
-	};
+	class cTaskScheduler;
 
 	struct sLoaderInformation
 	{
 		std::queue<iResource*> loadQueue;
-		std::queue<iResource*> createQueue;
 		std::mutex loadQueueMutex;
-		std::mutex createQueueMutex;
 	};
 
 	class cResourceLoader
 	{
 	public:
 
-		cResourceLoader( cFileSystem* _pFileSystem, iGraphicsDevice* _pGraphicsDevice ) : 
+		cResourceLoader( cFileSystem* _pFileSystem, iGraphicsDevice* _pGraphicsDevice, cTaskScheduler* _pTaskScheduler ) : 
 			m_pFileSystem{ _pFileSystem },
-			m_pGraphicsDevice{ _pGraphicsDevice }
+			m_pGraphicsDevice{ _pGraphicsDevice },
+			m_pTaskScheduler{ _pTaskScheduler }
 		{ 
-		#ifndef WV_PLATFORM_PSVITA
-			createWorkers( 5 );
-		#endif
+		
 		}
 
-		void createWorkers( int _count );
+		~cResourceLoader() { shutdown(); }
 
+		/// <summary>
+		/// Queues the resource and submits a low priority task that loads it
+		/// </summary>
 		void addLoad( iResource* _resource );
 		
-		bool isWorking();
+		/// <summary>
+		/// True while any load is queued or running
+		/// </summary>
+		bool isWorking() { return m_numLoading.load() > 0; }
+
+		/// <summary>
+		/// Cancels every load that has not started yet and waits for the running ones.
+		/// Cancelled resources are left incomplete. Nothing can be loaded afterwards
+		/// </summary>
+		void shutdown();
 
 	private:
+		static void loadTask( void* _pUserData );
+
 		cFileSystem* m_pFileSystem;
 		iGraphicsDevice* m_pGraphicsDevice;
+		cTaskScheduler* m_pTaskScheduler;
 
 		sLoaderInformation m_info;
-		std::vector<sLoadWorker*> m_workers;
+
+		// queued and currently loading
+		std::atomic<int>  m_numLoading{ 0 };
+		std::atomic<bool> m_shutdown  { false };
 	};
 }
\ No newline at end of file
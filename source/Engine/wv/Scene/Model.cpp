@@ -1,6 +1,5 @@
 #include "Model.h"
 
-#include <wv/Engine/Engine.h>
 #include <wv/Device/DeviceContext.h>
 #include <wv/Device/GraphicsDevice.h>
 
@@ -10,6 +9,9 @@
 
 #include <wv/Resource/ResourceRegistry.h>
 
+#include <wv/Entity/EntityWorld.h>
+#include <wv/Entity/Components.h>
+
 #include <fstream>
 
 ///////////////////////////////////////////////////////////////////////////////////////
@@ -49,6 +51,7 @@ wv::cModelObject* wv::cModelObject::parseInstance( sParseData& _data )
 	
 	cModelObject* model = new wv::cModelObject( uuid, name, meshPath );
 	model->m_transform = transform;
+	model->m_occluder = data[ "occluder" ].bool_value();
 	return model;
 }
 
@@ -56,21 +59,43 @@ wv::cModelObject* wv::cModelObject::parseInstance( sParseData& _data )
 
 void wv::cModelObject::onLoadImpl()
 {
-	wv::cEngine* app = wv::cEngine::get();
+	cResourceRegistry* registry = getResourceRegistry();
 
-	if ( m_meshPath == "" )
+	cEntityWorld* world = getWorld();
+	if ( !world || !registry )
 	{
-		Debug::Print( Debug::WV_PRINT_WARN, "No mesh path provided, defaulting to cube\n" );
-		m_meshPath = "res/meshes/cube.dae";
+		Debug::Print( Debug::WV_PRINT_ERROR, "Model '%s' is not part of a scene\n", m_name.c_str() );
+		return;
 	}
 
-	m_mesh = app->m_pResourceRegistry->load<cMeshResource>( m_meshPath )->createInstance();
-	m_transform.addChild( &m_mesh.transform );
+	m_entity = world->createEntity<sTransformComponent, sMeshComponent>();
+	world->getComponent<sTransformComponent>( m_entity )->pSource = &m_transform;
+
+	sMeshComponent* mesh = world->getComponent<sMeshComponent>( m_entity );
+	if ( registry->getGraphicsDevice() )
+	{
+		if ( m_meshPath == "" )
+		{
+			Debug::Print( Debug::WV_PRINT_WARN, "No mesh path provided, defaulting to cube\n" );
+			m_meshPath = "res/meshes/cube.dae";
+		}
+
+		mesh->pResource = registry->load<cMeshResource>( m_meshPath );
+	}
+	mesh->occluder  = m_occluder;
 }
 
 void wv::cModelObject::onUnloadImpl()
 {
-	m_mesh.destroy();
+	cEntityWorld* world = getWorld();
+	if ( !world || !world->isAlive( m_entity ) )
+		return;
+
+	sMeshComponent* mesh = world->getComponent<sMeshComponent>( m_entity );
+	if ( mesh->pResource )
+		getResourceRegistry()->unload( (iResource*)mesh->pResource );
+
+	world->destroyEntity( m_entity );
 }
 
 void wv::cModelObject::updateImpl( double _deltaTime )
@@ -82,5 +107,5 @@ void wv::cModelObject::updateImpl( double _deltaTime )
 
 void wv::cModelObject::drawImpl( iDeviceContext* _context, iGraphicsDevice* _device )
 {
-	m_mesh.draw();
+	// drawn by Systems::drawMeshes
 }
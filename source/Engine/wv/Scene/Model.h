@@ -3,7 +3,9 @@
 #include "SceneObject.h"
 
 #include <wv/Reflection/Reflection.h>
+#include <wv/Memory/PoolAllocator.h>
 #include <wv/Primitive/Mesh.h>
+#include <wv/Entity/Entity.h>
 
 #include <string>
 #include <vector>
@@ -29,6 +31,7 @@ namespace wv
 		 cModelObject( const UUID& _uuid, const std::string& _name, const std::string& _meshPath );
 		~cModelObject();
 		
+		WV_POOLED_CLASS( cModelObject );
 
 		static cModelObject* parseInstance( sParseData& _data );
 
@@ -44,7 +47,9 @@ namespace wv
 		virtual void updateImpl( double _deltaTime ) override;
 		virtual void drawImpl  ( iDeviceContext* _context, iGraphicsDevice* _device ) override;
 
-		sMeshInstance m_mesh;
+		// transform and mesh live in the scene's entity world, this object only mirrors the hierarchy
+		hEntity m_entity{ 0 };
 		std::string m_meshPath = "";
+		bool m_occluder = false;
 	};
 }
\ No newline at end of file
@@ -1,6 +1,5 @@
 #include "Rigidbody.h"
 
-#include <wv/Engine/Engine.h>
 #include <wv/Device/DeviceContext.h>
 #include <wv/Device/GraphicsDevice.h>
 
@@ -12,9 +11,14 @@
 
 #include <wv/Physics/PhysicsEngine.h>
 #include <wv/Physics/PhysicsBodyDescriptor.h>
+#include <wv/Physics/PhysicsShapeResource.h>
+#include <wv/Physics/PhysicsCooker.h>
 
 #include <wv/Resource/ResourceRegistry.h>
 
+#include <wv/Entity/EntityWorld.h>
+#include <wv/Entity/Components.h>
+
 ///////////////////////////////////////////////////////////////////////////////////////
 
 wv::cRigidbody::cRigidbody( const UUID& _uuid, const std::string& _name, const std::string& _meshPath, iPhysicsBodyDesc* _bodyDesc ) :
@@ -28,7 +32,9 @@ wv::cRigidbody::cRigidbody( const UUID& _uuid, const std::string& _name, const s
 
 wv::cRigidbody::~cRigidbody()
 {
-
+	// never loaded, or unloaded before the shape finished
+	if( m_pPhysicsBodyDesc )
+		delete m_pPhysicsBodyDesc;
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////
@@ -75,15 +81,35 @@ wv::cRigidbody* wv::cRigidbody::parseInstance( sParseData& _data )
 		sphereDesc->radius = data[ "radius" ].number_value();
 		desc = sphereDesc;
 	} break;
+
+	case WV_PHYSICS_MESH:
+	case WV_PHYSICS_CONVECT_HULL:
+		desc = new sPhysicsCookedShapeDesc( shape );
+		break;
 	}
 
 	if( desc )
+	{
 		desc->kind = kind;
 
+		// optional, picked from the kind when left out
+		if( data[ "layer" ].is_string() && !PhysicsLayers::fromName( data[ "layer" ].string_value(), desc->layer ) )
+			Debug::Print( Debug::WV_PRINT_WARN, "Unknown physics layer '%s' on '%s'\n", data[ "layer" ].string_value().c_str(), name.c_str() );
+	}
+
 	std::string meshPath = data[ "path" ].string_value();
 
 	cRigidbody* rb = new cRigidbody( uuid, name, meshPath, desc );
 	rb->m_transform = transform;
+	rb->m_occluder = data[ "occluder" ].bool_value();
+
+	// collision geometry defaults to the render mesh
+	if( shape == WV_PHYSICS_MESH || shape == WV_PHYSICS_CONVECT_HULL )
+	{
+		std::string collisionPath = data[ "collision" ].is_string() ? data[ "collision" ].string_value() : meshPath;
+		rb->m_collisionPath = PhysicsCooker::getCookedPath( collisionPath, shape );
+	}
+
 	return rb;
 }
 
@@ -91,22 +117,74 @@ wv::cRigidbody* wv::cRigidbody::parseInstance( sParseData& _data )
 
 void wv::cRigidbody::onLoadImpl()
 {
-	cEngine* app = wv::cEngine::get();
-
-	if ( m_meshPath == "" )
+	cResourceRegistry* registry = getResourceRegistry();
+	
+	cEntityWorld* world = getWorld();
+	if ( !world || !registry )
 	{
-		Debug::Print( Debug::WV_PRINT_WARN, "No mesh path provided, defaulting to cube\n" );
-		m_meshPath = "res/meshes/cube.dae";
+		Debug::Print( Debug::WV_PRINT_ERROR, "Rigidbody '%s' is not part of a scene\n", m_name.c_str() );
+		return;
 	}
+
+	m_entity = world->createEntity<sTransformComponent, sMeshComponent, sRigidbodyComponent>();
 	
-	m_mesh = app->m_pResourceRegistry->load<cMeshResource>( m_meshPath )->createInstance();
-	m_transform.addChild( &m_mesh.transform );
+	sTransformComponent* transform = world->getComponent<sTransformComponent>( m_entity );
+	transform->position    = m_transform.position;
+	transform->orientation = m_transform.getOrientation();
+	transform->scale       = m_transform.scale;
+	transform->pSource     = &m_transform;
+
+	// a headless scene only simulates, nothing is drawn
+	sMeshComponent* mesh = world->getComponent<sMeshComponent>( m_entity );
+	if ( registry->getGraphicsDevice() )
+	{
+		if ( m_meshPath == "" )
+		{
+			Debug::Print( Debug::WV_PRINT_WARN, "No mesh path provided, defaulting to cube\n" );
+			m_meshPath = "res/meshes/cube.dae";
+		}
+
+		mesh->pResource = registry->load<cMeshResource>( m_meshPath );
+	}
+	mesh->occluder  = m_occluder;
+
+	world->getComponent<sRigidbodyComponent>( m_entity )->pOwner = this;
 
 	//sphereSettings.mLinearVelocity = JPH::Vec3( 1.0f, 10.0f, 2.0f );
 	//sphereSettings.mRestitution = 0.4f;
 #ifdef WV_SUPPORT_PHYSICS
-	m_pPhysicsBodyDesc->transform = m_transform;
-	m_physicsBodyHandle = app->m_pPhysicsEngine->createAndAddBody( m_pPhysicsBodyDesc, true );
+	if( m_collisionPath != "" && m_pPhysicsBodyDesc )
+	{
+		m_pShapeResource = registry->load<cPhysicsShapeResource>( m_collisionPath );
+		static_cast<sPhysicsCookedShapeDesc*>( m_pPhysicsBodyDesc )->pResource = m_pShapeResource;
+
+		// picked up by updateImpl once loaded
+		if( !m_pShapeResource->isComplete() )
+			return;
+	}
+#endif // WV_SUPPORT_PHYSICS
+
+	createBody();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cRigidbody::createBody()
+{
+#ifdef WV_SUPPORT_PHYSICS
+	cJoltPhysicsEngine* physics = getPhysicsEngine();
+	cEntityWorld* world = getWorld();
+
+	if( m_pPhysicsBodyDesc && physics )
+	{
+		m_pPhysicsBodyDesc->transform = m_transform;
+		hPhysicsBody& body = world->getComponent<sRigidbodyComponent>( m_entity )->body;
+		body = physics->createAndAddBody( m_pPhysicsBodyDesc, true );
+
+		// lets Systems::syncRigidbodies go straight from an active body to the entity
+		if( body.isValid() )
+			physics->setBodyUserData( body, m_entity.value() );
+	}
 #endif // WV_SUPPORT_PHYSICS
 	
 	delete m_pPhysicsBodyDesc;
@@ -117,33 +195,53 @@ void wv::cRigidbody::onLoadImpl()
 
 void wv::cRigidbody::onUnloadImpl()
 {
-	wv::cEngine* app = wv::cEngine::get();
+	cResourceRegistry*  registry = getResourceRegistry();
+	cJoltPhysicsEngine* physics  = getPhysicsEngine();
 	
-	m_mesh.destroy();
-	app->m_pPhysicsEngine->destroyPhysicsBody( m_physicsBodyHandle );
+	cEntityWorld* world = getWorld();
+	if ( !world || !world->isAlive( m_entity ) )
+		return;
+
+	sMeshComponent* mesh = world->getComponent<sMeshComponent>( m_entity );
+	if ( mesh->pResource )
+		registry->unload( (iResource*)mesh->pResource );
+
+	if ( m_pShapeResource )
+	{
+		registry->unload( (iResource*)m_pShapeResource );
+		m_pShapeResource = nullptr;
+	}
+
+	// a cooked shape that never finished loading leaves no body behind
+	hPhysicsBody& body = world->getComponent<sRigidbodyComponent>( m_entity )->body;
+	if ( body.isValid() )
+		physics->destroyPhysicsBody( body );
+	world->destroyEntity( m_entity );
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
 void wv::cRigidbody::updateImpl( double _deltaTime )
 {
-#ifdef WV_SUPPORT_PHYSICS
+	// body pose is synced by Systems::syncRigidbodies
 
-	wv::cJoltPhysicsEngine* pPhysics = wv::cEngine::get()->m_pPhysicsEngine;
+	if( !m_pShapeResource || !m_pPhysicsBodyDesc )
+		return;
 
-	if( m_physicsBodyHandle.isValid() && pPhysics->isBodyActive( m_physicsBodyHandle ) )
+	if( m_pShapeResource->isComplete() )
+		createBody();
+	else if( m_pShapeResource->hasFailed() )
 	{
-		Transformf t = pPhysics->getBodyTransform( m_physicsBodyHandle );
-		m_transform.position = t.position;
-		m_transform.rotation = t.rotation;
+		// stays without a body instead of waiting on a shape that will never load
+		Debug::Print( Debug::WV_PRINT_ERROR, "Rigidbody '%s' has no collision shape, it is not simulated\n", m_name.c_str() );
+		delete m_pPhysicsBodyDesc;
+		m_pPhysicsBodyDesc = nullptr;
 	}
-	
-#endif // WV_SUPPORT_PHYSICS
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
 void wv::cRigidbody::drawImpl( wv::iDeviceContext* _context, wv::iGraphicsDevice* _device )
 {
-	m_mesh.draw();
+	// drawn by Systems::drawMeshes
 }
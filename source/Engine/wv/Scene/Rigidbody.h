@@ -3,9 +3,11 @@
 #include <wv/Scene/SceneObject.h>
 
 #include <wv/Primitive/Mesh.h>
+#include <wv/Entity/Entity.h>
 
 #include <wv/Physics/Physics.h>
 #include <wv/Reflection/Reflection.h>
+#include <wv/Memory/PoolAllocator.h>
 
 #include <string>
 #include <vector>
@@ -19,6 +21,7 @@ namespace wv
 
 	struct sMeshNode; 
 	struct cMeshResource; 
+	class cPhysicsShapeResource;
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
@@ -28,6 +31,8 @@ namespace wv
 		 cRigidbody( const UUID& _uuid, const std::string& _name, const std::string& _meshPath, iPhysicsBodyDesc* _bodyDesc );
 		~cRigidbody();
 
+		WV_POOLED_CLASS( cRigidbody );
+
 		static cRigidbody* parseInstance( sParseData& _data );
 
 ///////////////////////////////////////////////////////////////////////////////////////
@@ -41,11 +46,18 @@ namespace wv
 		virtual void updateImpl( double _deltaTime ) override;
 		virtual void drawImpl  ( wv::iDeviceContext* _context, wv::iGraphicsDevice* _device ) override;
 
-		sMeshInstance m_mesh;
+		void createBody();
+
+		// transform, mesh and body live in the scene's entity world
+		hEntity m_entity{ 0 };
 		std::string m_meshPath  = "";
+		bool m_occluder = false;
 
 		iPhysicsBodyDesc* m_pPhysicsBodyDesc = nullptr;
-		hPhysicsBody m_physicsBodyHandle = 0;
+
+		// cooked mesh or hull, the body is created once it has loaded
+		std::string m_collisionPath = "";
+		cPhysicsShapeResource* m_pShapeResource = nullptr;
 
 	};
 
@@ -1,5 +1,9 @@
 #include "SceneObject.h"
 
+#include <wv/Debug/Print.h>
+#include <wv/Resource/ResourceRegistry.h>
+#include <wv/Physics/PhysicsEngine.h>
+
 ///////////////////////////////////////////////////////////////////////////////////////
 
 wv::iSceneObject::iSceneObject( const UUID& _uuid, const std::string& _name ):
@@ -13,6 +17,9 @@ wv::iSceneObject::iSceneObject( const UUID& _uuid, const std::string& _name ):
 
 wv::iSceneObject::~iSceneObject()
 {
+	// unlink all at once so each child does not search this transform's child list
+	m_transform.removeAllChildren();
+
 	for( size_t i = 0; i < m_children.size(); i++ )
 	{
 		delete m_children[ i ];
@@ -41,6 +48,50 @@ void wv::iSceneObject::addChild( iSceneObject* _node, bool _triggerLoadAndCreate
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
+void wv::iSceneObject::addChildren( const std::vector<iSceneObject*>& _nodes, bool _triggerLoadAndCreate )
+{
+	m_children.reserve( m_children.size() + _nodes.size() );
+
+	for ( iSceneObject* node : _nodes )
+	{
+		// m_parent is enough to tell if it is already a child, no need to search m_children
+		if ( !node || node->m_parent == this )
+			continue;
+
+		m_children.push_back( node );
+
+		node->m_parent = this;
+		m_transform.addChild( &node->m_transform );
+	}
+
+	if ( !_triggerLoadAndCreate )
+		return;
+
+	cResourceRegistry*  pResourceRegistry = getResourceRegistry();
+	cJoltPhysicsEngine* pPhysicsEngine    = getPhysicsEngine();
+	if ( !pResourceRegistry || !pPhysicsEngine )
+	{
+		Debug::Print( Debug::WV_PRINT_ERROR, "Cannot load children of '%s', it is not part of a loaded scene\n", m_name.c_str() );
+		return;
+	}
+	
+	pResourceRegistry->beginBatch();
+	pPhysicsEngine->beginBatch();
+
+	for ( iSceneObject* node : _nodes )
+		if ( node && node->m_parent == this )
+			node->onCreate();
+
+	for ( iSceneObject* node : _nodes )
+		if ( node && node->m_parent == this )
+			node->onLoad();
+
+	pPhysicsEngine->endBatch();
+	pResourceRegistry->endBatch();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
 void wv::iSceneObject::removeChild( iSceneObject* _node )
 {
 	if ( !_node )
@@ -53,6 +104,7 @@ void wv::iSceneObject::removeChild( iSceneObject* _node )
 
 		m_children.erase( m_children.begin() + i );
 		_node->m_parent = nullptr;
+		m_transform.removeChild( &_node->m_transform );
 		return;
 	}
 }
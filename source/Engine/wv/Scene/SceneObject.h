@@ -16,6 +16,10 @@ namespace wv
 
 	class iDeviceContext;
 	class iGraphicsDevice;
+	class cEntityWorld;
+	class cResourceRegistry;
+	class cJoltPhysicsEngine;
+	struct sPhysicsEvent;
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
@@ -27,6 +31,13 @@ namespace wv
 		virtual ~iSceneObject() = 0;
 
 		void addChild   ( iSceneObject* _node, bool _triggerLoadAndCreate = false );
+		
+		/// <summary>
+		/// Adds many children in one go. With _triggerLoadAndCreate only the added subtrees 
+		/// are created and loaded, their resource loads share one registry lock and their
+		/// physics bodies are added to the simulation together
+		/// </summary>
+		void addChildren( const std::vector<iSceneObject*>& _nodes, bool _triggerLoadAndCreate = false );
 		void removeChild( iSceneObject* _node );
 		void moveChild  ( iSceneObject* _node, iSceneObject* _newParent );
 
@@ -42,6 +53,24 @@ namespace wv
 		std::vector<iSceneObject*> getChildren( void ) { return m_children; };
 		iSceneObject*              getParent  ( void ) { return m_parent; }
 
+		/// <summary>
+		/// Entity world of the scene this object is in, nullptr if it is not attached to a scene
+		/// </summary>
+		virtual cEntityWorld* getWorld( void ) { return m_parent ? m_parent->getWorld() : nullptr; }
+
+		/// <summary>
+		/// Registry and physics engine of the scene this object is in. Use these over the 
+		/// engine's, a headless server runs several scenes each with its own physics
+		/// </summary>
+		virtual cResourceRegistry*  getResourceRegistry( void ) { return m_parent ? m_parent->getResourceRegistry() : nullptr; }
+		virtual cJoltPhysicsEngine* getPhysicsEngine   ( void ) { return m_parent ? m_parent->getPhysicsEngine()    : nullptr; }
+
+		/// <summary>
+		/// Called on the main thread for every physics event involving a body this object 
+		/// owns. body1 is always the owned body
+		/// </summary>
+		virtual void onPhysicsEvent( const sPhysicsEvent& _event ) { }
+
 		void onLoad()
 		{
 			if( !m_loaded )
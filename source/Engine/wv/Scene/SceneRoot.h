@@ -2,6 +2,9 @@
 
 #include "SceneObject.h"
 
+#include <wv/Entity/EntityWorld.h>
+#include <wv/Physics/PhysicsLayers.h>
+
 namespace wv
 {
 	class cSceneRoot : public iSceneObject
@@ -9,13 +12,31 @@ namespace wv
 	public:
 		cSceneRoot( const std::string& _name, const std::string& _sourcePath = "" ) :
 			iSceneObject( 0, _name ),
-			m_sourcePath{ _sourcePath }
+			m_sourcePath{ _sourcePath },
+			m_pWorld{ new cEntityWorld() }
 		{ }
 
-		~cSceneRoot() { }
+		~cSceneRoot() { delete m_pWorld; }
 
 		std::string getSourcePath() { return m_sourcePath; }
 
+		cEntityWorld* getWorld( void ) override { return m_pWorld; }
+
+		/// <summary>
+		/// Collision matrix applied to the physics engine when the scene is loaded
+		/// </summary>
+		const sPhysicsLayerConfig& getPhysicsLayers() { return m_physicsLayers; }
+		void setPhysicsLayers( const sPhysicsLayerConfig& _layers ) { m_physicsLayers = _layers; }
+
+		/// <summary>
+		/// Has to be set before the scene is loaded. The registry can be shared between scenes
+		/// </summary>
+		void setResourceRegistry( cResourceRegistry*  _pResourceRegistry ) { m_pResourceRegistry = _pResourceRegistry; }
+		void setPhysicsEngine   ( cJoltPhysicsEngine* _pPhysicsEngine )    { m_pPhysicsEngine    = _pPhysicsEngine; }
+
+		cResourceRegistry*  getResourceRegistry( void ) override { return m_pResourceRegistry; }
+		cJoltPhysicsEngine* getPhysicsEngine   ( void ) override { return m_pPhysicsEngine; }
+
 	protected:
 
 		void onLoadImpl   () override { };
@@ -27,5 +48,10 @@ namespace wv
 		void drawImpl  ( iDeviceContext* _context, iGraphicsDevice* _device ) override { };
 
 		std::string m_sourcePath = "";
+		cEntityWorld* m_pWorld = nullptr;
+		sPhysicsLayerConfig m_physicsLayers{};
+
+		cResourceRegistry*  m_pResourceRegistry = nullptr;
+		cJoltPhysicsEngine* m_pPhysicsEngine    = nullptr;
 	};
 }
\ No newline at end of file
@@ -1,6 +1,5 @@
 #include "Skybox.h"
 
-#include <wv/Engine/Engine.h>
 #include <wv/Device/DeviceContext.h>
 #include <wv/Device/GraphicsDevice.h>
 
@@ -54,15 +53,23 @@ wv::cSkyboxObject* wv::cSkyboxObject::parseInstance( sParseData& _data )
 
 void wv::cSkyboxObject::onLoadImpl()
 {
-	wv::cEngine* app = wv::cEngine::get();
-	
-	m_mesh = app->m_pResourceRegistry->load<cMeshResource>( "res/meshes/skysphere.dae" )->createInstance();
+	cResourceRegistry* registry = getResourceRegistry();
+
+	// nothing to draw without a graphics device
+	if ( !registry || !registry->getGraphicsDevice() )
+		return;
+
+	m_mesh = registry->load<cMeshResource>( "res/meshes/skysphere.dae" )->createInstance();
 	m_transform.addChild( &m_mesh.transform );
 }
 
 void wv::cSkyboxObject::onUnloadImpl()
 {
+	if ( !m_mesh.pResource )
+		return;
+
 	m_mesh.destroy();
+	m_mesh.pResource = nullptr;
 }
 
 void wv::cSkyboxObject::onCreateImpl()
@@ -86,6 +93,9 @@ void wv::cSkyboxObject::updateImpl( double _deltaTime )
 
 void wv::cSkyboxObject::drawImpl( iDeviceContext* _context, iGraphicsDevice* _device )
 {
+	if ( !m_mesh.pResource )
+		return;
+
 	/// TODO: remove raw gl calls
 #ifdef WV_SUPPORT_OPENGL
 	glDepthMask( GL_FALSE );
@@ -6,6 +6,7 @@
 #include <vector>
 
 #include <wv/Reflection/Reflection.h>
+#include <wv/Memory/PoolAllocator.h>
 #include <wv/Primitive/Mesh.h>
 
 ///////////////////////////////////////////////////////////////////////////////////////
@@ -28,6 +29,8 @@ namespace wv
 		 cSkyboxObject( const UUID& _uuid, const std::string& _name );
 		~cSkyboxObject();
 
+		WV_POOLED_CLASS( cSkyboxObject );
+
 ///////////////////////////////////////////////////////////////////////////////////////
 
 		static cSkyboxObject* parseInstance( sParseData& _data );
@@ -44,7 +47,7 @@ namespace wv
 		virtual void updateImpl( double _deltaTime ) override;
 		virtual void drawImpl  ( iDeviceContext* _context, iGraphicsDevice* _device ) override;
 
-		sMeshInstance m_mesh;
+		sMeshInstance m_mesh{};
 
 	};
 }
\ No newline at end of file
@@ -0,0 +1,161 @@
+#include "TransformHierarchy.h"
+
+#include <wv/Thread/TaskScheduler.h>
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+wv::cTransformHierarchy::cTransformHierarchy( cTaskScheduler* _pTaskScheduler ) :
+	m_pTaskScheduler{ _pTaskScheduler }
+{
+
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cTransformHierarchy::update( Transformf* _pRoot )
+{
+	m_numUpdated = 0;
+
+	if ( _pRoot == nullptr )
+		return;
+
+	if ( _pRoot != m_pRoot || _pRoot->getHierarchyRevision() != m_revision )
+		rebuild( _pRoot );
+
+	// levels do not matter here, every local matrix only depends on its own transform
+	forEachChunk( 0, (uint32_t)m_transforms.size(), &cTransformHierarchy::gatherRange );
+
+	for ( size_t level = 0; level + 1 < m_levelOffsets.size(); level++ )
+		forEachChunk( m_levelOffsets[ level ], m_levelOffsets[ level + 1 ], &cTransformHierarchy::propagateRange );
+
+	forEachChunk( 0, (uint32_t)m_transforms.size(), &cTransformHierarchy::scatterRange );
+
+	m_forceAll = false;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cTransformHierarchy::rebuild( Transformf* _pRoot )
+{
+	m_pRoot    = _pRoot;
+	m_revision = _pRoot->getHierarchyRevision();
+	m_forceAll = true; // transforms may have moved to a different parent
+
+	m_transforms.clear();
+	m_parents.clear();
+	m_levelOffsets.clear();
+
+	m_transforms.push_back( _pRoot );
+	m_parents.push_back( -1 );
+
+	uint32_t begin = 0;
+	uint32_t end   = 1;
+	while ( begin < end )
+	{
+		m_levelOffsets.push_back( begin );
+
+		for ( uint32_t i = begin; i < end; i++ )
+		{
+			for ( auto& child : m_transforms[ i ]->getChildren() )
+			{
+				m_transforms.push_back( child );
+				m_parents.push_back( (int32_t)i );
+			}
+		}
+
+		begin = end;
+		end   = (uint32_t)m_transforms.size();
+	}
+	m_levelOffsets.push_back( end );
+
+	m_localMatrices.resize( m_transforms.size() );
+	m_worldMatrices.resize( m_transforms.size() );
+	m_changed.assign( m_transforms.size(), 0 );
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cTransformHierarchy::forEachChunk( uint32_t _begin, uint32_t _end, tRangeFunc _func )
+{
+	if ( !m_pTaskScheduler )
+	{
+		( this->*_func )( _begin, _end );
+		return;
+	}
+
+	m_rangeBegin = _begin;
+	m_rangeEnd   = _end;
+	m_rangeFunc  = _func;
+
+	uint32_t numChunks = ( _end - _begin + CHUNK_SIZE - 1 ) / CHUNK_SIZE;
+	m_pTaskScheduler->parallelFor( numChunks, rangeChunkJob, this );
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cTransformHierarchy::gatherRange( uint32_t _begin, uint32_t _end )
+{
+	for ( uint32_t i = _begin; i < _end; i++ )
+	{
+		Transformf* transform = m_transforms[ i ];
+		
+		bool changed = transform->updateLocalMatrix() || m_forceAll;
+		if ( changed )
+			m_localMatrices[ i ] = transform->getLocalMatrix();
+
+		m_changed[ i ] = changed;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cTransformHierarchy::propagateRange( uint32_t _begin, uint32_t _end )
+{
+	for ( uint32_t i = _begin; i < _end; i++ )
+	{
+		int32_t parent = m_parents[ i ];
+
+		if ( parent >= 0 && m_changed[ parent ] )
+			m_changed[ i ] = 1;
+
+		if ( !m_changed[ i ] )
+			continue;
+
+		if ( parent >= 0 )
+			m_worldMatrices[ i ] = Matrix::multiply( m_localMatrices[ i ], m_worldMatrices[ parent ] );
+		else
+			m_worldMatrices[ i ] = m_localMatrices[ i ];
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cTransformHierarchy::scatterRange( uint32_t _begin, uint32_t _end )
+{
+	uint32_t numUpdated = 0;
+
+	for ( uint32_t i = _begin; i < _end; i++ )
+	{
+		if ( !m_changed[ i ] )
+			continue;
+
+		m_transforms[ i ]->m_matrix = m_worldMatrices[ i ];
+		numUpdated++;
+	}
+
+	m_numUpdated += numUpdated;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cTransformHierarchy::rangeChunkJob( void* _pUserData, uint32_t _chunk )
+{
+	cTransformHierarchy* hierarchy = (cTransformHierarchy*)_pUserData;
+
+	uint32_t begin = hierarchy->m_rangeBegin + _chunk * CHUNK_SIZE;
+	uint32_t end   = begin + CHUNK_SIZE;
+	if ( end > hierarchy->m_rangeEnd )
+		end = hierarchy->m_rangeEnd;
+
+	( hierarchy->*hierarchy->m_rangeFunc )( begin, end );
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <wv/Math/Transform.h>
+
+#include <stdint.h>
+
+#include <vector>
+#include <atomic>
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+namespace wv
+{
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	class cTaskScheduler;
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	/// <summary>
+	/// Flattened view of a transform tree. Transforms are stored breadth first so every
+	/// depth level is one contiguous range. Parent indices, local and world matrices and
+	/// change flags live in arrays in that order, so propagating the world matrices never
+	/// touches the transforms themselves. 
+	/// 
+	/// An update reads the local matrices of every transform in parallel, propagates the 
+	/// world matrices level by level, each level in parallel once the level above it is
+	/// done, then writes the world matrices that changed back to their transforms.
+	/// Only transforms whose local values or parent changed are recomputed.
+	/// 
+	/// The flat arrays are rebuilt whenever the root or the root's hierarchy revision changes
+	/// </summary>
+	class cTransformHierarchy
+	{
+	public:
+		cTransformHierarchy( cTaskScheduler* _pTaskScheduler );
+
+		void update( Transformf* _pRoot );
+
+		/// <summary>
+		/// Forces every transform to be recomputed on the next update
+		/// </summary>
+		void invalidate() { m_pRoot = nullptr; }
+
+		uint32_t getNumNodes()   { return (uint32_t)m_transforms.size(); }
+		uint32_t getNumLevels()  { return m_levelOffsets.empty() ? 0 : (uint32_t)m_levelOffsets.size() - 1; }
+		uint32_t getNumUpdated() { return m_numUpdated.load(); }
+
+		/// <summary>
+		/// World matrix of the node at _index in breadth first order, as of the last update
+		/// </summary>
+		const cMatrix4x4f& getWorldMatrix( uint32_t _index ) { return m_worldMatrices[ _index ]; }
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	private:
+
+		typedef void ( cTransformHierarchy::*tRangeFunc )( uint32_t _begin, uint32_t _end );
+
+		void rebuild( Transformf* _pRoot );
+		void forEachChunk( uint32_t _begin, uint32_t _end, tRangeFunc _func );
+
+		void gatherRange   ( uint32_t _begin, uint32_t _end );
+		void propagateRange( uint32_t _begin, uint32_t _end );
+		void scatterRange  ( uint32_t _begin, uint32_t _end );
+
+		static void rangeChunkJob( void* _pUserData, uint32_t _chunk );
+
+		static constexpr uint32_t CHUNK_SIZE = 256;
+
+		cTaskScheduler* m_pTaskScheduler = nullptr;
+
+		Transformf* m_pRoot     = nullptr;
+		uint32_t    m_revision  = 0;
+		bool        m_forceAll  = false;
+
+		// only read when gathering and written when scattering
+		std::vector<Transformf*> m_transforms;
+
+		std::vector<int32_t>     m_parents;
+		std::vector<cMatrix4x4f> m_localMatrices;
+		std::vector<cMatrix4x4f> m_worldMatrices;
+		std::vector<uint8_t>     m_changed;
+		std::vector<uint32_t>    m_levelOffsets;
+
+		// range and function of the parallel pass in progress
+		uint32_t   m_rangeBegin = 0;
+		uint32_t   m_rangeEnd   = 0;
+		tRangeFunc m_rangeFunc  = nullptr;
+
+		std::atomic<uint32_t> m_numUpdated{ 0 };
+	};
+
+}
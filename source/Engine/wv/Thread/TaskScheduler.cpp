@@ -0,0 +1,402 @@
+#include "TaskScheduler.h"
+
+#include <wv/Memory/PoolAllocator.h>
+
+#include <new>
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+struct wv::cTaskScheduler::sTask
+{
+	TaskFunction  function;
+	void*         pUserData = nullptr;
+	eTaskPriority priority  = WV_TASK_PRIORITY_NORMAL;
+
+	// dependencies left plus one until submitted
+	std::atomic<int>  numPending{ 1 };
+	std::atomic<int>  refCount  { 1 };
+	std::atomic<bool> done      { false };
+
+	std::mutex          mutex;
+	std::vector<sTask*> dependents;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+struct sParallelFor
+{
+	wv::cTaskScheduler::JobFunction function;
+	void*    pUserData = nullptr;
+	uint32_t count     = 0;
+
+	std::atomic<uint32_t> next{ 0 };
+	std::atomic<uint32_t> numHelpers{ 0 };
+};
+
+static void runParallelFor( sParallelFor* _pFor )
+{
+	uint32_t index = _pFor->next.fetch_add( 1 );
+	while ( index < _pFor->count )
+	{
+		_pFor->function( _pFor->pUserData, index );
+		index = _pFor->next.fetch_add( 1 );
+	}
+}
+
+static void parallelForHelperTask( void* _pUserData )
+{
+	sParallelFor* pFor = (sParallelFor*)_pUserData;
+	runParallelFor( pFor );
+
+	// last access, the caller may return as soon as this reaches zero
+	pFor->numHelpers.fetch_sub( 1 );
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+static thread_local wv::cTaskScheduler* t_pScheduler  = nullptr;
+static thread_local int                 t_workerIndex = -1;
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+wv::cTaskScheduler::cTaskScheduler( int _numWorkers )
+{
+	for ( int i = 0; i < _numWorkers; i++ )
+		m_workers.push_back( new sWorker() );
+
+	// every worker has to exist before any of them starts stealing
+	for ( int i = 0; i < _numWorkers; i++ )
+		m_workers[ i ]->thread = std::thread( &cTaskScheduler::workerLoop, this, i );
+
+	m_lastSampleTime = std::chrono::steady_clock::now();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+wv::cTaskScheduler::~cTaskScheduler()
+{
+	{
+		std::unique_lock<std::mutex> lock( m_sleepMutex );
+		m_alive = false;
+	}
+	m_wakeCondition.notify_all();
+
+	for ( auto& worker : m_workers )
+		worker->thread.join();
+
+	// whatever was left is run here so no task is leaked
+	while ( runPendingTask() ) { }
+
+	for ( auto& worker : m_workers )
+		delete worker;
+	m_workers.clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cTaskScheduler::parallelFor( uint32_t _count, JobFunction _function, void* _pUserData, eTaskPriority _priority )
+{
+	if ( _count == 0 )
+		return;
+
+	if ( m_workers.empty() || _count == 1 )
+	{
+		for ( uint32_t i = 0; i < _count; i++ )
+			_function( _pUserData, i );
+		return;
+	}
+
+	sParallelFor pfor;
+	pfor.function  = _function;
+	pfor.pUserData = _pUserData;
+	pfor.count     = _count;
+
+	uint32_t numHelpers = _count - 1;
+	if ( numHelpers > (uint32_t)m_workers.size() )
+		numHelpers = (uint32_t)m_workers.size();
+
+	pfor.numHelpers = numHelpers;
+	for ( uint32_t i = 0; i < numHelpers; i++ )
+		submit( parallelForHelperTask, &pfor, _priority );
+
+	runParallelFor( &pfor );
+
+	// helpers that have not started yet still read pfor, so they have to run before returning
+	while ( pfor.numHelpers.load() > 0 )
+	{
+		if ( !runPendingTask( _priority ) )
+			std::this_thread::yield();
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cTaskScheduler::submit( TaskFunction _function, void* _pUserData, eTaskPriority _priority )
+{
+	sTask* task = createTask( _function, _pUserData, _priority );
+	submit( task );
+	release( task );
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+wv::cTaskScheduler::sTask* wv::cTaskScheduler::createTask( TaskFunction _function, void* _pUserData, eTaskPriority _priority )
+{
+	sTask* task = new( Pool::get<sTask>().allocate() ) sTask();
+	task->function  = _function;
+	task->pUserData = _pUserData;
+	task->priority  = _priority;
+
+	// one reference for the caller and one released once it has run
+	task->refCount = 2;
+
+	return task;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cTaskScheduler::addDependency( sTask* _pTask, sTask* _pDependency )
+{
+	std::unique_lock<std::mutex> lock( _pDependency->mutex );
+	if ( _pDependency->done )
+		return;
+
+	_pTask->numPending++;
+	_pTask->refCount++;
+	_pDependency->dependents.push_back( _pTask );
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cTaskScheduler::submit( sTask* _pTask )
+{
+	if ( _pTask->numPending.fetch_sub( 1 ) == 1 )
+		enqueue( _pTask );
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+bool wv::cTaskScheduler::isDone( sTask* _pTask )
+{
+	return _pTask->done.load( std::memory_order_acquire );
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cTaskScheduler::release( sTask* _pTask )
+{
+	if ( _pTask->refCount.fetch_sub( 1 ) != 1 )
+		return;
+
+	_pTask->~sTask();
+	Pool::get<sTask>().free( _pTask );
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cTaskScheduler::wait( sTask* _pTask )
+{
+	while ( !isDone( _pTask ) )
+	{
+		if ( !runPendingTask( _pTask->priority ) )
+			std::this_thread::yield();
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+bool wv::cTaskScheduler::runPendingTask( eTaskPriority _lowest )
+{
+	if ( m_numQueued.load() == 0 )
+		return false;
+
+	const int self = getWorkerIndex();
+
+	bool stolen = false;
+	sTask* task = dequeue( self, _lowest, stolen );
+	if ( !task )
+		return false;
+
+	execute( task );
+
+	if ( self >= 0 )
+	{
+		m_workers[ self ]->numTasks++;
+		if ( stolen )
+			m_workers[ self ]->numStolen++;
+	}
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+std::vector<wv::sWorkerStats> wv::cTaskScheduler::sampleWorkerStats()
+{
+	const auto now = std::chrono::steady_clock::now();
+	const double elapsed = std::chrono::duration<double>( now - m_lastSampleTime ).count();
+	m_lastSampleTime = now;
+
+	std::vector<sWorkerStats> stats( m_workers.size() );
+	for ( size_t i = 0; i < m_workers.size(); i++ )
+	{
+		sWorker* worker = m_workers[ i ];
+
+		sWorkerStats total;
+		total.numTasks  = worker->numTasks.load( std::memory_order_relaxed );
+		total.numStolen = worker->numStolen.load( std::memory_order_relaxed );
+		total.busyTime  = (double)worker->busyNanoseconds.load( std::memory_order_relaxed ) / 1000000000.0;
+
+		stats[ i ].numTasks  = total.numTasks  - worker->lastSample.numTasks;
+		stats[ i ].numStolen = total.numStolen - worker->lastSample.numStolen;
+		stats[ i ].busyTime  = total.busyTime  - worker->lastSample.busyTime;
+
+		if ( elapsed > 0.0 )
+			stats[ i ].utilization = stats[ i ].busyTime / elapsed;
+		if ( stats[ i ].utilization > 1.0 )
+			stats[ i ].utilization = 1.0;
+
+		worker->lastSample = total;
+	}
+
+	return stats;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cTaskScheduler::workerLoop( int _index )
+{
+	t_pScheduler  = this;
+	t_workerIndex = _index;
+
+	sWorker* worker = m_workers[ _index ];
+
+	while ( true )
+	{
+		bool stolen = false;
+		sTask* task = dequeue( _index, WV_TASK_PRIORITY_LOW, stolen );
+
+		if ( task )
+		{
+			const auto start = std::chrono::steady_clock::now();
+			execute( task );
+			const auto end = std::chrono::steady_clock::now();
+
+			worker->busyNanoseconds += (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>( end - start ).count();
+			worker->numTasks++;
+			if ( stolen )
+				worker->numStolen++;
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock( m_sleepMutex );
+
+		// enqueue only notifies when it sees a sleeper, so this has to be counted before checking
+		m_numSleeping++;
+		m_wakeCondition.wait( lock, [ this ] { return !m_alive || m_numQueued.load() > 0; } );
+		m_numSleeping--;
+
+		if ( !m_alive )
+			return;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+int wv::cTaskScheduler::getWorkerIndex()
+{
+	return t_pScheduler == this ? t_workerIndex : -1;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cTaskScheduler::enqueue( sTask* _pTask )
+{
+	if ( m_workers.empty() )
+	{
+		execute( _pTask );
+		return;
+	}
+
+	// workers keep what they spawn, everyone else spreads tasks around
+	int index = getWorkerIndex();
+	if ( index < 0 )
+		index = (int)( m_nextQueue.fetch_add( 1 ) % (uint32_t)m_workers.size() );
+
+	sWorker* worker = m_workers[ index ];
+	{
+		std::unique_lock<std::mutex> lock( worker->mutex );
+		worker->queues[ _pTask->priority ].push_back( _pTask );
+		m_numQueued++;
+	}
+
+	if ( m_numSleeping.load() > 0 )
+	{
+		std::unique_lock<std::mutex> lock( m_sleepMutex );
+		m_wakeCondition.notify_one();
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+wv::cTaskScheduler::sTask* wv::cTaskScheduler::dequeue( int _self, eTaskPriority _lowest, bool& _stolen )
+{
+	const int numWorkers = (int)m_workers.size();
+	const int first = _self >= 0 ? _self : (int)( m_nextQueue.load() % (uint32_t)numWorkers );
+
+	for ( int p = 0; p <= (int)_lowest; p++ )
+	{
+		for ( int i = 0; i < numWorkers; i++ )
+		{
+			const int index = ( first + i ) % numWorkers;
+			sWorker* worker = m_workers[ index ];
+			std::deque<sTask*>& queue = worker->queues[ p ];
+
+			std::unique_lock<std::mutex> lock( worker->mutex );
+			if ( queue.empty() )
+				continue;
+
+			sTask* task = nullptr;
+			if ( index == _self )
+			{
+				// newest first, it is the most likely to still be in cache
+				task = queue.back();
+				queue.pop_back();
+			}
+			else
+			{
+				task = queue.front();
+				queue.pop_front();
+			}
+
+			m_numQueued--;
+			_stolen = index != _self && _self >= 0;
+			return task;
+		}
+	}
+
+	return nullptr;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+void wv::cTaskScheduler::execute( sTask* _pTask )
+{
+	_pTask->function( _pTask->pUserData );
+
+	std::vector<sTask*> dependents;
+	{
+		std::unique_lock<std::mutex> lock( _pTask->mutex );
+		_pTask->done.store( true, std::memory_order_release );
+		dependents.swap( _pTask->dependents );
+	}
+
+	for ( sTask* dependent : dependents )
+	{
+		if ( dependent->numPending.fetch_sub( 1 ) == 1 )
+			enqueue( dependent );
+		release( dependent );
+	}
+
+	release( _pTask );
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <wv/Memory/Function.h>
+
+#include <stdint.h>
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+namespace wv
+{
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	enum eTaskPriority
+	{
+		WV_TASK_PRIORITY_HIGH,
+		WV_TASK_PRIORITY_NORMAL,
+		WV_TASK_PRIORITY_LOW,
+
+		WV_TASK_PRIORITY_COUNT
+	};
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	struct sWorkerStats
+	{
+		uint64_t numTasks    = 0;
+		uint64_t numStolen   = 0;
+		double   busyTime    = 0.0; // seconds
+		double   utilization = 0.0; // busy time over the sampled interval, [0, 1]
+	};
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	/// <summary>
+	/// Persistent worker threads, each with its own task queues. Workers run their own
+	/// queue newest first and steal the oldest tasks from the others when it runs dry.
+	/// Every high priority task anywhere is taken before any normal one, and so on.
+	/// Without workers tasks run on the thread that submits them
+	/// </summary>
+	class cTaskScheduler
+	{
+	public:
+		typedef wv::Function<void, void*, uint32_t> JobFunction;
+		typedef wv::Function<void, void*>           TaskFunction;
+
+		struct sTask;
+
+		cTaskScheduler( int _numWorkers );
+		~cTaskScheduler();
+
+		int getNumWorkers() { return (int)m_workers.size(); }
+
+		/// <summary>
+		/// Index of the calling thread among the workers, -1 for any other thread
+		/// </summary>
+		int getWorkerIndex();
+
+		/// <summary>
+		/// Calls _function( _pUserData, i ) for every i in [0, _count).
+		/// The calling thread participates and blocks until every index has been processed
+		/// </summary>
+		void parallelFor( uint32_t _count, JobFunction _function, void* _pUserData, eTaskPriority _priority = WV_TASK_PRIORITY_HIGH );
+
+		/// <summary>
+		/// Fire and forget, nothing can wait on or depend on the task
+		/// </summary>
+		void submit( TaskFunction _function, void* _pUserData, eTaskPriority _priority = WV_TASK_PRIORITY_NORMAL );
+
+		/// <summary>
+		/// The task does not run until it is submitted and all of its dependencies are done.
+		/// The returned task has to be released once it is no longer waited on
+		/// </summary>
+		sTask* createTask( TaskFunction _function, void* _pUserData, eTaskPriority _priority = WV_TASK_PRIORITY_NORMAL );
+
+		/// <summary>
+		/// Must be called before _pTask is submitted
+		/// </summary>
+		void addDependency( sTask* _pTask, sTask* _pDependency );
+		void submit       ( sTask* _pTask );
+		bool isDone       ( sTask* _pTask );
+		void release      ( sTask* _pTask );
+
+		/// <summary>
+		/// Runs other tasks on the calling thread until _pTask is done
+		/// </summary>
+		void wait( sTask* _pTask );
+
+		/// <summary>
+		/// Runs one queued task of at least _lowest priority on the calling thread.
+		/// Returns false if there was none
+		/// </summary>
+		bool runPendingTask( eTaskPriority _lowest = WV_TASK_PRIORITY_LOW );
+
+		/// <summary>
+		/// Per worker counters since the previous call
+		/// </summary>
+		std::vector<sWorkerStats> sampleWorkerStats();
+
+///////////////////////////////////////////////////////////////////////////////////////
+
+	private:
+
+		struct sWorker
+		{
+			std::thread thread;
+			std::mutex  mutex;
+			std::deque<sTask*> queues[ WV_TASK_PRIORITY_COUNT ];
+
+			std::atomic<uint64_t> busyNanoseconds{ 0 };
+			std::atomic<uint64_t> numTasks { 0 };
+			std::atomic<uint64_t> numStolen{ 0 };
+
+			sWorkerStats lastSample;
+		};
+
+		void workerLoop( int _index );
+
+		void   enqueue ( sTask* _pTask );
+		sTask* dequeue ( int _self, eTaskPriority _lowest, bool& _stolen );
+		void   execute ( sTask* _pTask );
+
+		std::vector<sWorker*> m_workers;
+
+		std::mutex              m_sleepMutex;
+		std::condition_variable m_wakeCondition;
+
+		std::atomic<uint32_t> m_numQueued  { 0 };
+		std::atomic<uint32_t> m_numSleeping{ 0 };
+		std::atomic<uint32_t> m_nextQueue  { 0 };
+		bool m_alive = true;
+
+		std::chrono::steady_clock::time_point m_lastSampleTime;
+	};
+
+}